@@ -0,0 +1,110 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_ALLOCATOR_H
+#define DSTR_ALLOCATOR_H
+
+#include <stddef.h>
+#include "portable_attributes.h"
+
+// 分配器接口
+/**
+ * 「动态字符串」使用的内存分配器虚表。
+ *
+ * 所有回调的第一个参数均为 ctx；reallocate 与 deallocate 会收到该块当前的大小，
+ * 以便按大小管理内存的实现（如 arena、分级内存池）无需自行记录。
+ * reallocate 失败时返回 NULL，且原内存块保持有效。
+ *
+ * 分配器对象以指针形式被字符串引用，调用者需保证其生命周期不短于使用它的字符串。
+ */
+typedef struct DStrAllocator {
+    void *(*allocate)(void *ctx, size_t size);
+    void *(*reallocate)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*deallocate)(void *ctx, void *ptr, size_t size);
+    void *ctx;
+} DStrAllocator;
+
+// 基于 malloc/realloc/free 的分配器（默认）
+extern const DStrAllocator DSTR_ALLOCATOR_LIBC;
+
+// Arena 分配器
+/**
+ * 按块顺序分配的 arena：分配仅移动游标，单独释放只在释放最后一次分配时回收空间，
+ * 其余内存在 dstr_arena_reset/dstr_arena_rewind/dstr_arena_destroy 时统一回收。
+ * 最后一次分配的内存块在当前块内有余量时可原地扩容。
+ *
+ * 从 arena 分配的字符串无需逐个 dstr_destroy，但在 arena 重置或回退到其创建之前的位置后不可再使用。
+ * arena 本身不是线程安全的。
+ */
+typedef struct DStrArena DStrArena;
+
+// arena 的位置标记，用于回退
+typedef struct DStrArenaMark {
+    void *block;
+    size_t used;
+} DStrArenaMark;
+
+/**
+ * 创建 arena，block_size 为每个内存块的默认大小，0 表示使用默认值（64 KiB）。
+ */
+DStrArena *dstr_arena_create(
+    size_t block_size
+) NODISCARD;
+
+void dstr_arena_destroy(
+    DStrArena *arena
+) NONNULL(1);
+
+/**
+ * 获取 arena 对应的分配器，其生命周期与 arena 相同。
+ */
+const DStrAllocator *dstr_arena_allocator(
+    DStrArena *arena
+) PURE NONNULL(1);
+
+/**
+ * 释放 arena 中的全部分配，保留首个内存块供后续复用。
+ */
+void dstr_arena_reset(
+    DStrArena *arena
+) NONNULL(1);
+
+DStrArenaMark dstr_arena_mark(
+    const DStrArena *arena
+) PURE NONNULL(1);
+
+/**
+ * 回退到 mark 记录的位置，释放此后的全部分配。
+ */
+void dstr_arena_rewind(
+    DStrArena *arena,
+    DStrArenaMark mark
+) NONNULL(1);
+
+/**
+ * 已分配出去的字节数（含对齐填充）。
+ */
+size_t dstr_arena_used(
+    const DStrArena *arena
+) PURE NONNULL(1);
+
+// 分级内存池分配器
+/**
+ * 面向大量短字符串的分配器：不超过 256 字节的请求按 16 字节分级复用空闲块，
+ * 每个线程持有本地缓存，溢出或线程退出时归还全局仓库，其他线程可从仓库取回，
+ * 因此允许在一个线程创建、在另一个线程销毁。更大的请求直接转交 malloc。
+ * 主线程结束时不保证运行线程退出回调，其本地缓存只有调用 dstr_pool_trim 才会归还。
+ * 在没有线程支持的平台上（或以 DSTR_NO_THREADS 编译时）不使用本地缓存，空闲块直接存取于仓库。
+ *
+ * 可通过 dstr_set_default_allocator(&DSTR_ALLOCATOR_POOL) 设为默认分配器，
+ * 稳定状态下反复创建、销毁字符串不再调用 malloc。
+ */
+extern const DStrAllocator DSTR_ALLOCATOR_POOL;
+
+/**
+ * 将调用线程的本地缓存与全局仓库中的空闲块全部归还给系统。
+ */
+void dstr_pool_trim(void);
+
+#endif // DSTR_ALLOCATOR_H
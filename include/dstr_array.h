@@ -0,0 +1,124 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_ARRAY_H
+#define DSTR_ARRAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "dynamic_string.h"
+#include "portable_attributes.h"
+
+/**
+ * @file dstr_array.h
+ * @brief 面向海量短字符串的紧凑字符串表
+ *
+ * 全部字符按追加顺序连续存放在一块可增长的缓冲中（每个字符串之后附带 '\0'），
+ * 另以一个「偏移 + 长度」数组按下标索引，每个字符串只额外占用两个 size_t，
+ * 没有独立的头部与分配开销，按下标顺序遍历时访问的内存也是连续的。
+ * 覆盖与删除不会移动字符数据，被替换的内容成为失效字节，可在适当时机调用 dstr_array_compact 回收。
+ * 表本身不是线程安全的。
+ */
+
+// 字符串表
+typedef struct DStrArray DStrArray;
+
+// 创建、销毁、清空
+DStrArray *dstr_array_create(void) NODISCARD;
+
+void dstr_array_destroy(
+    DStrArray *array
+) NONNULL(1);
+
+/**
+ * 删除全部字符串，保留已分配的空间供后续复用。
+ */
+void dstr_array_clear(
+    DStrArray *array
+) NONNULL(1);
+
+// 属性获取与容量
+size_t dstr_array_count(
+    const DStrArray *array
+) PURE NONNULL(1);
+
+/**
+ * 因覆盖或删除而失效、尚未被 dstr_array_compact 回收的字节数。
+ */
+size_t dstr_array_waste(
+    const DStrArray *array
+) PURE NONNULL(1);
+
+/**
+ * 预留至少可再追加 count 个、共 bytes 字节（不含 '\0'）的字符串的空间。
+ */
+bool dstr_array_reserve(
+    DStrArray *array,
+    size_t count,
+    size_t bytes
+) NONNULL(1);
+
+// 访问
+/**
+ * 返回第 index 个字符串的视图，其后紧跟 '\0'；视图在表下一次被修改前有效。
+ */
+DStrView dstr_array_get(
+    const DStrArray *array,
+    size_t index
+) PURE NONNULL(1);
+
+const char *dstr_array_cstr(
+    const DStrArray *array,
+    size_t index
+) PURE NONNULL(1);
+
+// 编辑
+/**
+ * 在末尾追加 src 的副本，src 可以指向表自身的内容；内存不足时返回 false，表保持不变。
+ */
+bool dstr_array_push(
+    DStrArray *array,
+    DStrView src
+) NONNULL(1);
+
+bool dstr_array_push_cstr(
+    DStrArray *array,
+    const char *src
+) NONNULL(1, 2);
+
+/**
+ * 将第 index 个字符串替换为 src：不长于原内容时原地覆盖，否则追加到缓冲末尾。
+ * index 越界或内存不足时返回 false。
+ */
+bool dstr_array_set(
+    DStrArray *array,
+    size_t index,
+    DStrView src
+) NONNULL(1);
+
+/**
+ * 删除第 index 个字符串，之后的字符串下标减一；index 越界时返回 false。
+ */
+bool dstr_array_remove(
+    DStrArray *array,
+    size_t index
+) NONNULL(1);
+
+/**
+ * 按下标顺序重排字符数据，丢弃失效字节并释放多余的空间；内存不足时返回 false，表保持不变。
+ */
+bool dstr_array_compact(
+    DStrArray *array
+) NONNULL(1);
+
+// 转换
+/**
+ * 以 separator 连接表中全部字符串，一次分配完成，返回新的「动态字符串」。
+ */
+DString *dstr_join(
+    const DStrArray *array,
+    DStrView separator
+) NODISCARD NONNULL(1);
+
+#endif // DSTR_ARRAY_H
@@ -0,0 +1,105 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_GAP_BUFFER_H
+#define DSTR_GAP_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "dynamic_string.h"
+#include "portable_attributes.h"
+
+/**
+ * @file dstr_gap_buffer.h
+ * @brief 面向光标附近集中编辑的间隙缓冲
+ *
+ * 缓冲在光标处保留一段空闲的「间隙」，在光标处插入、删除只需改动间隙两端，
+ * 耗时与编辑的长度成正比；光标移动时才按移动距离搬移间隙。
+ * 需要连续内容（取 C 字符串、查找、转换）时再把间隙移到末尾，之后的编辑会在原光标处重新打开间隙。
+ */
+
+// 间隙缓冲
+typedef struct DStrGapBuffer DStrGapBuffer;
+
+// 创建、销毁
+DStrGapBuffer *dstr_gap_create(
+    DStrView initial
+) NODISCARD;
+
+void dstr_gap_destroy(
+    DStrGapBuffer *gap
+) NONNULL(1);
+
+// 属性获取
+size_t dstr_gap_length(
+    const DStrGapBuffer *gap
+) PURE NONNULL(1);
+
+char dstr_gap_at(
+    const DStrGapBuffer *gap,
+    size_t index
+) PURE NONNULL(1);
+
+// 光标
+size_t dstr_gap_cursor(
+    const DStrGapBuffer *gap
+) PURE NONNULL(1);
+
+/**
+ * 设置光标位置，index 超过长度时返回 false。间隙在下一次编辑时才会移动。
+ */
+bool dstr_gap_set_cursor(
+    DStrGapBuffer *gap,
+    size_t index
+) NONNULL(1);
+
+// 编辑
+/**
+ * 在光标处插入 src，光标移到插入内容之后。src 不能指向缓冲自身。
+ */
+bool dstr_gap_insert(
+    DStrGapBuffer *gap,
+    DStrView src
+) NONNULL(1);
+
+/**
+ * 删除光标前至多 count 个字节（退格），返回实际删除的字节数。
+ */
+size_t dstr_gap_delete_backward(
+    DStrGapBuffer *gap,
+    size_t count
+) NONNULL(1);
+
+/**
+ * 删除光标后至多 count 个字节，返回实际删除的字节数。
+ */
+size_t dstr_gap_delete_forward(
+    DStrGapBuffer *gap,
+    size_t count
+) NONNULL(1);
+
+// 连续访问
+/**
+ * 返回以 '\0' 结尾的连续内容，必要时先把间隙移到末尾；指针在下一次编辑前有效。
+ */
+const char *dstr_gap_cstr(
+    DStrGapBuffer *gap
+) NONNULL(1);
+
+DStrView dstr_gap_view(
+    DStrGapBuffer *gap
+) NONNULL(1);
+
+bool dstr_gap_find(
+    DStrGapBuffer *gap,
+    DStrView sub,
+    size_t *out_index,
+    bool backward
+) NONNULL(1, 3);
+
+DString *dstr_gap_to_dstr(
+    DStrGapBuffer *gap
+) NODISCARD NONNULL(1);
+
+#endif // DSTR_GAP_BUFFER_H
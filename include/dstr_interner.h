@@ -0,0 +1,66 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_INTERNER_H
+#define DSTR_INTERNER_H
+
+#include <stddef.h>
+#include "dynamic_string.h"
+#include "portable_attributes.h"
+
+/**
+ * @file dstr_interner.h
+ * @brief 线程安全的字符串驻留表
+ *
+ * 驻留表为每种不同的内容保存唯一一份只读的「动态字符串」，内容相同的请求总是得到同一个指针，
+ * 因此驻留后的字符串可以直接用指针比较相等，重复的内容也只占用一份内存。
+ * 表按哈希值分片，每个分片是一张独立加锁的开放寻址哈希表，多个线程可以同时驻留与查询。
+ * 在没有线程支持的平台上（或以 DSTR_NO_THREADS 编译时）不加锁，只能在单个线程中使用。
+ */
+
+// 驻留表
+typedef struct DStrInterner DStrInterner;
+
+// 创建、销毁
+DStrInterner *dstr_interner_create(void) NODISCARD;
+
+/**
+ * 销毁驻留表及其中的全部字符串，此前返回的指针随之失效。销毁时不能有其他线程仍在使用。
+ */
+void dstr_interner_destroy(
+    DStrInterner *interner
+) NONNULL(1);
+
+// 驻留与查询
+/**
+ * 返回内容与 view 相同的驻留字符串，不存在时先复制一份加入表中；内存不足时返回 NULL。
+ * 返回的字符串归驻留表所有，不能修改或销毁，在驻留表销毁前一直有效。
+ */
+const DString *dstr_intern(
+    DStrInterner *interner,
+    DStrView view
+) NONNULL(1);
+
+const DString *dstr_intern_cstr(
+    DStrInterner *interner,
+    const char *cstr
+) NONNULL(1, 2);
+
+/**
+ * 只查询、不加入，不存在时返回 NULL。
+ */
+const DString *dstr_interner_lookup(
+    DStrInterner *interner,
+    DStrView view
+) NONNULL(1);
+
+// 属性获取
+/**
+ * 表中不同内容的数量。
+ */
+size_t dstr_interner_count(
+    DStrInterner *interner
+) NONNULL(1);
+
+#endif // DSTR_INTERNER_H
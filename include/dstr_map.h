@@ -0,0 +1,132 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_MAP_H
+#define DSTR_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "dynamic_string.h"
+#include "portable_attributes.h"
+
+/**
+ * @file dstr_map.h
+ * @brief 以「动态字符串」为键的开放寻址哈希表
+ *
+ * 采用 Swiss table 布局：每个槽位对应一个控制字节，记录空、已删除或哈希值的低 7 位，
+ * 查找时一次比较 16 个控制字节（x86-64 上使用 SSE2），只有控制字节命中的槽位才比较键。
+ * 键在插入时复制为表所有的「动态字符串」并缓存哈希值，扩容时无需重新计算；
+ * 查找可直接使用视图、C 字符串或现有的「动态字符串」，不必为此构造新的字符串。
+ * 值为不透明指针，由调用者管理其生命周期。表本身不是线程安全的。
+ */
+
+// 哈希表
+typedef struct DStrMap DStrMap;
+
+// 按槽位顺序遍历的迭代器，可在栈上使用；遍历期间插入或删除会使其失效
+typedef struct DStrMapIter {
+    const DStrMap *map;
+    size_t index;
+} DStrMapIter;
+
+// 创建、销毁、清空
+DStrMap *dstr_map_create(void) NODISCARD;
+
+/**
+ * 销毁哈希表及其持有的全部键，值不做处理。
+ */
+void dstr_map_destroy(
+    DStrMap *map
+) NONNULL(1);
+
+void dstr_map_clear(
+    DStrMap *map
+) NONNULL(1);
+
+// 属性获取与容量
+size_t dstr_map_size(
+    const DStrMap *map
+) PURE NONNULL(1);
+
+/**
+ * 预留至少可容纳 count 个键的空间，之后插入不超过 count 个键时不会再扩容。
+ */
+bool dstr_map_reserve(
+    DStrMap *map,
+    size_t count
+) NONNULL(1);
+
+// 插入
+/**
+ * 插入或覆盖 key 对应的值，键不存在时复制一份保存；内存不足时返回 false，表保持不变。
+ */
+bool dstr_map_put(
+    DStrMap *map,
+    DStrView key,
+    void *value
+) NONNULL(1);
+
+bool dstr_map_put_cstr(
+    DStrMap *map,
+    const char *key,
+    void *value
+) NONNULL(1, 2);
+
+/**
+ * 与 dstr_map_put 相同，但复用 key 已缓存的哈希值；写时复制开启时键与 key 共享数据。
+ */
+bool dstr_map_put_dstr(
+    DStrMap *map,
+    const DString *key,
+    void *value
+) NONNULL(1, 2);
+
+// 查找
+/**
+ * 查找 key，存在时返回 true 并在 out_value 不为 NULL 时写出对应的值。
+ */
+bool dstr_map_get(
+    const DStrMap *map,
+    DStrView key,
+    void **out_value
+) NONNULL(1);
+
+bool dstr_map_get_cstr(
+    const DStrMap *map,
+    const char *key,
+    void **out_value
+) NONNULL(1, 2);
+
+bool dstr_map_get_dstr(
+    const DStrMap *map,
+    const DString *key,
+    void **out_value
+) NONNULL(1, 2);
+
+// 删除
+/**
+ * 删除 key，存在时返回 true 并在 out_value 不为 NULL 时写出被删除的值。
+ */
+bool dstr_map_remove(
+    DStrMap *map,
+    DStrView key,
+    void **out_value
+) NONNULL(1);
+
+// 遍历
+void dstr_map_iter_init(
+    DStrMapIter *iter,
+    const DStrMap *map
+) NONNULL(1, 2);
+
+/**
+ * 取出下一个键值对，顺序不确定；没有更多元素时返回 false。out_key、out_value 可为 NULL。
+ */
+bool dstr_map_iter_next(
+    DStrMapIter *iter,
+    const DString **out_key,
+    void **out_value
+) NONNULL(1);
+
+#endif // DSTR_MAP_H
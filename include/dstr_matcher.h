@@ -0,0 +1,99 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_MATCHER_H
+#define DSTR_MATCHER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "dynamic_string.h"
+#include "portable_attributes.h"
+
+/**
+ * @file dstr_matcher.h
+ * @brief 基于 Aho-Corasick 自动机的多模式匹配
+ *
+ * 由一组模式构造一次匹配器后，可在单次扫描中找出字符串里所有模式的全部出现（允许重叠），
+ * 扫描耗时与模式数量无关。状态转移表按「字节等价类」压缩为稠密数组，
+ * 未在任何模式中出现的字节共用同一列，以减小表的体积。
+ */
+
+// 多模式匹配器
+typedef struct DStrMatcher DStrMatcher;
+
+// 一次匹配：pattern 为模式在构造时的下标，index 为匹配在字符串中的起始位置
+typedef struct DStrMatch {
+    size_t pattern;
+    size_t index;
+} DStrMatch;
+
+/**
+ * 匹配回调，返回 false 时停止扫描。
+ */
+typedef bool (*DStrMatchCallback)(const DStrMatch *match, void *ctx);
+
+// 创建、销毁
+/**
+ * 由 count 个以 '\0' 结尾的模式构造匹配器，空模式不匹配任何位置。
+ */
+DStrMatcher *dstr_matcher_create(
+    const char *const *patterns,
+    size_t count
+) NODISCARD NONNULL(1);
+
+/**
+ * 由 count 个指定长度的模式构造匹配器，模式中可以包含 '\0'。
+ */
+DStrMatcher *dstr_matcher_create_n(
+    const char *const *patterns,
+    const size_t *lengths,
+    size_t count
+) NODISCARD NONNULL(1, 2);
+
+void dstr_matcher_destroy(
+    DStrMatcher *matcher
+) NONNULL(1);
+
+size_t dstr_matcher_pattern_count(
+    const DStrMatcher *matcher
+) PURE NONNULL(1);
+
+// 匹配
+/**
+ * 按结束位置从前到后报告所有匹配（同一结束位置上先报告较长的模式），返回报告的匹配数。
+ */
+size_t dstr_matcher_find_all(
+    const DStrMatcher *matcher,
+    const DString *dstr,
+    DStrMatchCallback callback,
+    void *ctx
+) NONNULL(1, 2, 3);
+
+/**
+ * 查找结束位置最靠前的匹配（同一结束位置上取较长的模式）。
+ */
+bool dstr_matcher_find_first(
+    const DStrMatcher *matcher,
+    const DString *dstr,
+    DStrMatch *out_match
+) NONNULL(1, 2, 3);
+
+/**
+ * 是否至少有一个模式出现在字符串中。
+ */
+bool dstr_matcher_contains_any(
+    const DStrMatcher *matcher,
+    const DString *dstr
+) NONNULL(1, 2) PURE;
+
+/**
+ * 统计每个模式的出现次数（允许重叠），结果写入 out_counts[0, pattern_count)，返回总次数。
+ */
+size_t dstr_matcher_count(
+    const DStrMatcher *matcher,
+    const DString *dstr,
+    size_t *out_counts
+) NONNULL(1, 2, 3);
+
+#endif // DSTR_MATCHER_H
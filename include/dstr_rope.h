@@ -0,0 +1,146 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_ROPE_H
+#define DSTR_ROPE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "dynamic_string.h"
+#include "portable_attributes.h"
+
+/**
+ * @file dstr_rope.h
+ * @brief 面向超长、频繁编辑文本的绳索（rope）表示
+ *
+ * 内容被切分为不超过固定容量的块，按顺序组织为一棵以偏移为键的平衡树（隐式 treap），
+ * 任意位置的插入、删除、拆分与拼接的期望时间均为 O(log n)（另加被复制内容的长度），
+ * 不会像扁平缓冲那样移动整个尾部。相邻的小块在编辑后会被合并，避免反复编辑后碎片化。
+ * 需要连续内存时可随时展平为「动态字符串」。
+ */
+
+// 绳索
+typedef struct DStrRope DStrRope;
+
+// 按块顺序遍历内容的迭代器，可在栈上使用
+typedef struct DStrRopeIter {
+    const DStrRope *rope;
+    size_t offset;
+} DStrRopeIter;
+
+// 创建、销毁
+DStrRope *dstr_rope_create(void) NODISCARD;
+
+DStrRope *dstr_rope_create_from(
+    DStrView view
+) NODISCARD;
+
+void dstr_rope_destroy(
+    DStrRope *rope
+) NONNULL(1);
+
+// 属性获取
+size_t dstr_rope_length(
+    const DStrRope *rope
+) PURE NONNULL(1);
+
+char dstr_rope_at(
+    const DStrRope *rope,
+    size_t index
+) PURE NONNULL(1);
+
+// 编辑
+/**
+ * 在 index 处插入 src，src 不能指向绳索自身的块。
+ */
+bool dstr_rope_insert(
+    DStrRope *rope,
+    size_t index,
+    DStrView src
+) NONNULL(1);
+
+bool dstr_rope_append(
+    DStrRope *rope,
+    DStrView src
+) NONNULL(1);
+
+/**
+ * 删除 [sub_index, sub_index + sub_count)，sub_count 为 0 时删除到末尾（与 dstr_remove 相同）。
+ */
+bool dstr_rope_remove(
+    DStrRope *rope,
+    size_t sub_index,
+    size_t sub_count
+) NONNULL(1);
+
+/**
+ * 将 src 的全部内容移动到 dest 末尾，src 随后为空；不复制数据。
+ */
+void dstr_rope_concat(
+    DStrRope *dest,
+    DStrRope *src
+) NONNULL(1, 2);
+
+/**
+ * 将 [index, length) 拆分为新的绳索返回，rope 只保留 [0, index)。
+ */
+DStrRope *dstr_rope_split(
+    DStrRope *rope,
+    size_t index
+) NODISCARD NONNULL(1);
+
+// 转换
+/**
+ * 将 [sub_index, sub_index + sub_count) 复制为新的「动态字符串」，规则与 dstr_sub 相同。
+ */
+DString *dstr_rope_sub(
+    const DStrRope *rope,
+    size_t sub_index,
+    size_t sub_count
+) NODISCARD NONNULL(1);
+
+DString *dstr_rope_to_dstr(
+    const DStrRope *rope
+) NODISCARD NONNULL(1);
+
+// 遍历
+/**
+ * 从 offset 处开始遍历，绳索被修改后迭代器需重新初始化。
+ */
+void dstr_rope_iter_init(
+    DStrRopeIter *iter,
+    const DStrRope *rope,
+    size_t offset
+) NONNULL(1, 2);
+
+/**
+ * 取出下一段连续内容（第一段可能从块的中间开始），没有更多内容时返回 false。
+ */
+bool dstr_rope_iter_next(
+    DStrRopeIter *iter,
+    DStrView *out_chunk
+) NONNULL(1, 2);
+
+// 查找与比较
+/**
+ * 从 from 处开始查找 sub 第一次出现的位置，可跨越块的边界。
+ */
+bool dstr_rope_find(
+    const DStrRope *rope,
+    DStrView sub,
+    size_t from,
+    size_t *out_index
+) NONNULL(1, 4);
+
+bool dstr_rope_equals(
+    const DStrRope *rope,
+    DStrView view
+) PURE NONNULL(1);
+
+int dstr_rope_compare(
+    const DStrRope *rope,
+    DStrView view
+) PURE NONNULL(1);
+
+#endif // DSTR_ROPE_H
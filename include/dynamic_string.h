@@ -5,19 +5,112 @@
 #ifndef DYNAMIC_STRING_H
 #define DYNAMIC_STRING_H
 
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include "dstr_allocator.h"
 #include "portable_attributes.h"
 
 // ADT 类型别名声明
 typedef struct DynamicString DString;
 
+// 由调用者提供的字符串头部存储
+/**
+ * 大小与对齐均足以容纳一个「动态字符串」的头部，可以放在栈上、嵌入其他结构体或组成连续的数组，
+ * 经 dstr_init 初始化后即可作为 DString 使用，省去单独的头部分配。成员不应直接访问。
+ */
+#define DSTR_STORAGE_SIZE (5 * sizeof(void *) + 16)
+
+typedef union DStrStorage {
+    unsigned char bytes[DSTR_STORAGE_SIZE];
+    uint64_t align_u64;
+    size_t align_size;
+    void *align_ptr;
+} DStrStorage;
+
+// 预编译查找模式，一次编译后可在任意多个字符串上反复使用
+typedef struct DStrPattern DStrPattern;
+
+// 预编译批量替换，一次构造后可在任意多个字符串上反复使用
+typedef struct DStrReplaceSet DStrReplaceSet;
+
+// 只读视图：不持有内容的「指针 + 长度」切片
+/**
+ * 视图不复制也不拥有数据，指向字符串内部时仅在该字符串下一次被修改或销毁之前有效。
+ * 视图内容不保证以 '\0' 结尾，可以包含 '\0'。
+ */
+typedef struct DStrView {
+    const char *data;
+    size_t len;
+} DStrView;
+
+// 批量替换中的一组 old -> new
+typedef struct DStrReplacePair {
+    const char *old;
+    const char *new;
+} DStrReplacePair;
+
+// 容量增长策略
+/**
+ * 描述「动态字符串」在容量不足时如何扩容、在空闲过多时如何收缩。
+ *
+ * 扩容时新容量取「当前容量 × growth_percent / 100」与所需容量中的较大者，
+ * 且单次额外扩容不超过 max_growth 字节（0 表示不限）。
+ * 仅当所需容量低于当前容量的 shrink_percent% 时才收缩（0 表示从不自动收缩），
+ * 收缩后仍按倍率保留余量，以免在阈值附近反复扩缩。
+ *
+ * 策略对象以指针形式被字符串引用，调用者需保证其生命周期不短于使用它的字符串。
+ */
+typedef struct DStrGrowthPolicy {
+    size_t growth_percent;
+    size_t max_growth;
+    size_t shrink_percent;
+} DStrGrowthPolicy;
+
+// 预置策略
+extern const DStrGrowthPolicy DSTR_GROWTH_EXACT; // 按需精确分配，每次都收缩（旧行为）
+extern const DStrGrowthPolicy DSTR_GROWTH_1_5X;  // 1.5 倍扩容，使用量低于 25% 时收缩（默认）
+extern const DStrGrowthPolicy DSTR_GROWTH_2X;    // 2 倍扩容，使用量低于 25% 时收缩
+
 // API 函数原型（声明）
 // 创建、销毁、清空
 DString *dstr_create(
     const char *cstr
 ) NODISCARD;
 
+/**
+ * 以 data[0, len) 为内容创建字符串，data 中可以包含 '\0'。
+ */
+DString *dstr_create_n(
+    const char *data,
+    size_t len
+) NODISCARD;
+
+/**
+ * 创建使用指定分配器的字符串，头部与数据均从该分配器申请，allocator 为 NULL 时使用全局默认分配器。
+ */
+DString *dstr_create_with_allocator(
+    const char *cstr,
+    const DStrAllocator *allocator
+) NODISCARD;
+
+/**
+ * 创建头部与字符数据位于同一次分配中的字符串，尾随存储至少可容纳 capacity 字节（含 '\0'）。
+ * 内容超出尾随存储时数据转移到独立的堆缓冲，缩回后重新使用尾随存储，头部地址始终不变。
+ * 以 DSTR_PACKED_LAYOUT 宏编译时，dstr_create、dstr_clone、dstr_sub 等默认采用此布局。
+ */
+DString *dstr_create_packed(
+    const char *cstr,
+    size_t capacity
+) NODISCARD;
+
+DString *dstr_create_packed_with_allocator(
+    const char *cstr,
+    size_t capacity,
+    const DStrAllocator *allocator
+) NODISCARD;
+
 void dstr_destroy(
     DString *dstr
 ) NONNULL(1);
@@ -26,6 +119,64 @@ void dstr_clear(
     DString *dstr
 ) NONNULL(1);
 
+// 在调用者提供的存储上初始化、清理
+/**
+ * 在 storage 上初始化内容为 cstr 的字符串，返回的指针即 (DString *) storage，失败时返回 NULL。
+ * 短字符串直接存放在 storage 内，不申请任何内存；storage 需在字符串使用期间保持有效且不被移动。
+ * 以此方式初始化的字符串由 dstr_fini 清理，dstr_destroy 与 dstr_release 也只释放数据而不释放 storage。
+ */
+DString *dstr_init(
+    DStrStorage *storage,
+    const char *cstr
+) NODISCARD NONNULL(1);
+
+DString *dstr_init_with_allocator(
+    DStrStorage *storage,
+    const char *cstr,
+    const DStrAllocator *allocator
+) NODISCARD NONNULL(1);
+
+/**
+ * 释放由 dstr_init 初始化的字符串的数据，之后 storage 可以重新初始化或丢弃。
+ */
+void dstr_fini(
+    DString *dstr
+) NONNULL(1);
+
+// 缓冲所有权转移
+/**
+ * 接管由全局默认分配器申请的缓冲 buf 作为新字符串的数据，不复制内容。
+ * buf 的容量为 cap 字节，内容为 buf[0, len)，要求 len < cap，buf[len] 会被写为 '\0'。
+ * 成功后 buf 归字符串所有；失败时返回 NULL，buf 仍归调用者所有。
+ */
+DString *dstr_adopt(
+    char *buf,
+    size_t len,
+    size_t cap
+) NODISCARD NONNULL(1);
+
+/**
+ * 同 dstr_adopt，buf 须由 allocator 申请，allocator 为 NULL 时使用全局默认分配器。
+ */
+DString *dstr_adopt_with_allocator(
+    char *buf,
+    size_t len,
+    size_t cap,
+    const DStrAllocator *allocator
+) NODISCARD NONNULL(1);
+
+/**
+ * 取出字符串的数据缓冲并销毁字符串，返回以 '\0' 结尾的缓冲，长度与容量分别写入 out_len 与 out_cap（可为 NULL）。
+ * 缓冲需以该字符串的分配器按 out_cap 释放（默认即 free）。
+ * 数据位于独占的堆缓冲时不复制内容；位于内嵌缓冲、尾随存储或与其他字符串共享时复制出一份。
+ * 复制失败时返回 NULL，字符串保持不变。
+ */
+char *dstr_release(
+    DString *dstr,
+    size_t *out_len,
+    size_t *out_cap
+) NODISCARD NONNULL(1);
+
 // 属性获取与设置
 const char *dstr_cstr(
     const DString *dstr
@@ -45,6 +196,69 @@ bool dstr_resize_capacity(
     size_t new_capacity
 ) NONNULL(1);
 
+// 分配器
+/**
+ * 设置全局默认分配器，传入 NULL 恢复为 DSTR_ALLOCATOR_LIBC。
+ * 仅影响此后创建的字符串，应在程序初始化阶段调用。
+ */
+void dstr_set_default_allocator(
+    const DStrAllocator *allocator
+);
+
+const DStrAllocator *dstr_default_allocator(void) PURE;
+
+const DStrAllocator *dstr_allocator(
+    const DString *dstr
+) PURE NONNULL(1);
+
+// 增长策略
+/**
+ * 设置全局默认增长策略，传入 NULL 恢复为 DSTR_GROWTH_1_5X。
+ * 仅影响未单独设置策略的字符串，应在程序初始化阶段调用。
+ */
+void dstr_set_default_growth_policy(
+    const DStrGrowthPolicy *policy
+);
+
+const DStrGrowthPolicy *dstr_default_growth_policy(void) PURE;
+
+/**
+ * 为单个字符串设置增长策略，传入 NULL 表示跟随全局默认策略。
+ * 策略与分配器的每种组合首次使用时需要一次小的分配，内存不足时返回 false，策略保持不变。
+ */
+bool dstr_set_growth_policy(
+    DString *dstr,
+    const DStrGrowthPolicy *policy
+) NONNULL(1);
+
+const DStrGrowthPolicy *dstr_growth_policy(
+    const DString *dstr
+) PURE NONNULL(1);
+
+// 写时复制
+/**
+ * 开启或关闭写时复制。开启后 dstr_clone、dstr_cpy 在源字符串使用独立堆缓冲且分配器相同时
+ * 只共享数据并增加引用计数，任何一方首次修改时才复制出独占的一份；短字符串仍按值复制。
+ * 引用计数以原子操作维护，共享数据的字符串可以分属不同线程，但单个字符串仍不能被多个线程同时修改。
+ * 开启后超出内嵌缓冲的内容不再使用尾随存储，已在尾随存储中的内容会移入共享块，以便克隆时共享。
+ * 编译时定义 DSTR_COPY_ON_WRITE 为非零值可使新建的字符串默认开启，此时 dstr_create_packed 等不再预留尾随存储。
+ */
+bool dstr_set_copy_on_write(
+    DString *dstr,
+    bool enable
+) NONNULL(1);
+
+bool dstr_copy_on_write(
+    const DString *dstr
+) PURE NONNULL(1);
+
+/**
+ * 判断字符串当前是否与其他字符串共享数据。
+ */
+bool dstr_is_shared(
+    const DString *dstr
+) PURE NONNULL(1);
+
 // 复制、追加、插入、删除
 // 复制、追加、插入完整现有字符串到目标字符串
 bool dstr_cpy_cstr(
@@ -67,6 +281,19 @@ bool dstr_cat(
     const DString *src
 ) NONNULL(1, 2);
 
+/**
+ * 追加 data[0, len)，data 中可以包含 '\0'，也可以指向 dest 自身的内容。
+ */
+bool dstr_cat_n(
+    DString *dest,
+    const char *data,
+    size_t len
+) NONNULL(1, 2);
+
+/**
+ * 在 index 处插入 src。src 可以指向 dest 自身的内容，dstr_insert 的 src 也可以就是 dest；
+ * 对应的 _sub 版本同样如此。
+ */
 bool dstr_insert_cstr(
     DString *dest,
     const char *src,
@@ -146,6 +373,88 @@ bool dstr_printf(
     ...
 ) FORMAT(2, 3) NONNULL(1, 2);
 
+/**
+ * 将格式化结果追加到末尾。先直接格式化到现有的空闲容量中，放不下时才按所需长度扩容并重新格式化一次。
+ * 除标准转换说明外支持 %S：参数为 const DString *，按长度嵌入其内容（可含 '\0'），无需 dstr_cstr 与 strlen，
+ * 支持宽度、精度与 '-' 标志；参数可以是 dstr 自身，此时嵌入的是调用前的内容。
+ * 由于 %S 与标准库中宽字符串的写法冲突，这两个函数不做编译期格式检查。
+ * 其余参数不能指向 dstr 自身的内容；结果为空或出错时返回 false，dstr 保持不变。
+ */
+bool dstr_appendf(
+    DString *dstr,
+    const char *format,
+    ...
+) NONNULL(1, 2);
+
+bool dstr_vappendf(
+    DString *dstr,
+    const char *format,
+    va_list args
+) NONNULL(1, 2);
+
+// 数值转换
+/**
+ * 追加整数的十进制表示，不经过 printf 的格式解析。
+ */
+bool dstr_cat_i64(
+    DString *dest,
+    int64_t value
+) NONNULL(1);
+
+bool dstr_cat_u64(
+    DString *dest,
+    uint64_t value
+) NONNULL(1);
+
+/**
+ * 追加能精确还原 value 的十进制表示（Grisu2）：绝大多数情况下位数最短，少数情况下多出一两位；
+ * 最短表示恰好落在舍入区间边界上的值会输出完整的位数（如 1e23 输出为 "9.999999999999999e+22"）。
+ * 科学计数法下的指数在 [-6, 20] 内（即 1e-6 <= |value| < 1e21）时使用定点写法，整数不带小数点
+ * （如 "100"、"0.001"），否则形如 "1e+21"、"1.5e+300"；
+ * 非数值为 "nan"，无穷为 "inf" 或 "-inf"，负零为 "-0"。输出与区域设置无关，可由 dstr_parse_double 原样读回。
+ */
+bool dstr_cat_double(
+    DString *dest,
+    double value
+) NONNULL(1);
+
+/**
+ * 将整个字符串解析为十进制整数：可带一个正负号，不允许空白或多余字符，溢出时返回 false。
+ */
+bool dstr_parse_i64(
+    const DString *dstr,
+    int64_t *out_value
+) NONNULL(1, 2);
+
+bool dstr_parse_u64(
+    const DString *dstr,
+    uint64_t *out_value
+) NONNULL(1, 2);
+
+/**
+ * 将整个字符串解析为浮点数，结果正确舍入：接受 [+-]数字[.数字][e[+-]数字] 以及 inf、infinity、nan（不区分大小写），
+ * 小数点始终为 '.'，与区域设置无关；溢出为无穷时返回 false。
+ */
+bool dstr_parse_double(
+    const DString *dstr,
+    double *out_value
+) NONNULL(1, 2);
+
+bool dstr_parse_i64_view(
+    DStrView view,
+    int64_t *out_value
+) NONNULL(2);
+
+bool dstr_parse_u64_view(
+    DStrView view,
+    uint64_t *out_value
+) NONNULL(2);
+
+bool dstr_parse_double_view(
+    DStrView view,
+    double *out_value
+) NONNULL(2);
+
 // 从现有字符串生成新字符串
 // 提取子串
 DString *dstr_sub_cstr(
@@ -161,24 +470,32 @@ DString *dstr_sub(
 ) NODISCARD NONNULL(1);
 
 // 克隆
+/**
+ * 克隆字符串，新字符串沿用源字符串的分配器（dstr_sub 同理）。
+ */
 DString *dstr_clone(
     const DString *dstr
 ) NODISCARD NONNULL(1);
 
+DString *dstr_clone_with_allocator(
+    const DString *dstr,
+    const DStrAllocator *allocator
+) NODISCARD NONNULL(1);
+
 // 查找、统计与替换
 bool dstr_find_cstr(
     const DString *dstr,
     const char *sub,
     size_t *out_index,
     bool backward
-) NONNULL(1, 2, 3) PURE;
+) NONNULL(1, 2, 3);
 
 bool dstr_find(
     const DString *dstr,
     const DString *sub,
     size_t *out_index,
     bool backward
-) NONNULL(1, 2, 3) PURE;
+) NONNULL(1, 2, 3);
 
 size_t dstr_count_cstr(
     const DString *dstr,
@@ -196,7 +513,7 @@ bool dstr_find_nth_cstr(
     size_t *out_index,
     size_t n,
     bool backward
-) NONNULL(1, 2, 3) PURE;
+) NONNULL(1, 2, 3);
 
 bool dstr_find_nth(
     const DString *dstr,
@@ -204,7 +521,7 @@ bool dstr_find_nth(
     size_t *out_index,
     size_t n,
     bool backward
-) NONNULL(1, 2, 3) PURE;
+) NONNULL(1, 2, 3);
 
 size_t dstr_replace_cstr(
     DString *dstr,
@@ -222,7 +539,93 @@ size_t dstr_replace(
     bool backward
 ) NONNULL(1, 2, 3);
 
+/**
+ * 在一次扫描中同时完成 count 组替换，按「最左最长」规则选取匹配：
+ * 每次取起点最靠左的匹配，同起点时取最长的 old（old 相同时取靠前的一组），替换后从匹配之后继续，
+ * 替换进来的内容不会再被匹配。空的 old 被忽略。
+ * 原内容只被自动机读一遍，耗时与字符串长度成线性，与 old 的数量和长度无关（另需构造自动机）；
+ * 结果只分配一次缓冲，返回替换的次数；内存不足时返回 0 且字符串保持不变。
+ * 同一组替换要用于多个字符串时，可用 dstr_replace_set_create 预先构造，免去每次重建自动机。
+ */
+size_t dstr_replace_many(
+    DString *dstr,
+    const DStrReplacePair *pairs,
+    size_t count
+) NONNULL(1);
+
+// 预编译批量替换
+/**
+ * 由 count 组替换构造匹配自动机，保存各组 old、new 的副本，创建后与 pairs 无关。
+ */
+DStrReplaceSet *dstr_replace_set_create(
+    const DStrReplacePair *pairs,
+    size_t count
+) NODISCARD;
+
+void dstr_replace_set_destroy(
+    DStrReplaceSet *set
+) NONNULL(1);
+
+/**
+ * 以预先构造的 set 完成与 dstr_replace_many 相同的批量替换。
+ */
+size_t dstr_replace_many_set(
+    DString *dstr,
+    const DStrReplaceSet *set
+) NONNULL(1, 2);
+
+// 预编译查找模式
+/**
+ * 由 needle 编译查找模式：单字节模式使用 memchr，短模式使用 SIMD 首尾字节过滤，
+ * 长模式预先构造 Horspool 跳转表。模式保存 needle 的副本，创建后与 needle 无关。
+ * 空模式不匹配任何位置。
+ */
+DStrPattern *dstr_pattern_create(
+    const char *needle
+) NODISCARD NONNULL(1);
+
+DStrPattern *dstr_pattern_create_n(
+    const char *needle,
+    size_t needle_len
+) NODISCARD NONNULL(1);
+
+void dstr_pattern_destroy(
+    DStrPattern *pattern
+) NONNULL(1);
+
+size_t dstr_pattern_length(
+    const DStrPattern *pattern
+) PURE NONNULL(1);
+
+const char *dstr_pattern_needle(
+    const DStrPattern *pattern
+) PURE NONNULL(1);
+
+bool dstr_find_pattern(
+    const DString *dstr,
+    const DStrPattern *pattern,
+    size_t *out_index,
+    bool backward
+) NONNULL(1, 2, 3);
+
+size_t dstr_count_pattern(
+    const DString *dstr,
+    const DStrPattern *pattern
+) NONNULL(1, 2) PURE;
+
+size_t dstr_replace_pattern(
+    DString *dstr,
+    const DStrPattern *pattern,
+    const char *new,
+    size_t n,
+    bool backward
+) NONNULL(1, 2, 3);
+
 // 判断与比较
+/**
+ * 以下函数均按长度逐字节（无符号）比较，字符串中可以包含 '\0'；
+ * compare 系列在公共前缀相同时认为较短者较小。
+ */
 bool dstr_starts_with_cstr(
     const DString *dstr,
     const char *prefix
@@ -273,5 +676,177 @@ int dstr_compare(
     const DString *dstr_2
 ) NONNULL(1, 2) PURE;
 
+// 只读视图
+// 构造
+DStrView dstr_view(
+    const DString *dstr
+) PURE NONNULL(1);
+
+/**
+ * 取 [sub_index, sub_index + sub_count) 的视图，sub_count 为 0 时取到末尾（与 dstr_sub 相同）；
+ * 范围越界时返回 data 为 NULL 的空视图。
+ */
+DStrView dstr_view_sub(
+    const DString *dstr,
+    size_t sub_index,
+    size_t sub_count
+) PURE NONNULL(1);
+
+DStrView dstr_view_cstr(
+    const char *cstr
+) PURE NONNULL(1);
+
+/**
+ * 在视图上再取子视图，规则与 dstr_view_sub 相同。
+ */
+DStrView dstr_view_slice(
+    DStrView view,
+    size_t sub_index,
+    size_t sub_count
+) PURE;
+
+// 以视图为参数的复制、追加、插入
+bool dstr_cpy_view(
+    DString *dest,
+    DStrView src
+) NONNULL(1);
+
+bool dstr_cat_view(
+    DString *dest,
+    DStrView src
+) NONNULL(1);
+
+bool dstr_insert_view(
+    DString *dest,
+    DStrView src,
+    size_t index
+) NONNULL(1);
+
+// 批量追加
+/**
+ * 依次追加 count 个片段：先求出总长度，只扩容一次，再逐段复制。
+ * 片段即「指针 + 长度」，可直接用于已知长度的分散数据（类似 writev 的 iovec）；片段可以指向 dest 自身。
+ * 总长度为 0 时返回 false；失败时 dest 保持不变。
+ */
+bool dstr_cat_many(
+    DString *dest,
+    const DStrView *pieces,
+    size_t count
+) NONNULL(1);
+
+bool dstr_cat_many_cstr(
+    DString *dest,
+    const char *const *pieces,
+    size_t count
+) NONNULL(1);
+
+/**
+ * 依次追加以 NULL 结尾的 C 字符串参数列表，规则同 dstr_cat_many，
+ * 例如 dstr_cat_all(dstr, "GET ", path, " HTTP/1.1\r\n", NULL)。
+ */
+bool dstr_cat_all(
+    DString *dest,
+    ...
+) NONNULL(1);
+
+// 直接写入空闲容量
+/**
+ * 确保末尾至少有 n 字节的空闲容量（按增长策略扩容），返回指向当前内容之后的可写指针，失败时返回 NULL。
+ * 调用者可直接向其中写入（如 read、recv、解压缩的输出），再以 dstr_commit_append 提交实际写入的字节数；
+ * 两次调用之间不能以其他方式访问或修改 dstr，此时内容可能暂时没有 '\0' 结尾。
+ */
+char *dstr_prepare_append(
+    DString *dstr,
+    size_t n
+) NODISCARD NONNULL(1);
+
+/**
+ * 将 dstr_prepare_append 之后写入的 written 字节计入内容并补上 '\0'，written 可以为 0；
+ * written 超出空闲容量时返回 false，内容不变。
+ */
+bool dstr_commit_append(
+    DString *dstr,
+    size_t written
+) NONNULL(1);
+
+// 以视图为参数的查找与统计
+bool dstr_find_view(
+    const DString *dstr,
+    DStrView sub,
+    size_t *out_index,
+    bool backward
+) NONNULL(1, 3);
+
+size_t dstr_count_view(
+    const DString *dstr,
+    DStrView sub
+) PURE NONNULL(1);
+
+bool dstr_contains_view(
+    const DString *dstr,
+    DStrView sub
+) PURE NONNULL(1);
+
+// 以视图为参数的判断与比较
+bool dstr_starts_with_view(
+    const DString *dstr,
+    DStrView prefix
+) PURE NONNULL(1);
+
+bool dstr_ends_with_view(
+    const DString *dstr,
+    DStrView suffix
+) PURE NONNULL(1);
+
+bool dstr_equals_view(
+    const DString *dstr,
+    DStrView view
+) PURE NONNULL(1);
+
+int dstr_compare_view(
+    const DString *dstr,
+    DStrView view
+) PURE NONNULL(1);
+
+// 视图之间的查找与比较
+bool dstr_view_find(
+    DStrView view,
+    DStrView sub,
+    size_t *out_index,
+    bool backward
+) NONNULL(3);
+
+bool dstr_view_equals(
+    DStrView view_1,
+    DStrView view_2
+) PURE;
+
+int dstr_view_compare(
+    DStrView view_1,
+    DStrView view_2
+) PURE;
+
+// 哈希
+/**
+ * 字符串内容的 64 位哈希值（种子为 0），结果缓存在字符串中，任何修改内容的操作都会使缓存失效，
+ * 因此对同一个键的重复查询不再重新计算。与 dstr_hash_view 对相同内容的结果一致。
+ * 缓存以原子操作读写，未被修改的字符串可以在多个线程中同时求哈希（如共享的只读键）。
+ * 哈希值不保证在不同版本、不同字节序的平台间保持一致，不应持久化。
+ */
+uint64_t dstr_hash(
+    const DString *dstr
+) NONNULL(1);
+
+uint64_t dstr_hash_view(
+    DStrView view
+) PURE;
+
+/**
+ * 以 seed 为种子计算哈希，可用于抵御针对哈希表的碰撞攻击。
+ */
+uint64_t dstr_hash_view_seeded(
+    DStrView view,
+    uint64_t seed
+) PURE;
 
 #endif // DYNAMIC_STRING_H
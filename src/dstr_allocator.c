@@ -0,0 +1,482 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_allocator.h"
+#include "dstr_threads.h"
+#include <assert.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 基于 malloc/realloc/free 的分配器
+static void *libc_allocate(void *ctx, const size_t size) {
+    (void) ctx;
+    return malloc(size);
+}
+
+static void *libc_reallocate(void *ctx, void *ptr, const size_t old_size, const size_t new_size) {
+    (void) ctx;
+    (void) old_size;
+    return realloc(ptr, new_size);
+}
+
+static void libc_deallocate(void *ctx, void *ptr, const size_t size) {
+    (void) ctx;
+    (void) size;
+    free(ptr);
+}
+
+const DStrAllocator DSTR_ALLOCATOR_LIBC = {
+    libc_allocate,
+    libc_reallocate,
+    libc_deallocate,
+    NULL
+};
+
+// Arena 分配器
+#define ARENA_ALIGN alignof(max_align_t)
+#define ARENA_DEFAULT_BLOCK_SIZE ((size_t) 64 * 1024)
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *prev;
+    size_t cap;
+    size_t used;
+    alignas(max_align_t) unsigned char data[];
+} ArenaBlock;
+
+struct DStrArena {
+    DStrAllocator allocator;
+    ArenaBlock *head; // 当前块，沿 prev 链接到更早的块
+    size_t block_size;
+    unsigned char *last; // 最后一次分配的起始地址，NULL 表示未知
+};
+
+static inline size_t align_up(const size_t size) {
+    return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+static ArenaBlock *arena_block_new(ArenaBlock *prev, const size_t cap) {
+    ArenaBlock *block;
+
+    block = malloc(sizeof(ArenaBlock) + cap);
+    if (block == NULL) return NULL;
+
+    block->prev = prev;
+    block->cap = cap;
+    block->used = 0;
+    return block;
+}
+
+// 当前块内是否还能容纳 size 字节（从已对齐的游标开始）
+static inline bool arena_block_fits(const ArenaBlock *block, const size_t offset, const size_t size) {
+    return offset <= block->cap && size <= block->cap - offset;
+}
+
+static void *arena_allocate(void *ctx, const size_t size) {
+    DStrArena *arena;
+    ArenaBlock *block;
+    size_t offset, cap;
+
+    arena = ctx;
+    block = arena->head;
+    offset = align_up(block->used);
+
+    if (!arena_block_fits(block, offset, size)) {
+        if (size > SIZE_MAX - ARENA_ALIGN) return NULL;
+        cap = size > arena->block_size ? align_up(size) : arena->block_size;
+        block = arena_block_new(block, cap);
+        if (block == NULL) return NULL;
+        arena->head = block;
+        offset = 0;
+    }
+
+    block->used = offset + size;
+    arena->last = block->data + offset;
+    return arena->last;
+}
+
+static void *arena_reallocate(void *ctx, void *ptr, const size_t old_size, const size_t new_size) {
+    DStrArena *arena;
+    ArenaBlock *block;
+    unsigned char *new_ptr;
+    size_t offset;
+
+    arena = ctx;
+    block = arena->head;
+
+    // 最后一次分配且当前块内有余量时原地扩缩
+    if (ptr != NULL && ptr == arena->last) {
+        offset = (unsigned char *) ptr - block->data;
+        if (arena_block_fits(block, offset, new_size)) {
+            block->used = offset + new_size;
+            return ptr;
+        }
+    }
+
+    if (ptr != NULL && new_size <= old_size) return ptr;
+
+    new_ptr = arena_allocate(ctx, new_size);
+    if (new_ptr == NULL) return NULL;
+    if (ptr != NULL) memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
+
+static void arena_deallocate(void *ctx, void *ptr, const size_t size) {
+    DStrArena *arena;
+
+    (void) size;
+    arena = ctx;
+
+    // 只有最后一次分配能被回收，其余等待统一释放
+    if (ptr != NULL && ptr == arena->last) {
+        arena->head->used = arena->last - arena->head->data;
+        arena->last = NULL;
+    }
+}
+
+DStrArena *dstr_arena_create(const size_t block_size) {
+    DStrArena *arena;
+
+    arena = malloc(sizeof(DStrArena));
+    if (arena == NULL) return NULL;
+
+    arena->block_size = align_up(block_size != 0 ? block_size : ARENA_DEFAULT_BLOCK_SIZE);
+    arena->head = arena_block_new(NULL, arena->block_size);
+    if (arena->head == NULL) {
+        free(arena);
+        return NULL;
+    }
+
+    arena->allocator = (DStrAllocator){
+        arena_allocate,
+        arena_reallocate,
+        arena_deallocate,
+        arena
+    };
+    arena->last = NULL;
+    return arena;
+}
+
+void dstr_arena_destroy(DStrArena *arena) {
+    ArenaBlock *block, *prev;
+
+    assert(arena != NULL);
+
+    for (block = arena->head; block != NULL; block = prev) {
+        prev = block->prev;
+        free(block);
+    }
+    free(arena);
+}
+
+const DStrAllocator *dstr_arena_allocator(DStrArena *arena) {
+    assert(arena != NULL);
+
+    return &arena->allocator;
+}
+
+void dstr_arena_reset(DStrArena *arena) {
+    ArenaBlock *prev;
+
+    assert(arena != NULL);
+
+    while (arena->head->prev != NULL) {
+        prev = arena->head->prev;
+        free(arena->head);
+        arena->head = prev;
+    }
+    arena->head->used = 0;
+    arena->last = NULL;
+}
+
+DStrArenaMark dstr_arena_mark(const DStrArena *arena) {
+    assert(arena != NULL);
+
+    return (DStrArenaMark){arena->head, arena->head->used};
+}
+
+void dstr_arena_rewind(DStrArena *arena, const DStrArenaMark mark) {
+    ArenaBlock *prev;
+
+    assert(arena != NULL);
+
+    while (arena->head != mark.block && arena->head->prev != NULL) {
+        prev = arena->head->prev;
+        free(arena->head);
+        arena->head = prev;
+    }
+    if (arena->head == mark.block && mark.used < arena->head->used) {
+        arena->head->used = mark.used;
+    }
+    arena->last = NULL;
+}
+
+size_t dstr_arena_used(const DStrArena *arena) {
+    const ArenaBlock *block;
+    size_t used;
+
+    assert(arena != NULL);
+
+    for (used = 0, block = arena->head; block != NULL; block = block->prev) {
+        used += block->used;
+    }
+    return used;
+}
+
+// 分级内存池分配器
+// 不超过 POOL_MAX_SIZE 的请求按 16 字节分级，各级空闲块先进入线程本地缓存，
+// 缓存溢出时成批转交全局仓库，缓存为空时再成批从仓库取回，二者都为空才调用 malloc。
+// 线程退出时其本地缓存整体归还仓库，因此跨线程释放无需额外处理。
+// 平台没有线程支持或无法注册线程退出回调时不使用本地缓存，直接从仓库存取。
+#define POOL_GRANULE 16
+#define POOL_CLASS_COUNT 16
+#define POOL_MAX_SIZE (POOL_GRANULE * POOL_CLASS_COUNT)
+#define POOL_CACHE_LIMIT 64
+#define POOL_BATCH 32
+
+typedef struct PoolNode {
+    struct PoolNode *next;
+} PoolNode;
+
+typedef struct PoolCache {
+    PoolNode *head[POOL_CLASS_COUNT];
+    size_t count[POOL_CLASS_COUNT];
+    bool registered;
+    bool exiting; // 线程退出回调已归还缓存，此后不会再被归还，本线程余下的存取直接经由仓库
+} PoolCache;
+
+typedef struct PoolDepot {
+    DStrMutex lock;
+    PoolNode *head;
+    size_t count;
+} PoolDepot;
+
+static PoolDepot pool_depot[POOL_CLASS_COUNT];
+static DStrOnce pool_once = DSTR_ONCE_INIT;
+#if DSTR_HAS_THREADS
+static DStrTss pool_cache_key;
+static bool pool_cache_enabled; // 线程退出回调注册成功后才启用本地缓存
+static DSTR_THREAD_LOCAL PoolCache pool_cache;
+#endif
+
+static inline size_t pool_class_of(const size_t size) {
+    return size == 0 ? 0 : (size - 1) / POOL_GRANULE;
+}
+
+static inline size_t pool_class_size(const size_t class_index) {
+    return (class_index + 1) * POOL_GRANULE;
+}
+
+// 将 first 到 last 之间的 count 个节点挂到仓库中
+static void pool_depot_push(const size_t class_index, PoolNode *first, PoolNode *last, const size_t count) {
+    PoolDepot *depot;
+
+    depot = &pool_depot[class_index];
+    dstr_mutex_lock(&depot->lock);
+    last->next = depot->head;
+    depot->head = first;
+    depot->count += count;
+    dstr_mutex_unlock(&depot->lock);
+}
+
+// 不使用本地缓存时直接从仓库取一个节点，仓库为空时调用 malloc
+static void *pool_depot_take(const size_t class_index) {
+    PoolDepot *depot;
+    PoolNode *node;
+
+    depot = &pool_depot[class_index];
+    dstr_mutex_lock(&depot->lock);
+    node = depot->head;
+    if (node != NULL) {
+        depot->head = node->next;
+        --depot->count;
+    }
+    dstr_mutex_unlock(&depot->lock);
+
+    return node != NULL ? node : malloc(pool_class_size(class_index));
+}
+
+// 从仓库取回至多 POOL_BATCH 个节点到本地缓存，返回取回的数量
+static size_t pool_depot_pop(const size_t class_index, PoolCache *cache) {
+    PoolDepot *depot;
+    PoolNode *first, *last;
+    size_t count;
+
+    depot = &pool_depot[class_index];
+    dstr_mutex_lock(&depot->lock);
+    first = depot->head;
+    for (count = 0, last = NULL; depot->head != NULL && count < POOL_BATCH; ++count) {
+        last = depot->head;
+        depot->head = depot->head->next;
+    }
+    depot->count -= count;
+    dstr_mutex_unlock(&depot->lock);
+
+    if (count != 0) {
+        last->next = cache->head[class_index];
+        cache->head[class_index] = first;
+        cache->count[class_index] += count;
+    }
+    return count;
+}
+
+// 把本地缓存中某一级的前 count 个节点转交仓库
+static void pool_cache_spill(PoolCache *cache, const size_t class_index, const size_t count) {
+    PoolNode *first, *last;
+    size_t i;
+
+    first = last = cache->head[class_index];
+    for (i = 1; i < count; ++i) last = last->next;
+
+    cache->head[class_index] = last->next;
+    cache->count[class_index] -= count;
+    pool_depot_push(class_index, first, last, count);
+}
+
+static void pool_cache_flush(PoolCache *cache) {
+    size_t i;
+
+    for (i = 0; i < POOL_CLASS_COUNT; ++i) {
+        if (cache->count[i] != 0) pool_cache_spill(cache, i, cache->count[i]);
+    }
+}
+
+#if DSTR_HAS_THREADS
+static void DSTR_TSS_CALL pool_thread_exit(void *cache) {
+    // 之后运行的其他线程退出回调仍可能释放字符串
+    ((PoolCache *) cache)->exiting = true;
+    pool_cache_flush(cache);
+}
+#endif
+
+static void pool_init(void) {
+    size_t i;
+
+    for (i = 0; i < POOL_CLASS_COUNT; ++i) {
+        dstr_mutex_init(&pool_depot[i].lock);
+    }
+#if DSTR_HAS_THREADS
+    pool_cache_enabled = dstr_tss_create(&pool_cache_key, pool_thread_exit);
+#endif
+}
+
+// 取调用线程的本地缓存，不使用本地缓存时返回 NULL
+static PoolCache *pool_local_cache(void) {
+#if DSTR_HAS_THREADS
+    PoolCache *cache;
+
+    cache = &pool_cache;
+    if (cache->exiting) return NULL;
+    if (!cache->registered) {
+        dstr_once(&pool_once, pool_init);
+        if (!pool_cache_enabled) return NULL;
+        dstr_tss_set(pool_cache_key, cache);
+        cache->registered = true;
+    }
+    return cache;
+#else
+    dstr_once(&pool_once, pool_init);
+    return NULL;
+#endif
+}
+
+static void *pool_allocate(void *ctx, const size_t size) {
+    PoolCache *cache;
+    PoolNode *node;
+    size_t class_index;
+
+    (void) ctx;
+    if (size > POOL_MAX_SIZE) return malloc(size);
+
+    cache = pool_local_cache();
+    class_index = pool_class_of(size);
+
+    if (cache == NULL) return pool_depot_take(class_index);
+    if (cache->head[class_index] == NULL && pool_depot_pop(class_index, cache) == 0) {
+        return malloc(pool_class_size(class_index));
+    }
+
+    node = cache->head[class_index];
+    cache->head[class_index] = node->next;
+    --cache->count[class_index];
+    return node;
+}
+
+static void pool_deallocate(void *ctx, void *ptr, const size_t size) {
+    PoolCache *cache;
+    PoolNode *node;
+    size_t class_index;
+
+    (void) ctx;
+    if (ptr == NULL) return;
+    if (size > POOL_MAX_SIZE) {
+        free(ptr);
+        return;
+    }
+
+    cache = pool_local_cache();
+    class_index = pool_class_of(size);
+
+    node = ptr;
+    if (cache == NULL) {
+        pool_depot_push(class_index, node, node, 1);
+        return;
+    }
+    node->next = cache->head[class_index];
+    cache->head[class_index] = node;
+    if (++cache->count[class_index] > POOL_CACHE_LIMIT) {
+        pool_cache_spill(cache, class_index, POOL_BATCH);
+    }
+}
+
+static void *pool_reallocate(void *ctx, void *ptr, const size_t old_size, const size_t new_size) {
+    void *new_ptr;
+
+    if (ptr == NULL) return pool_allocate(ctx, new_size);
+
+    if (old_size > POOL_MAX_SIZE && new_size > POOL_MAX_SIZE) return realloc(ptr, new_size);
+    if (old_size <= POOL_MAX_SIZE && new_size <= POOL_MAX_SIZE &&
+        pool_class_of(old_size) == pool_class_of(new_size)) {
+        return ptr;
+    }
+
+    new_ptr = pool_allocate(ctx, new_size);
+    if (new_ptr == NULL) return NULL;
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    pool_deallocate(ctx, ptr, old_size);
+    return new_ptr;
+}
+
+const DStrAllocator DSTR_ALLOCATOR_POOL = {
+    pool_allocate,
+    pool_reallocate,
+    pool_deallocate,
+    NULL
+};
+
+void dstr_pool_trim(void) {
+    PoolCache *cache;
+    PoolDepot *depot;
+    PoolNode *node, *next;
+    size_t i;
+
+    cache = pool_local_cache();
+    if (cache != NULL) pool_cache_flush(cache);
+
+    for (i = 0; i < POOL_CLASS_COUNT; ++i) {
+        depot = &pool_depot[i];
+        dstr_mutex_lock(&depot->lock);
+        node = depot->head;
+        depot->head = NULL;
+        depot->count = 0;
+        dstr_mutex_unlock(&depot->lock);
+
+        for (; node != NULL; node = next) {
+            next = node->next;
+            free(node);
+        }
+    }
+}
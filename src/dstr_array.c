@@ -0,0 +1,331 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_array.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 初始容量下限
+#define ARRAY_MIN_BYTES 256
+#define ARRAY_MIN_COUNT 16
+
+// 字符串在缓冲中的位置，内容为 blob[offset, offset + len)，blob[offset + len] 为 '\0'
+typedef struct ArrayEntry {
+    size_t offset;
+    size_t len;
+} ArrayEntry;
+
+// 缓冲中 [0, used) 为各字符串及其 '\0'，其中 waste 字节已不被任何字符串引用
+struct DStrArray {
+    char *blob;
+    size_t used;
+    size_t cap;
+    size_t waste;
+    ArrayEntry *entries;
+    size_t count;
+    size_t entry_cap;
+};
+
+// 按倍扩容后的容量：至少为 needed，且不低于 minimum
+static size_t grow_target(const size_t cap, const size_t needed, const size_t minimum) {
+    size_t target;
+
+    target = cap <= SIZE_MAX / 2 ? cap * 2 : SIZE_MAX;
+    if (target < minimum) target = minimum;
+    return target > needed ? target : needed;
+}
+
+// 确保缓冲还能再写入 extra 字节
+static bool blob_reserve(DStrArray *array, const size_t extra) {
+    char *new_blob;
+    size_t new_cap;
+
+    if (array->cap - array->used >= extra) return true;
+    if (extra > SIZE_MAX - array->used) return false;
+
+    new_cap = grow_target(array->cap, array->used + extra, ARRAY_MIN_BYTES);
+    new_blob = realloc(array->blob, new_cap);
+    if (new_blob == NULL) {
+        // 预留余量失败时退回到精确分配
+        new_cap = array->used + extra;
+        new_blob = realloc(array->blob, new_cap);
+        if (new_blob == NULL) return false;
+    }
+
+    array->blob = new_blob;
+    array->cap = new_cap;
+    return true;
+}
+
+// 确保还能再追加 extra 个字符串
+static bool entries_reserve(DStrArray *array, const size_t extra) {
+    ArrayEntry *new_entries;
+    size_t new_cap;
+
+    if (array->entry_cap - array->count >= extra) return true;
+    if (extra > SIZE_MAX / sizeof(ArrayEntry) - array->count) return false;
+
+    new_cap = grow_target(array->entry_cap, array->count + extra, ARRAY_MIN_COUNT);
+    if (new_cap > SIZE_MAX / sizeof(ArrayEntry)) new_cap = array->count + extra;
+
+    new_entries = realloc(array->entries, new_cap * sizeof(ArrayEntry));
+    if (new_entries == NULL) return false;
+
+    array->entries = new_entries;
+    array->entry_cap = new_cap;
+    return true;
+}
+
+// data[0, len) 是否落在缓冲的已用部分内
+static bool blob_contains(const DStrArray *array, const char *data, const size_t len) {
+    uintptr_t begin;
+
+    begin = (uintptr_t) array->blob;
+    return len != 0 && array->blob != NULL && (uintptr_t) data >= begin && (uintptr_t) data < begin + array->used;
+}
+
+// 将 src 写到缓冲末尾（空间须已预留），返回其偏移；src 可以指向缓冲自身，aliased_offset 为其扩容前的偏移
+static size_t blob_append(DStrArray *array, const DStrView src, const bool aliased, const size_t aliased_offset) {
+    size_t offset;
+
+    offset = array->used;
+    if (src.len != 0) memcpy(array->blob + offset, aliased ? array->blob + aliased_offset : src.data, src.len);
+    array->blob[offset + src.len] = '\0';
+    array->used += src.len + 1;
+    return offset;
+}
+
+// 创建、销毁、清空
+DStrArray *dstr_array_create(void) {
+    DStrArray *array;
+
+    array = malloc(sizeof(DStrArray));
+    if (array == NULL) return NULL;
+
+    *array = (DStrArray){0};
+    return array;
+}
+
+void dstr_array_destroy(DStrArray *array) {
+    assert(array != NULL);
+
+    free(array->blob);
+    free(array->entries);
+    free(array);
+}
+
+void dstr_array_clear(DStrArray *array) {
+    assert(array != NULL);
+
+    array->used = 0;
+    array->waste = 0;
+    array->count = 0;
+}
+
+// 属性获取与容量
+size_t dstr_array_count(const DStrArray *array) {
+    assert(array != NULL);
+
+    return array->count;
+}
+
+size_t dstr_array_waste(const DStrArray *array) {
+    assert(array != NULL);
+
+    return array->waste;
+}
+
+bool dstr_array_reserve(DStrArray *array, const size_t count, const size_t bytes) {
+    assert(array != NULL);
+
+    if (bytes > SIZE_MAX - count) return false;
+
+    return entries_reserve(array, count) && blob_reserve(array, bytes + count);
+}
+
+// 访问
+DStrView dstr_array_get(const DStrArray *array, const size_t index) {
+    assert(array != NULL && index < array->count);
+
+    return (DStrView){array->blob + array->entries[index].offset, array->entries[index].len};
+}
+
+const char *dstr_array_cstr(const DStrArray *array, const size_t index) {
+    assert(array != NULL && index < array->count);
+
+    return array->blob + array->entries[index].offset;
+}
+
+// 编辑
+bool dstr_array_push(DStrArray *array, const DStrView src) {
+    size_t aliased_offset;
+    bool aliased;
+
+    assert(array != NULL && (src.data != NULL || src.len == 0));
+
+    if (src.len == SIZE_MAX) return false;
+
+    // 扩容可能移动缓冲，先记下指向自身内容的来源的偏移
+    aliased = blob_contains(array, src.data, src.len);
+    aliased_offset = aliased ? (size_t) (src.data - array->blob) : 0;
+
+    if (!entries_reserve(array, 1) || !blob_reserve(array, src.len + 1)) return false;
+
+    array->entries[array->count].offset = blob_append(array, src, aliased, aliased_offset);
+    array->entries[array->count].len = src.len;
+    ++array->count;
+    return true;
+}
+
+bool dstr_array_push_cstr(DStrArray *array, const char *src) {
+    assert(array != NULL && src != NULL);
+
+    return dstr_array_push(array, (DStrView){src, strlen(src)});
+}
+
+bool dstr_array_set(DStrArray *array, const size_t index, const DStrView src) {
+    ArrayEntry *entry;
+    size_t aliased_offset;
+    bool aliased;
+
+    assert(array != NULL && (src.data != NULL || src.len == 0));
+
+    if (index >= array->count) return false;
+
+    entry = &array->entries[index];
+    if (src.len <= entry->len) {
+        if (src.len != 0) memmove(array->blob + entry->offset, src.data, src.len);
+        array->blob[entry->offset + src.len] = '\0';
+        array->waste += entry->len - src.len;
+        entry->len = src.len;
+        return true;
+    }
+
+    aliased = blob_contains(array, src.data, src.len);
+    aliased_offset = aliased ? (size_t) (src.data - array->blob) : 0;
+
+    if (src.len == SIZE_MAX || !blob_reserve(array, src.len + 1)) return false;
+
+    array->waste += entry->len + 1;
+    entry->offset = blob_append(array, src, aliased, aliased_offset);
+    entry->len = src.len;
+    return true;
+}
+
+bool dstr_array_remove(DStrArray *array, const size_t index) {
+    ArrayEntry entry;
+
+    assert(array != NULL);
+
+    if (index >= array->count) return false;
+
+    // 位于缓冲末尾的内容直接回收，其余的计为失效字节
+    entry = array->entries[index];
+    if (entry.offset + entry.len + 1 == array->used) {
+        array->used = entry.offset;
+    } else {
+        array->waste += entry.len + 1;
+    }
+
+    memmove(array->entries + index, array->entries + index + 1, (array->count - index - 1) * sizeof(ArrayEntry));
+    --array->count;
+    return true;
+}
+
+bool dstr_array_compact(DStrArray *array) {
+    ArrayEntry *new_entries;
+    char *new_blob;
+    size_t live, pos, i;
+
+    assert(array != NULL);
+
+    live = array->used - array->waste;
+    if (live == 0) {
+        free(array->blob);
+        array->blob = NULL;
+        array->cap = 0;
+    } else if (array->waste == 0) {
+        // 没有失效字节时字符串已按下标顺序紧密排列，只需归还多余的空间
+        if (array->cap != live) {
+            new_blob = realloc(array->blob, live);
+            if (new_blob == NULL) return false;
+            array->blob = new_blob;
+            array->cap = live;
+        }
+    } else {
+        new_blob = malloc(live);
+        if (new_blob == NULL) return false;
+
+        for (pos = 0, i = 0; i < array->count; ++i) {
+            memcpy(new_blob + pos, array->blob + array->entries[i].offset, array->entries[i].len + 1);
+            array->entries[i].offset = pos;
+            pos += array->entries[i].len + 1;
+        }
+
+        free(array->blob);
+        array->blob = new_blob;
+        array->cap = live;
+    }
+    array->used = live;
+    array->waste = 0;
+
+    // 下标数组收缩失败不影响正确性，保留原数组即可
+    if (array->count == 0) {
+        free(array->entries);
+        array->entries = NULL;
+        array->entry_cap = 0;
+    } else if (array->entry_cap != array->count) {
+        new_entries = realloc(array->entries, array->count * sizeof(ArrayEntry));
+        if (new_entries != NULL) {
+            array->entries = new_entries;
+            array->entry_cap = array->count;
+        }
+    }
+    return true;
+}
+
+// 转换
+DString *dstr_join(const DStrArray *array, const DStrView separator) {
+    DString *joined;
+    char *out;
+    size_t total, i;
+
+    assert(array != NULL && (separator.data != NULL || separator.len == 0));
+
+    joined = dstr_create(NULL);
+    if (joined == NULL || array->count == 0) return joined;
+
+    // 先求出总长度，一次预留后直接写入字符串的空闲容量
+    total = 0;
+    for (i = 0; i < array->count; ++i) {
+        if (array->entries[i].len > SIZE_MAX - total ||
+            (i != 0 && separator.len > SIZE_MAX - total - array->entries[i].len)) {
+            dstr_destroy(joined);
+            return NULL;
+        }
+        total += array->entries[i].len + (i != 0 ? separator.len : 0);
+    }
+
+    out = dstr_prepare_append(joined, total);
+    if (out == NULL) {
+        dstr_destroy(joined);
+        return NULL;
+    }
+
+    for (i = 0; i < array->count; ++i) {
+        if (i != 0 && separator.len != 0) {
+            memcpy(out, separator.data, separator.len);
+            out += separator.len;
+        }
+        if (array->entries[i].len != 0) {
+            memcpy(out, array->blob + array->entries[i].offset, array->entries[i].len);
+            out += array->entries[i].len;
+        }
+    }
+
+    dstr_commit_append(joined, total);
+    return joined;
+}
@@ -0,0 +1,187 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_gap_buffer.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 初始容量下限
+#define GAP_MIN_CAP 64
+
+// 内容为 buf[0, gap_start) 与 buf[gap_end, cap)，间隙至少保留 1 字节以便写入 '\0'
+struct DStrGapBuffer {
+    char *buf;
+    size_t cap;
+    size_t gap_start;
+    size_t gap_end;
+    size_t cursor; // 逻辑光标，可能与间隙位置不同（间隙被移到末尾之后）
+};
+
+static inline size_t gap_length(const DStrGapBuffer *gap) {
+    return gap->cap - (gap->gap_end - gap->gap_start);
+}
+
+// 将间隙移到逻辑位置 index，耗时与移动距离成正比
+static void gap_move(DStrGapBuffer *gap, const size_t index) {
+    size_t distance;
+
+    if (index < gap->gap_start) {
+        distance = gap->gap_start - index;
+        memmove(gap->buf + gap->gap_end - distance, gap->buf + index, distance);
+        gap->gap_start -= distance;
+        gap->gap_end -= distance;
+    } else if (index > gap->gap_start) {
+        distance = index - gap->gap_start;
+        memmove(gap->buf + gap->gap_start, gap->buf + gap->gap_end, distance);
+        gap->gap_start += distance;
+        gap->gap_end += distance;
+    }
+}
+
+// 确保间隙至少为 needed + 1 字节，不足时按倍扩容
+static bool gap_reserve(DStrGapBuffer *gap, const size_t needed) {
+    char *new_buf;
+    size_t new_cap, tail_len;
+
+    if (gap->gap_end - gap->gap_start > needed) return true;
+
+    new_cap = gap->cap * 2;
+    if (new_cap - gap_length(gap) <= needed) new_cap = gap_length(gap) + needed + 1;
+
+    new_buf = realloc(gap->buf, new_cap);
+    if (new_buf == NULL) return false;
+
+    // 间隙之后的内容挪到新缓冲的末尾
+    tail_len = gap->cap - gap->gap_end;
+    memmove(new_buf + new_cap - tail_len, new_buf + gap->gap_end, tail_len);
+
+    gap->buf = new_buf;
+    gap->gap_end = new_cap - tail_len;
+    gap->cap = new_cap;
+    return true;
+}
+
+// 创建、销毁
+DStrGapBuffer *dstr_gap_create(const DStrView initial) {
+    DStrGapBuffer *gap;
+
+    assert(initial.data != NULL || initial.len == 0);
+
+    gap = malloc(sizeof(DStrGapBuffer));
+    if (gap == NULL) return NULL;
+
+    gap->cap = initial.len < GAP_MIN_CAP / 2 ? GAP_MIN_CAP : initial.len * 2;
+    gap->buf = malloc(gap->cap);
+    if (gap->buf == NULL) {
+        free(gap);
+        return NULL;
+    }
+
+    if (initial.len != 0) memcpy(gap->buf, initial.data, initial.len);
+    gap->gap_start = initial.len;
+    gap->gap_end = gap->cap;
+    gap->cursor = initial.len;
+    return gap;
+}
+
+void dstr_gap_destroy(DStrGapBuffer *gap) {
+    assert(gap != NULL);
+
+    free(gap->buf);
+    free(gap);
+}
+
+// 属性获取
+size_t dstr_gap_length(const DStrGapBuffer *gap) {
+    assert(gap != NULL);
+
+    return gap_length(gap);
+}
+
+char dstr_gap_at(const DStrGapBuffer *gap, const size_t index) {
+    assert(gap != NULL && index < gap_length(gap));
+
+    return index < gap->gap_start
+               ? gap->buf[index]
+               : gap->buf[index + gap->gap_end - gap->gap_start];
+}
+
+// 光标
+size_t dstr_gap_cursor(const DStrGapBuffer *gap) {
+    assert(gap != NULL);
+
+    return gap->cursor;
+}
+
+bool dstr_gap_set_cursor(DStrGapBuffer *gap, const size_t index) {
+    assert(gap != NULL);
+
+    if (index > gap_length(gap)) return false;
+
+    gap->cursor = index;
+    return true;
+}
+
+// 编辑
+bool dstr_gap_insert(DStrGapBuffer *gap, const DStrView src) {
+    assert(gap != NULL && (src.data != NULL || src.len == 0));
+
+    if (src.len == 0) return false;
+    if (!gap_reserve(gap, src.len)) return false;
+
+    gap_move(gap, gap->cursor);
+    memcpy(gap->buf + gap->gap_start, src.data, src.len);
+    gap->gap_start += src.len;
+    gap->cursor += src.len;
+    return true;
+}
+
+size_t dstr_gap_delete_backward(DStrGapBuffer *gap, size_t count) {
+    assert(gap != NULL);
+
+    if (count > gap->cursor) count = gap->cursor;
+
+    gap_move(gap, gap->cursor);
+    gap->gap_start -= count;
+    gap->cursor -= count;
+    return count;
+}
+
+size_t dstr_gap_delete_forward(DStrGapBuffer *gap, size_t count) {
+    assert(gap != NULL);
+
+    if (count > gap_length(gap) - gap->cursor) count = gap_length(gap) - gap->cursor;
+
+    gap_move(gap, gap->cursor);
+    gap->gap_end += count;
+    return count;
+}
+
+// 连续访问
+const char *dstr_gap_cstr(DStrGapBuffer *gap) {
+    assert(gap != NULL);
+
+    gap_move(gap, gap_length(gap));
+    gap->buf[gap->gap_start] = '\0';
+    return gap->buf;
+}
+
+DStrView dstr_gap_view(DStrGapBuffer *gap) {
+    assert(gap != NULL);
+
+    return (DStrView){dstr_gap_cstr(gap), gap_length(gap)};
+}
+
+bool dstr_gap_find(DStrGapBuffer *gap, const DStrView sub, size_t *out_index, const bool backward) {
+    assert(gap != NULL && out_index != NULL);
+
+    return dstr_view_find(dstr_gap_view(gap), sub, out_index, backward);
+}
+
+DString *dstr_gap_to_dstr(DStrGapBuffer *gap) {
+    assert(gap != NULL);
+
+    return dstr_create_n(dstr_gap_cstr(gap), gap_length(gap));
+}
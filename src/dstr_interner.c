@@ -0,0 +1,210 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_interner.h"
+#include "dstr_threads.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 分片数量（2 的幂），以哈希值的高位选择分片、低位在分片内探测，二者互不相关
+#define INTERNER_SHARD_BITS 6
+#define INTERNER_SHARD_COUNT ((size_t) 1 << INTERNER_SHARD_BITS)
+#define INTERNER_MIN_CAP 16
+
+typedef struct InternSlot {
+    uint64_t hash;
+    const DString *str; // NULL 表示空槽
+} InternSlot;
+
+// 线性探测的开放寻址表，容量为 2 的幂，装载率不超过 3/4；驻留表不支持删除，因此无需墓碑
+typedef struct InternShard {
+    DStrMutex lock;
+    InternSlot *slots;
+    size_t cap;
+    size_t count;
+} InternShard;
+
+struct DStrInterner {
+    InternShard shards[INTERNER_SHARD_COUNT];
+};
+
+// 在分片中查找，返回命中的槽或应插入的空槽
+static InternSlot *shard_probe(const InternShard *shard, const uint64_t hash, const char *data, const size_t len) {
+    InternSlot *slot;
+    size_t mask, i;
+
+    mask = shard->cap - 1;
+    for (i = (size_t) hash & mask;; i = (i + 1) & mask) {
+        slot = &shard->slots[i];
+        if (slot->str == NULL) return slot;
+        if (slot->hash == hash && dstr_length(slot->str) == len &&
+            (len == 0 || memcmp(dstr_cstr(slot->str), data, len) == 0)) {
+            return slot;
+        }
+    }
+}
+
+// 容量翻倍并重新散列，已驻留的字符串本身不移动
+static bool shard_grow(InternShard *shard) {
+    InternSlot *old_slots, *slot;
+    size_t old_cap, new_cap, mask, i, j;
+
+    old_slots = shard->slots;
+    old_cap = shard->cap;
+    new_cap = old_cap != 0 ? old_cap * 2 : INTERNER_MIN_CAP;
+
+    shard->slots = calloc(new_cap, sizeof(InternSlot));
+    if (shard->slots == NULL) {
+        shard->slots = old_slots;
+        return false;
+    }
+    shard->cap = new_cap;
+
+    mask = new_cap - 1;
+    for (i = 0; i < old_cap; ++i) {
+        slot = &old_slots[i];
+        if (slot->str == NULL) continue;
+        for (j = (size_t) slot->hash & mask; shard->slots[j].str != NULL; j = (j + 1) & mask) {}
+        shard->slots[j] = *slot;
+    }
+    free(old_slots);
+    return true;
+}
+
+static inline InternShard *shard_of(DStrInterner *interner, const uint64_t hash) {
+    return &interner->shards[hash >> (64 - INTERNER_SHARD_BITS)];
+}
+
+// 复制 view 为单次分配的字符串，驻留后不再修改，不需要额外的增长空间
+// 发布前先计算一次哈希，此后各线程调用 dstr_hash 只读取缓存
+static DString *intern_copy(const DStrView view) {
+    DString *str;
+
+    str = dstr_create_packed(NULL, view.len + 1);
+    if (str == NULL) return NULL;
+    if (view.len != 0 && !dstr_cat_view(str, view)) {
+        dstr_destroy(str);
+        return NULL;
+    }
+    dstr_hash(str);
+    return str;
+}
+
+// 创建、销毁
+DStrInterner *dstr_interner_create(void) {
+    DStrInterner *interner;
+    size_t i;
+
+    interner = calloc(1, sizeof(DStrInterner));
+    if (interner == NULL) return NULL;
+
+    for (i = 0; i < INTERNER_SHARD_COUNT; ++i) {
+        if (!dstr_mutex_init(&interner->shards[i].lock)) {
+            while (i-- > 0) dstr_mutex_destroy(&interner->shards[i].lock);
+            free(interner);
+            return NULL;
+        }
+    }
+    return interner;
+}
+
+void dstr_interner_destroy(DStrInterner *interner) {
+    InternShard *shard;
+    size_t i, j;
+
+    assert(interner != NULL);
+
+    for (i = 0; i < INTERNER_SHARD_COUNT; ++i) {
+        shard = &interner->shards[i];
+        for (j = 0; j < shard->cap; ++j) {
+            if (shard->slots[j].str != NULL) dstr_destroy((DString *) shard->slots[j].str);
+        }
+        free(shard->slots);
+        dstr_mutex_destroy(&shard->lock);
+    }
+    free(interner);
+}
+
+// 驻留与查询
+const DString *dstr_intern(DStrInterner *interner, const DStrView view) {
+    InternShard *shard;
+    InternSlot *slot;
+    DString *str;
+    uint64_t hash;
+
+    assert(interner != NULL && (view.data != NULL || view.len == 0));
+
+    hash = dstr_hash_view(view);
+    shard = shard_of(interner, hash);
+
+    dstr_mutex_lock(&shard->lock);
+    if (shard->cap == 0 && !shard_grow(shard)) {
+        dstr_mutex_unlock(&shard->lock);
+        return NULL;
+    }
+
+    // 解锁后槽数组可能被其他线程扩容释放，须在锁内取出结果
+    slot = shard_probe(shard, hash, view.data, view.len);
+    if (slot->str != NULL) {
+        str = (DString *) slot->str;
+        dstr_mutex_unlock(&shard->lock);
+        return str;
+    }
+
+    // 先扩容再插入，扩容后空槽的位置会变化
+    if ((shard->count + 1) * 4 > shard->cap * 3) {
+        if (!shard_grow(shard)) {
+            dstr_mutex_unlock(&shard->lock);
+            return NULL;
+        }
+        slot = shard_probe(shard, hash, view.data, view.len);
+    }
+
+    str = intern_copy(view);
+    if (str != NULL) {
+        slot->hash = hash;
+        slot->str = str;
+        ++shard->count;
+    }
+    dstr_mutex_unlock(&shard->lock);
+    return str;
+}
+
+const DString *dstr_intern_cstr(DStrInterner *interner, const char *cstr) {
+    assert(interner != NULL && cstr != NULL);
+
+    return dstr_intern(interner, dstr_view_cstr(cstr));
+}
+
+const DString *dstr_interner_lookup(DStrInterner *interner, const DStrView view) {
+    InternShard *shard;
+    const DString *str;
+    uint64_t hash;
+
+    assert(interner != NULL && (view.data != NULL || view.len == 0));
+
+    hash = dstr_hash_view(view);
+    shard = shard_of(interner, hash);
+
+    dstr_mutex_lock(&shard->lock);
+    str = shard->cap != 0 ? shard_probe(shard, hash, view.data, view.len)->str : NULL;
+    dstr_mutex_unlock(&shard->lock);
+    return str;
+}
+
+// 属性获取
+size_t dstr_interner_count(DStrInterner *interner) {
+    size_t i, count;
+
+    assert(interner != NULL);
+
+    for (count = 0, i = 0; i < INTERNER_SHARD_COUNT; ++i) {
+        dstr_mutex_lock(&interner->shards[i].lock);
+        count += interner->shards[i].count;
+        dstr_mutex_unlock(&interner->shards[i].lock);
+    }
+    return count;
+}
@@ -0,0 +1,383 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_map.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (COMPILER_GCC || COMPILER_CLANG) && defined(__SSE2__)
+#  define MAP_HAS_SSE2 1
+#  include <emmintrin.h>
+#else
+#  define MAP_HAS_SSE2 0
+#endif
+
+// 一组控制字节的数量，容量始终是它的整数倍
+#define MAP_GROUP_WIDTH 16
+#define MAP_NPOS SIZE_MAX
+
+// 控制字节：最高位为 1 表示空闲（空或已删除），否则低 7 位为哈希值的 h2
+#define CTRL_EMPTY ((signed char) -128)
+#define CTRL_DELETED ((signed char) -2)
+
+typedef struct MapSlot {
+    DString *key;
+    void *value;
+} MapSlot;
+
+// 槽位与控制字节位于同一次分配中；控制字节比容量多 MAP_GROUP_WIDTH 个，
+// 末尾一组镜像开头一组，使从任意位置读取一整组都不必回绕
+struct DStrMap {
+    MapSlot *slots;
+    signed char *ctrl;
+    size_t cap; // 0 或 2 的幂（不小于 MAP_GROUP_WIDTH）
+    size_t size;
+    size_t growth_left; // 不触发重建还能占用的空槽数，已删除的槽位不计入
+};
+
+// 哈希值的高 57 位决定探测起点，低 7 位存入控制字节用于过滤
+static inline size_t hash_h1(const uint64_t hash) {
+    return (size_t) (hash >> 7);
+}
+
+static inline signed char hash_h2(const uint64_t hash) {
+    return (signed char) (hash & 0x7f);
+}
+
+// 装载率上限为 7/8
+static inline size_t cap_growth(const size_t cap) {
+    return cap - cap / 8;
+}
+
+static size_t cap_for(const size_t count) {
+    size_t cap;
+
+    for (cap = MAP_GROUP_WIDTH; cap_growth(cap) < count; cap *= 2) {}
+    return cap;
+}
+
+static inline unsigned mask_lowest(unsigned mask) {
+#if COMPILER_GCC || COMPILER_CLANG
+    return (unsigned) __builtin_ctz(mask);
+#else
+    unsigned bit;
+
+    for (bit = 0; (mask & 1u) == 0; mask >>= 1) ++bit;
+    return bit;
+#endif
+}
+
+static inline unsigned mask_highest(unsigned mask) {
+#if COMPILER_GCC || COMPILER_CLANG
+    return (unsigned) (sizeof(unsigned) * 8 - 1 - __builtin_clz(mask));
+#else
+    unsigned bit;
+
+    for (bit = 0; mask > 1; mask >>= 1) ++bit;
+    return bit;
+#endif
+}
+
+// 组内匹配：返回位掩码，第 i 位对应 group[i]
+#if MAP_HAS_SSE2
+static inline unsigned group_match(const signed char *group, const signed char h2) {
+    const __m128i ctrl = _mm_loadu_si128((const __m128i *) group);
+
+    return (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));
+}
+
+static inline unsigned group_match_empty(const signed char *group) {
+    return group_match(group, CTRL_EMPTY);
+}
+
+static inline unsigned group_match_free(const signed char *group) {
+    return (unsigned) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) group));
+}
+#else
+static inline unsigned group_match(const signed char *group, const signed char h2) {
+    unsigned mask, i;
+
+    for (mask = 0, i = 0; i < MAP_GROUP_WIDTH; ++i) {
+        if (group[i] == h2) mask |= 1u << i;
+    }
+    return mask;
+}
+
+static inline unsigned group_match_empty(const signed char *group) {
+    return group_match(group, CTRL_EMPTY);
+}
+
+static inline unsigned group_match_free(const signed char *group) {
+    unsigned mask, i;
+
+    for (mask = 0, i = 0; i < MAP_GROUP_WIDTH; ++i) {
+        if (group[i] < 0) mask |= 1u << i;
+    }
+    return mask;
+}
+#endif // MAP_HAS_SSE2
+
+static inline void set_ctrl(const DStrMap *map, const size_t index, const signed char value) {
+    map->ctrl[index] = value;
+    if (index < MAP_GROUP_WIDTH) map->ctrl[map->cap + index] = value;
+}
+
+// 键在插入时已缓存哈希值，这里先比较完整哈希再比较内容
+static inline bool key_equals(const DString *key, const uint64_t hash, const DStrView view) {
+    return dstr_length(key) == view.len && dstr_hash(key) == hash &&
+           (view.len == 0 || memcmp(dstr_cstr(key), view.data, view.len) == 0);
+}
+
+// 按组进行三角探测，返回键所在的槽位，不存在时返回 MAP_NPOS
+static size_t map_find(const DStrMap *map, const uint64_t hash, const DStrView key) {
+    size_t mask, pos, stride, index;
+    unsigned match;
+
+    if (map->cap == 0) return MAP_NPOS;
+
+    mask = map->cap - 1;
+    for (pos = hash_h1(hash) & mask, stride = 0;; pos = (pos + (stride += MAP_GROUP_WIDTH)) & mask) {
+        for (match = group_match(map->ctrl + pos, hash_h2(hash)); match != 0; match &= match - 1) {
+            index = (pos + mask_lowest(match)) & mask;
+            if (key_equals(map->slots[index].key, hash, key)) return index;
+        }
+        // 组内有空槽说明插入时不会探测得更远
+        if (group_match_empty(map->ctrl + pos) != 0) return MAP_NPOS;
+    }
+}
+
+// 沿探测序列返回第一个空闲（空或已删除）的槽位，表中必须至少有一个空槽
+static size_t map_find_free(const DStrMap *map, const uint64_t hash) {
+    size_t mask, pos, stride;
+    unsigned match;
+
+    mask = map->cap - 1;
+    for (pos = hash_h1(hash) & mask, stride = 0;; pos = (pos + (stride += MAP_GROUP_WIDTH)) & mask) {
+        match = group_match_free(map->ctrl + pos);
+        if (match != 0) return (pos + mask_lowest(match)) & mask;
+    }
+}
+
+// 以 new_cap 重建，同时清除已删除标记；键的哈希值已缓存，不需要重新计算
+static bool map_rehash(DStrMap *map, const size_t new_cap) {
+    DStrMap fresh;
+    size_t i, index;
+    uint64_t hash;
+
+    fresh.slots = malloc(new_cap * sizeof(MapSlot) + new_cap + MAP_GROUP_WIDTH);
+    if (fresh.slots == NULL) return false;
+    fresh.ctrl = (signed char *) (fresh.slots + new_cap);
+    fresh.cap = new_cap;
+    fresh.size = map->size;
+    fresh.growth_left = cap_growth(new_cap) - map->size;
+    memset(fresh.ctrl, CTRL_EMPTY, new_cap + MAP_GROUP_WIDTH);
+
+    for (i = 0; i < map->cap; ++i) {
+        if (map->ctrl[i] < 0) continue;
+        hash = dstr_hash(map->slots[i].key);
+        index = map_find_free(&fresh, hash);
+        set_ctrl(&fresh, index, hash_h2(hash));
+        fresh.slots[index] = map->slots[i];
+    }
+
+    free(map->slots);
+    *map = fresh;
+    return true;
+}
+
+// 插入一个确定不存在的键，失败时不改变表
+static bool map_insert_new(DStrMap *map, const uint64_t hash, DString *key, void *value) {
+    size_t index;
+
+    index = map->cap != 0 ? map_find_free(map, hash) : MAP_NPOS;
+
+    // 只有占用空槽才消耗余量；余量耗尽时重建，已删除的槽位较多时容量不变
+    if (index == MAP_NPOS || (map->ctrl[index] == CTRL_EMPTY && map->growth_left == 0)) {
+        if (!map_rehash(map, cap_for(map->size + 1))) return false;
+        index = map_find_free(map, hash);
+    }
+
+    if (map->ctrl[index] == CTRL_EMPTY) --map->growth_left;
+    set_ctrl(map, index, hash_h2(hash));
+    map->slots[index] = (MapSlot){key, value};
+    ++map->size;
+    return true;
+}
+
+// 以 key 的副本插入，hash 为 key 内容的哈希值
+static bool map_put(DStrMap *map, const uint64_t hash, const DStrView key, const DString *source, void *value) {
+    DString *copy;
+    size_t index;
+
+    index = map_find(map, hash, key);
+    if (index != MAP_NPOS) {
+        map->slots[index].value = value;
+        return true;
+    }
+
+    copy = source != NULL ? dstr_clone(source) : dstr_create_n(key.data, key.len);
+    if (copy == NULL) return false;
+    dstr_hash(copy);
+
+    if (!map_insert_new(map, hash, copy, value)) {
+        dstr_destroy(copy);
+        return false;
+    }
+    return true;
+}
+
+static bool map_get(const DStrMap *map, const uint64_t hash, const DStrView key, void **out_value) {
+    size_t index;
+
+    index = map_find(map, hash, key);
+    if (index == MAP_NPOS) return false;
+
+    if (out_value != NULL) *out_value = map->slots[index].value;
+    return true;
+}
+
+// 创建、销毁、清空
+DStrMap *dstr_map_create(void) {
+    DStrMap *map;
+
+    map = malloc(sizeof(DStrMap));
+    if (map == NULL) return NULL;
+
+    *map = (DStrMap){0};
+    return map;
+}
+
+void dstr_map_destroy(DStrMap *map) {
+    assert(map != NULL);
+
+    dstr_map_clear(map);
+    free(map->slots);
+    free(map);
+}
+
+void dstr_map_clear(DStrMap *map) {
+    size_t i;
+
+    assert(map != NULL);
+
+    if (map->cap == 0) return;
+
+    for (i = 0; i < map->cap; ++i) {
+        if (map->ctrl[i] >= 0) dstr_destroy(map->slots[i].key);
+    }
+    memset(map->ctrl, CTRL_EMPTY, map->cap + MAP_GROUP_WIDTH);
+    map->size = 0;
+    map->growth_left = cap_growth(map->cap);
+}
+
+// 属性获取与容量
+size_t dstr_map_size(const DStrMap *map) {
+    assert(map != NULL);
+
+    return map->size;
+}
+
+bool dstr_map_reserve(DStrMap *map, const size_t count) {
+    size_t cap;
+
+    assert(map != NULL);
+
+    if (count <= map->size + map->growth_left) return true;
+
+    cap = cap_for(count);
+    return cap <= map->cap || map_rehash(map, cap);
+}
+
+// 插入
+bool dstr_map_put(DStrMap *map, const DStrView key, void *value) {
+    assert(map != NULL && (key.data != NULL || key.len == 0));
+
+    return map_put(map, dstr_hash_view(key), key, NULL, value);
+}
+
+bool dstr_map_put_cstr(DStrMap *map, const char *key, void *value) {
+    assert(map != NULL && key != NULL);
+
+    return dstr_map_put(map, dstr_view_cstr(key), value);
+}
+
+bool dstr_map_put_dstr(DStrMap *map, const DString *key, void *value) {
+    assert(map != NULL && key != NULL);
+
+    return map_put(map, dstr_hash(key), dstr_view(key), key, value);
+}
+
+// 查找
+bool dstr_map_get(const DStrMap *map, const DStrView key, void **out_value) {
+    assert(map != NULL && (key.data != NULL || key.len == 0));
+
+    return map_get(map, dstr_hash_view(key), key, out_value);
+}
+
+bool dstr_map_get_cstr(const DStrMap *map, const char *key, void **out_value) {
+    assert(map != NULL && key != NULL);
+
+    return dstr_map_get(map, dstr_view_cstr(key), out_value);
+}
+
+bool dstr_map_get_dstr(const DStrMap *map, const DString *key, void **out_value) {
+    assert(map != NULL && key != NULL);
+
+    return map_get(map, dstr_hash(key), dstr_view(key), out_value);
+}
+
+// 删除
+bool dstr_map_remove(DStrMap *map, const DStrView key, void **out_value) {
+    size_t index, mask;
+    unsigned empty_before, empty_after;
+
+    assert(map != NULL && (key.data != NULL || key.len == 0));
+
+    index = map_find(map, dstr_hash_view(key), key);
+    if (index == MAP_NPOS) return false;
+
+    if (out_value != NULL) *out_value = map->slots[index].value;
+    dstr_destroy(map->slots[index].key);
+    --map->size;
+
+    // 若包含该槽位的任意一组窗口内都有空槽，说明没有探测序列越过它，可直接标记为空
+    mask = map->cap - 1;
+    empty_before = group_match_empty(map->ctrl + ((index - MAP_GROUP_WIDTH) & mask));
+    empty_after = group_match_empty(map->ctrl + index);
+    if (empty_before != 0 && empty_after != 0 &&
+        mask_lowest(empty_after) + (MAP_GROUP_WIDTH - 1 - mask_highest(empty_before)) < MAP_GROUP_WIDTH) {
+        set_ctrl(map, index, CTRL_EMPTY);
+        ++map->growth_left;
+    } else {
+        set_ctrl(map, index, CTRL_DELETED);
+    }
+    return true;
+}
+
+// 遍历
+void dstr_map_iter_init(DStrMapIter *iter, const DStrMap *map) {
+    assert(iter != NULL && map != NULL);
+
+    iter->map = map;
+    iter->index = 0;
+}
+
+bool dstr_map_iter_next(DStrMapIter *iter, const DString **out_key, void **out_value) {
+    const DStrMap *map;
+
+    assert(iter != NULL);
+
+    map = iter->map;
+    for (; iter->index < map->cap; ++iter->index) {
+        if (map->ctrl[iter->index] < 0) continue;
+
+        if (out_key != NULL) *out_key = map->slots[iter->index].key;
+        if (out_value != NULL) *out_value = map->slots[iter->index].value;
+        ++iter->index;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,324 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_matcher.h"
+#include "dstr_matcher_internal.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 转移目标的最高位标记「到达该状态时有模式结束」，扫描时无需再查输出表
+#define MATCHER_EMIT 0x80000000u
+#define MATCHER_STATE_MASK 0x7fffffffu
+#define MATCHER_NONE UINT32_MAX
+
+struct DStrMatcher {
+    uint32_t *delta;        // state_count × class_count 的稠密转移表
+    uint32_t *output;       // 恰好在该状态结束的第一个模式
+    uint32_t *dict;         // 沿失败链最近的、有模式结束的状态
+    uint32_t *pattern_next; // 在同一状态结束的下一个（重复的）模式
+    uint32_t *depth;        // 状态在字典树中的深度，即其对应前缀的长度
+    size_t *lengths;
+    size_t pattern_count;
+    size_t state_count;
+    size_t class_count;
+    unsigned char byte_class[UCHAR_MAX + 1];
+};
+
+// 构造
+// 为出现在模式中的字节分配等价类，其余字节统一为 0 类
+static void matcher_build_classes(DStrMatcher *matcher, const char *const *patterns, const size_t *lengths) {
+    bool used[UCHAR_MAX + 1] = {false};
+    size_t i, j;
+
+    for (i = 0; i < matcher->pattern_count; ++i) {
+        for (j = 0; j < lengths[i]; ++j) {
+            used[(unsigned char) patterns[i][j]] = true;
+        }
+    }
+
+    matcher->class_count = 1;
+    for (i = 0; i <= UCHAR_MAX; ++i) {
+        matcher->byte_class[i] = used[i] ? (unsigned char) matcher->class_count++ : 0;
+    }
+}
+
+// 构造字典树，此阶段转移为 0 表示没有边（根状态不会成为子状态）
+static bool matcher_build_trie(DStrMatcher *matcher, const char *const *patterns, const size_t *lengths) {
+    uint32_t *new_delta, *new_output, *new_depth;
+    size_t state_cap, total_len, i, j, state, cls;
+
+    for (total_len = 1, i = 0; i < matcher->pattern_count; ++i) total_len += lengths[i];
+    if (total_len > MATCHER_STATE_MASK) return false;
+
+    // 状态数不超过模式总长 + 1，先按较小的容量分配，不足时翻倍
+    state_cap = total_len < 64 ? total_len : 64;
+    matcher->delta = calloc(state_cap * matcher->class_count, sizeof(uint32_t));
+    matcher->output = malloc(state_cap * sizeof(uint32_t));
+    matcher->depth = malloc(state_cap * sizeof(uint32_t));
+    if (matcher->delta == NULL || matcher->output == NULL || matcher->depth == NULL) return false;
+
+    matcher->output[0] = MATCHER_NONE;
+    matcher->depth[0] = 0;
+    matcher->state_count = 1;
+
+    for (i = 0; i < matcher->pattern_count; ++i) {
+        matcher->pattern_next[i] = MATCHER_NONE;
+        if (lengths[i] == 0) continue;
+
+        for (state = 0, j = 0; j < lengths[i]; ++j) {
+            cls = matcher->byte_class[(unsigned char) patterns[i][j]];
+            if (matcher->delta[state * matcher->class_count + cls] == 0) {
+                if (matcher->state_count == state_cap) {
+                    state_cap = state_cap * 2 < total_len ? state_cap * 2 : total_len;
+                    new_delta = realloc(matcher->delta, state_cap * matcher->class_count * sizeof(uint32_t));
+                    if (new_delta == NULL) return false;
+                    matcher->delta = new_delta;
+                    new_output = realloc(matcher->output, state_cap * sizeof(uint32_t));
+                    if (new_output == NULL) return false;
+                    matcher->output = new_output;
+                    new_depth = realloc(matcher->depth, state_cap * sizeof(uint32_t));
+                    if (new_depth == NULL) return false;
+                    matcher->depth = new_depth;
+                    memset(matcher->delta + matcher->state_count * matcher->class_count, 0,
+                           (state_cap - matcher->state_count) * matcher->class_count * sizeof(uint32_t));
+                }
+                matcher->output[matcher->state_count] = MATCHER_NONE;
+                matcher->depth[matcher->state_count] = (uint32_t) (j + 1);
+                matcher->delta[state * matcher->class_count + cls] = (uint32_t) matcher->state_count++;
+            }
+            state = matcher->delta[state * matcher->class_count + cls];
+        }
+
+        // 重复的模式挂在同一状态的链表末尾，保持构造时的顺序
+        if (matcher->output[state] == MATCHER_NONE) {
+            matcher->output[state] = (uint32_t) i;
+        } else {
+            j = matcher->output[state];
+            while (matcher->pattern_next[j] != MATCHER_NONE) j = matcher->pattern_next[j];
+            matcher->pattern_next[j] = (uint32_t) i;
+        }
+    }
+
+    return true;
+}
+
+// 按广度优先计算失败链，并把字典树补全为完整的确定性自动机
+static bool matcher_build_links(DStrMatcher *matcher) {
+    uint32_t *fail, *queue;
+    size_t head, tail, state, child, fail_child, cls, k;
+
+    k = matcher->class_count;
+    fail = malloc(matcher->state_count * sizeof(uint32_t));
+    queue = malloc(matcher->state_count * sizeof(uint32_t));
+    matcher->dict = malloc(matcher->state_count * sizeof(uint32_t));
+    if (fail == NULL || queue == NULL || matcher->dict == NULL) {
+        free(fail);
+        free(queue);
+        return false;
+    }
+
+    fail[0] = 0;
+    matcher->dict[0] = MATCHER_NONE;
+    head = tail = 0;
+    queue[tail++] = 0;
+
+    while (head < tail) {
+        state = queue[head++];
+        for (cls = 0; cls < k; ++cls) {
+            child = matcher->delta[state * k + cls];
+            if (child != 0) {
+                fail_child = state == 0 ? 0 : matcher->delta[fail[state] * k + cls] & MATCHER_STATE_MASK;
+                fail[child] = (uint32_t) fail_child;
+                matcher->dict[child] = matcher->output[fail_child] != MATCHER_NONE
+                                           ? (uint32_t) fail_child
+                                           : matcher->dict[fail_child];
+                queue[tail++] = (uint32_t) child;
+            } else {
+                matcher->delta[state * k + cls] = state == 0 ? 0 : matcher->delta[fail[state] * k + cls];
+            }
+        }
+    }
+
+    // 标记有输出的目标状态
+    for (state = 0; state < matcher->state_count * k; ++state) {
+        child = matcher->delta[state] & MATCHER_STATE_MASK;
+        if (matcher->output[child] != MATCHER_NONE || matcher->dict[child] != MATCHER_NONE) {
+            matcher->delta[state] = (uint32_t) child | MATCHER_EMIT;
+        }
+    }
+
+    free(fail);
+    free(queue);
+    return true;
+}
+
+DStrMatcher *dstr_matcher_create(const char *const *patterns, const size_t count) {
+    DStrMatcher *matcher;
+    size_t *lengths;
+    size_t i;
+
+    assert(patterns != NULL);
+
+    lengths = malloc((count != 0 ? count : 1) * sizeof(size_t));
+    if (lengths == NULL) return NULL;
+
+    for (i = 0; i < count; ++i) lengths[i] = strlen(patterns[i]);
+
+    matcher = dstr_matcher_create_n(patterns, lengths, count);
+    free(lengths);
+    return matcher;
+}
+
+DStrMatcher *dstr_matcher_create_n(const char *const *patterns, const size_t *lengths, const size_t count) {
+    DStrMatcher *matcher;
+
+    assert(patterns != NULL && lengths != NULL);
+
+    if (count >= MATCHER_NONE) return NULL;
+
+    matcher = calloc(1, sizeof(DStrMatcher));
+    if (matcher == NULL) return NULL;
+
+    matcher->pattern_count = count;
+    matcher->lengths = malloc((count != 0 ? count : 1) * sizeof(size_t));
+    matcher->pattern_next = malloc((count != 0 ? count : 1) * sizeof(uint32_t));
+    if (matcher->lengths == NULL || matcher->pattern_next == NULL) {
+        dstr_matcher_destroy(matcher);
+        return NULL;
+    }
+    memcpy(matcher->lengths, lengths, count * sizeof(size_t));
+
+    matcher_build_classes(matcher, patterns, lengths);
+    if (!matcher_build_trie(matcher, patterns, lengths) || !matcher_build_links(matcher)) {
+        dstr_matcher_destroy(matcher);
+        return NULL;
+    }
+
+    return matcher;
+}
+
+void dstr_matcher_destroy(DStrMatcher *matcher) {
+    assert(matcher != NULL);
+
+    free(matcher->delta);
+    free(matcher->output);
+    free(matcher->dict);
+    free(matcher->pattern_next);
+    free(matcher->depth);
+    free(matcher->lengths);
+    free(matcher);
+}
+
+size_t dstr_matcher_pattern_count(const DStrMatcher *matcher) {
+    assert(matcher != NULL);
+
+    return matcher->pattern_count;
+}
+
+// 匹配
+// 报告在 end（不含）处结束的所有匹配，回调要求停止时返回 false
+static bool matcher_emit(const DStrMatcher *matcher, size_t state, const size_t end, size_t *match_count,
+                         const DStrMatchCallback callback, void *ctx) {
+    DStrMatch match;
+    size_t pattern;
+
+    if (matcher->output[state] == MATCHER_NONE) state = matcher->dict[state];
+
+    for (; state != MATCHER_NONE; state = matcher->dict[state]) {
+        for (pattern = matcher->output[state]; pattern != MATCHER_NONE; pattern = matcher->pattern_next[pattern]) {
+            ++*match_count;
+            if (callback != NULL) {
+                match.pattern = pattern;
+                match.index = end - matcher->lengths[pattern];
+                if (!callback(&match, ctx)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 扫描 data，callback 为 NULL 时只计数；stop_at_first 为真时在第一个有输出的位置停止
+static size_t matcher_scan(const DStrMatcher *matcher, const unsigned char *data, const size_t len,
+                           const DStrMatchCallback callback, void *ctx, const bool stop_at_first) {
+    size_t match_count, i;
+    uint32_t state;
+
+    for (match_count = 0, state = 0, i = 0; i < len; ++i) {
+        state = matcher->delta[(state & MATCHER_STATE_MASK) * matcher->class_count + matcher->byte_class[data[i]]];
+        if (state & MATCHER_EMIT) {
+            if (!matcher_emit(matcher, state & MATCHER_STATE_MASK, i + 1, &match_count, callback, ctx) ||
+                stop_at_first) {
+                break;
+            }
+        }
+    }
+
+    return match_count;
+}
+
+size_t dstr_matcher_find_all(const DStrMatcher *matcher, const DString *dstr, const DStrMatchCallback callback,
+                             void *ctx) {
+    assert(matcher != NULL && dstr != NULL && callback != NULL);
+
+    return matcher_scan(matcher, (const unsigned char *) dstr_cstr(dstr), dstr_length(dstr), callback, ctx, false);
+}
+
+static bool take_first(const DStrMatch *match, void *ctx) {
+    *(DStrMatch *) ctx = *match;
+    return false;
+}
+
+bool dstr_matcher_find_first(const DStrMatcher *matcher, const DString *dstr, DStrMatch *out_match) {
+    assert(matcher != NULL && dstr != NULL && out_match != NULL);
+
+    return matcher_scan(matcher, (const unsigned char *) dstr_cstr(dstr), dstr_length(dstr),
+                        take_first, out_match, true) != 0;
+}
+
+bool dstr_matcher_contains_any(const DStrMatcher *matcher, const DString *dstr) {
+    assert(matcher != NULL && dstr != NULL);
+
+    return matcher_scan(matcher, (const unsigned char *) dstr_cstr(dstr), dstr_length(dstr),
+                        NULL, NULL, true) != 0;
+}
+
+static bool count_each(const DStrMatch *match, void *ctx) {
+    ++((size_t *) ctx)[match->pattern];
+    return true;
+}
+
+size_t dstr_matcher_count(const DStrMatcher *matcher, const DString *dstr, size_t *out_counts) {
+    assert(matcher != NULL && dstr != NULL && out_counts != NULL);
+
+    memset(out_counts, 0, matcher->pattern_count * sizeof(size_t));
+    return matcher_scan(matcher, (const unsigned char *) dstr_cstr(dstr), dstr_length(dstr),
+                        count_each, out_counts, false);
+}
+
+// 库内部接口
+bool dstr_matcher_longest_starts(const DStrMatcher *matcher, const char *data, const size_t len,
+                                 const DStrMatchCallback callback, void *ctx) {
+    DStrMatch match;
+    size_t i, state;
+    uint32_t next;
+
+    // 自动机由反转的模式构造，从后向前扫描时到达的状态对应以 i - 1 开始的子串，
+    // 状态自身或失败链上最近的输出即在此开始的最长模式
+    for (next = 0, i = len; i > 0; --i) {
+        next = matcher->delta[(next & MATCHER_STATE_MASK) * matcher->class_count +
+                              matcher->byte_class[(unsigned char) data[i - 1]]];
+        if (next & MATCHER_EMIT) {
+            state = next & MATCHER_STATE_MASK;
+            if (matcher->output[state] == MATCHER_NONE) state = matcher->dict[state];
+            match.pattern = matcher->output[state];
+            match.index = i - 1;
+            if (!callback(&match, ctx)) return false;
+        }
+    }
+
+    return true;
+}
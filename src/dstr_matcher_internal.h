@@ -0,0 +1,30 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_MATCHER_INTERNAL_H
+#define DSTR_MATCHER_INTERNAL_H
+
+/**
+ * @file dstr_matcher_internal.h
+ * @brief 多模式匹配器的库内部接口（不对外公开）
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "dstr_matcher.h"
+
+/**
+ * 从后向前扫描 data，matcher 须由各模式反转后构造。对每个有模式开始的位置，
+ * 按位置从大到小调用一次 callback，报告在此开始的最长模式（同一内容的模式取下标较小者），
+ * match.index 为该位置。整个扫描只读一遍 data，callback 返回 false 时停止并返回 false。
+ */
+bool dstr_matcher_longest_starts(
+    const DStrMatcher *matcher,
+    const char *data,
+    size_t len,
+    DStrMatchCallback callback,
+    void *ctx
+);
+
+#endif // DSTR_MATCHER_INTERNAL_H
@@ -0,0 +1,599 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_number.h"
+#include <assert.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dynamic_string.h"
+#include "portable_attributes.h"
+
+// 整数格式化
+// 两位一组查表，每次除法产出两位数字
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static size_t count_digits_u64(uint64_t value) {
+    size_t count;
+
+    for (count = 1; value >= 10000; value /= 10000) count += 4;
+    if (value >= 1000) return count + 3;
+    if (value >= 100) return count + 2;
+    if (value >= 10) return count + 1;
+    return count;
+}
+
+size_t dstr_number_format_u64(char *out, uint64_t value) {
+    size_t len, pos;
+    unsigned pair;
+
+    len = count_digits_u64(value);
+    for (pos = len; value >= 100;) {
+        pair = (unsigned) (value % 100) * 2;
+        value /= 100;
+        out[--pos] = digit_pairs[pair + 1];
+        out[--pos] = digit_pairs[pair];
+    }
+    if (value >= 10) {
+        out[1] = digit_pairs[value * 2 + 1];
+        out[0] = digit_pairs[value * 2];
+    } else {
+        out[0] = (char) ('0' + value);
+    }
+    return len;
+}
+
+size_t dstr_number_format_i64(char *out, const int64_t value) {
+    if (value >= 0) return dstr_number_format_u64(out, (uint64_t) value);
+
+    // 取绝对值时经由无符号运算，避免 INT64_MIN 溢出
+    out[0] = '-';
+    return 1 + dstr_number_format_u64(out + 1, 0 - (uint64_t) value);
+}
+
+// 浮点数格式化：Grisu2（Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers"）
+// 用 64 位整数近似 value 的上下边界，在两者之间生成尽可能少的数字，结果总能精确还原 value
+#define DOUBLE_SIGNIFICAND_BITS 52
+#define DOUBLE_HIDDEN_BIT ((uint64_t) 1 << DOUBLE_SIGNIFICAND_BITS)
+#define DOUBLE_EXPONENT_BIAS (0x3FF + DOUBLE_SIGNIFICAND_BITS)
+
+// 「尾数 × 2^e」形式的无符号浮点数
+typedef struct DiyFp {
+    uint64_t f;
+    int e;
+} DiyFp;
+
+// 10 的 -348 到 340 次幂（步长 8）的规格化近似值
+static const DiyFp cached_powers[] = {
+    {0xfa8fd5a0081c0288u, -1220}, // 1e-348
+    {0xbaaee17fa23ebf76u, -1193}, // 1e-340
+    {0x8b16fb203055ac76u, -1166}, // 1e-332
+    {0xcf42894a5dce35eau, -1140}, // 1e-324
+    {0x9a6bb0aa55653b2du, -1113}, // 1e-316
+    {0xe61acf033d1a45dfu, -1087}, // 1e-308
+    {0xab70fe17c79ac6cau, -1060}, // 1e-300
+    {0xff77b1fcbebcdc4fu, -1034}, // 1e-292
+    {0xbe5691ef416bd60cu, -1007}, // 1e-284
+    {0x8dd01fad907ffc3cu, -980}, // 1e-276
+    {0xd3515c2831559a83u, -954}, // 1e-268
+    {0x9d71ac8fada6c9b5u, -927}, // 1e-260
+    {0xea9c227723ee8bcbu, -901}, // 1e-252
+    {0xaecc49914078536du, -874}, // 1e-244
+    {0x823c12795db6ce57u, -847}, // 1e-236
+    {0xc21094364dfb5637u, -821}, // 1e-228
+    {0x9096ea6f3848984fu, -794}, // 1e-220
+    {0xd77485cb25823ac7u, -768}, // 1e-212
+    {0xa086cfcd97bf97f4u, -741}, // 1e-204
+    {0xef340a98172aace5u, -715}, // 1e-196
+    {0xb23867fb2a35b28eu, -688}, // 1e-188
+    {0x84c8d4dfd2c63f3bu, -661}, // 1e-180
+    {0xc5dd44271ad3cdbau, -635}, // 1e-172
+    {0x936b9fcebb25c996u, -608}, // 1e-164
+    {0xdbac6c247d62a584u, -582}, // 1e-156
+    {0xa3ab66580d5fdaf6u, -555}, // 1e-148
+    {0xf3e2f893dec3f126u, -529}, // 1e-140
+    {0xb5b5ada8aaff80b8u, -502}, // 1e-132
+    {0x87625f056c7c4a8bu, -475}, // 1e-124
+    {0xc9bcff6034c13053u, -449}, // 1e-116
+    {0x964e858c91ba2655u, -422}, // 1e-108
+    {0xdff9772470297ebdu, -396}, // 1e-100
+    {0xa6dfbd9fb8e5b88fu, -369}, // 1e-92
+    {0xf8a95fcf88747d94u, -343}, // 1e-84
+    {0xb94470938fa89bcfu, -316}, // 1e-76
+    {0x8a08f0f8bf0f156bu, -289}, // 1e-68
+    {0xcdb02555653131b6u, -263}, // 1e-60
+    {0x993fe2c6d07b7facu, -236}, // 1e-52
+    {0xe45c10c42a2b3b06u, -210}, // 1e-44
+    {0xaa242499697392d3u, -183}, // 1e-36
+    {0xfd87b5f28300ca0eu, -157}, // 1e-28
+    {0xbce5086492111aebu, -130}, // 1e-20
+    {0x8cbccc096f5088ccu, -103}, // 1e-12
+    {0xd1b71758e219652cu, -77}, // 1e-4
+    {0x9c40000000000000u, -50}, // 1e4
+    {0xe8d4a51000000000u, -24}, // 1e12
+    {0xad78ebc5ac620000u, 3}, // 1e20
+    {0x813f3978f8940984u, 30}, // 1e28
+    {0xc097ce7bc90715b3u, 56}, // 1e36
+    {0x8f7e32ce7bea5c70u, 83}, // 1e44
+    {0xd5d238a4abe98068u, 109}, // 1e52
+    {0x9f4f2726179a2245u, 136}, // 1e60
+    {0xed63a231d4c4fb27u, 162}, // 1e68
+    {0xb0de65388cc8ada8u, 189}, // 1e76
+    {0x83c7088e1aab65dbu, 216}, // 1e84
+    {0xc45d1df942711d9au, 242}, // 1e92
+    {0x924d692ca61be758u, 269}, // 1e100
+    {0xda01ee641a708deau, 295}, // 1e108
+    {0xa26da3999aef774au, 322}, // 1e116
+    {0xf209787bb47d6b85u, 348}, // 1e124
+    {0xb454e4a179dd1877u, 375}, // 1e132
+    {0x865b86925b9bc5c2u, 402}, // 1e140
+    {0xc83553c5c8965d3du, 428}, // 1e148
+    {0x952ab45cfa97a0b3u, 455}, // 1e156
+    {0xde469fbd99a05fe3u, 481}, // 1e164
+    {0xa59bc234db398c25u, 508}, // 1e172
+    {0xf6c69a72a3989f5cu, 534}, // 1e180
+    {0xb7dcbf5354e9beceu, 561}, // 1e188
+    {0x88fcf317f22241e2u, 588}, // 1e196
+    {0xcc20ce9bd35c78a5u, 614}, // 1e204
+    {0x98165af37b2153dfu, 641}, // 1e212
+    {0xe2a0b5dc971f303au, 667}, // 1e220
+    {0xa8d9d1535ce3b396u, 694}, // 1e228
+    {0xfb9b7cd9a4a7443cu, 720}, // 1e236
+    {0xbb764c4ca7a44410u, 747}, // 1e244
+    {0x8bab8eefb6409c1au, 774}, // 1e252
+    {0xd01fef10a657842cu, 800}, // 1e260
+    {0x9b10a4e5e9913129u, 827}, // 1e268
+    {0xe7109bfba19c0c9du, 853}, // 1e276
+    {0xac2820d9623bf429u, 880}, // 1e284
+    {0x80444b5e7aa7cf85u, 907}, // 1e292
+    {0xbf21e44003acdd2du, 933}, // 1e300
+    {0x8e679c2f5e44ff8fu, 960}, // 1e308
+    {0xd433179d9c8cb841u, 986}, // 1e316
+    {0x9e19db92b4e31ba9u, 1013}, // 1e324
+    {0xeb96bf6ebadf77d9u, 1039}, // 1e332
+    {0xaf87023b9bf0ee6bu, 1066}, // 1e340
+};
+
+static const uint32_t pow10_u32[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static inline DiyFp diy_sub(const DiyFp a, const DiyFp b) {
+    return (DiyFp){a.f - b.f, a.e};
+}
+
+// 128 位乘积的高 64 位，按第 63 位四舍五入
+static DiyFp diy_mul(const DiyFp a, const DiyFp b) {
+#ifdef __SIZEOF_INT128__
+    const unsigned __int128 product = (unsigned __int128) a.f * b.f;
+    uint64_t high;
+
+    high = (uint64_t) (product >> 64);
+    if (((uint64_t) product >> 63) != 0) ++high;
+    return (DiyFp){high, a.e + b.e + 64};
+#else
+    const uint64_t mask = 0xFFFFFFFFu;
+    const uint64_t ah = a.f >> 32, al = a.f & mask, bh = b.f >> 32, bl = b.f & mask;
+    const uint64_t hh = ah * bh, lh = al * bh, hl = ah * bl, ll = al * bl;
+    uint64_t mid;
+
+    mid = (ll >> 32) + (hl & mask) + (lh & mask);
+    mid += (uint64_t) 1 << 31;
+    return (DiyFp){hh + (hl >> 32) + (lh >> 32) + (mid >> 32), a.e + b.e + 64};
+#endif
+}
+
+static DiyFp diy_normalize(DiyFp v) {
+    while ((v.f & ((uint64_t) 1 << 63)) == 0) {
+        v.f <<= 1;
+        --v.e;
+    }
+    return v;
+}
+
+static DiyFp diy_from_double(const double value) {
+    uint64_t bits, significand;
+    int biased_e;
+
+    memcpy(&bits, &value, sizeof(bits));
+    biased_e = (int) ((bits >> DOUBLE_SIGNIFICAND_BITS) & 0x7FF);
+    significand = bits & (DOUBLE_HIDDEN_BIT - 1);
+    if (biased_e != 0) return (DiyFp){significand + DOUBLE_HIDDEN_BIT, biased_e - DOUBLE_EXPONENT_BIAS};
+    return (DiyFp){significand, 1 - DOUBLE_EXPONENT_BIAS};
+}
+
+// v 与相邻浮点数的中点，规格化到相同的指数
+static void diy_boundaries(const DiyFp v, DiyFp *out_minus, DiyFp *out_plus) {
+    DiyFp plus, minus;
+
+    plus = (DiyFp){(v.f << 1) + 1, v.e - 1};
+    while ((plus.f & (DOUBLE_HIDDEN_BIT << 1)) == 0) {
+        plus.f <<= 1;
+        --plus.e;
+    }
+    plus.f <<= 64 - DOUBLE_SIGNIFICAND_BITS - 2;
+    plus.e -= 64 - DOUBLE_SIGNIFICAND_BITS - 2;
+
+    // 尾数为 2 的幂时，下方相邻浮点数的间隔只有上方的一半
+    minus = v.f == DOUBLE_HIDDEN_BIT ? (DiyFp){(v.f << 2) - 1, v.e - 2} : (DiyFp){(v.f << 1) - 1, v.e - 1};
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    *out_minus = minus;
+    *out_plus = plus;
+}
+
+// 选取 10^-k 使乘积的二进制指数落在 [-60, -32] 内
+static DiyFp cached_power(const int e, int *out_k) {
+    double dk;
+    int k;
+    unsigned index;
+
+    dk = (-61 - e) * 0.30102999566398114 + 347;
+    k = (int) dk;
+    if (dk - k > 0.0) ++k;
+
+    index = (unsigned) ((k >> 3) + 1);
+    *out_k = -(-348 + (int) (index << 3));
+    return cached_powers[index];
+}
+
+static inline int count_digits_u32(const uint32_t value) {
+    int count;
+
+    for (count = 1; count < 10 && value >= pow10_u32[count]; ++count) {}
+    return count;
+}
+
+// 在不越出安全区间的前提下把最后一位向 w 靠近
+static void grisu_round(char *buffer, const int len, const uint64_t delta, uint64_t rest, const uint64_t ten_kappa,
+                        const uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        --buffer[len - 1];
+        rest += ten_kappa;
+    }
+}
+
+static int digit_gen(const DiyFp w, const DiyFp mp, uint64_t delta, char *buffer, int *k) {
+    static const uint64_t pow10_u64[] = {
+        1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u,
+        10000000000u, 100000000000u, 1000000000000u, 10000000000000u, 100000000000000u,
+        1000000000000000u, 10000000000000000u, 100000000000000000u, 1000000000000000000u,
+        10000000000000000000u
+    };
+    const DiyFp one = {(uint64_t) 1 << -mp.e, mp.e};
+    const DiyFp wp_w = diy_sub(mp, w);
+    uint32_t p1, digit;
+    uint64_t p2, rest;
+    int kappa, len;
+
+    p1 = (uint32_t) (mp.f >> -one.e);
+    p2 = mp.f & (one.f - 1);
+    kappa = count_digits_u32(p1);
+    len = 0;
+
+    // 整数部分
+    while (kappa > 0) {
+        digit = p1 / pow10_u32[kappa - 1];
+        p1 %= pow10_u32[kappa - 1];
+        if (digit != 0 || len != 0) buffer[len++] = (char) ('0' + digit);
+        --kappa;
+
+        rest = ((uint64_t) p1 << -one.e) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            grisu_round(buffer, len, delta, rest, (uint64_t) pow10_u32[kappa] << -one.e, wp_w.f);
+            return len;
+        }
+    }
+
+    // 小数部分
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        digit = (uint32_t) (p2 >> -one.e);
+        if (digit != 0 || len != 0) buffer[len++] = (char) ('0' + digit);
+        p2 &= one.f - 1;
+        --kappa;
+
+        if (p2 < delta) {
+            *k += kappa;
+            grisu_round(buffer, len, delta, p2, one.f, -kappa < 20 ? wp_w.f * pow10_u64[-kappa] : 0);
+            return len;
+        }
+    }
+}
+
+// 生成 value（正的有限数）的数字串，value = buffer × 10^k，返回数字个数
+static int grisu2(const double value, char *buffer, int *k) {
+    const DiyFp v = diy_from_double(value);
+    DiyFp w_minus, w_plus, c_mk, w, wp, wm;
+
+    diy_boundaries(v, &w_minus, &w_plus);
+    c_mk = cached_power(w_plus.e, k);
+
+    w = diy_mul(diy_normalize(v), c_mk);
+    wp = diy_mul(w_plus, c_mk);
+    wm = diy_mul(w_minus, c_mk);
+    ++wm.f;
+    --wp.f;
+    return digit_gen(w, wp, wp.f - wm.f, buffer, k);
+}
+
+static size_t write_exponent(char *out, int exponent) {
+    size_t len;
+
+    len = 0;
+    out[len++] = 'e';
+    if (exponent < 0) {
+        out[len++] = '-';
+        exponent = -exponent;
+    } else {
+        out[len++] = '+';
+    }
+    return len + dstr_number_format_u64(out + len, (uint64_t) exponent);
+}
+
+// 把 digits × 10^k 排版到 out，decimal_exponent 满足 10^(decimal_exponent - 1) <= value < 10^decimal_exponent
+static size_t prettify(char *out, const char *digits, const int len, const int k) {
+    const int decimal_exponent = len + k;
+    size_t pos;
+
+    if (k >= 0 && decimal_exponent <= 21) {
+        // 1234e7 -> 12340000000
+        memcpy(out, digits, (size_t) len);
+        memset(out + len, '0', (size_t) k);
+        return (size_t) decimal_exponent;
+    }
+    if (decimal_exponent > 0 && decimal_exponent <= 21) {
+        // 1234e-2 -> 12.34
+        memcpy(out, digits, (size_t) decimal_exponent);
+        out[decimal_exponent] = '.';
+        memcpy(out + decimal_exponent + 1, digits + decimal_exponent, (size_t) (len - decimal_exponent));
+        return (size_t) len + 1;
+    }
+    if (decimal_exponent > -6 && decimal_exponent <= 0) {
+        // 1234e-6 -> 0.001234
+        out[0] = '0';
+        out[1] = '.';
+        memset(out + 2, '0', (size_t) -decimal_exponent);
+        memcpy(out + 2 - decimal_exponent, digits, (size_t) len);
+        return (size_t) (2 - decimal_exponent + len);
+    }
+
+    // 1234e30 -> 1.234e+33
+    out[0] = digits[0];
+    pos = 1;
+    if (len > 1) {
+        out[pos++] = '.';
+        memcpy(out + pos, digits + 1, (size_t) len - 1);
+        pos += (size_t) len - 1;
+    }
+    return pos + write_exponent(out + pos, decimal_exponent - 1);
+}
+
+size_t dstr_number_format_double(char *out, double value) {
+    char digits[24];
+    size_t pos;
+    int len, k;
+
+    if (isnan(value)) {
+        memcpy(out, "nan", 3);
+        return 3;
+    }
+
+    pos = 0;
+    if (signbit(value)) {
+        out[pos++] = '-';
+        value = -value;
+    }
+    if (isinf(value)) {
+        memcpy(out + pos, "inf", 3);
+        return pos + 3;
+    }
+    if (value == 0.0) {
+        out[pos] = '0';
+        return pos + 1;
+    }
+
+    k = 0;
+    len = grisu2(value, digits, &k);
+    return pos + prettify(out + pos, digits, len, k);
+}
+
+// 数值解析
+// 只接受完整的十进制写法，不跳过空白，不依赖区域设置
+bool dstr_parse_u64_view(const DStrView view, uint64_t *out_value) {
+    const char *p, *end;
+    uint64_t value;
+    unsigned digit;
+
+    assert(out_value != NULL && (view.data != NULL || view.len == 0));
+
+    p = view.data;
+    end = view.data + view.len;
+    if (p != end && *p == '+') ++p;
+    if (p == end) return false;
+
+    for (value = 0; p != end; ++p) {
+        digit = (unsigned) (*p - '0');
+        if (digit > 9) return false;
+        if (value > (UINT64_MAX - digit) / 10) return false;
+        value = value * 10 + digit;
+    }
+
+    *out_value = value;
+    return true;
+}
+
+bool dstr_parse_i64_view(const DStrView view, int64_t *out_value) {
+    uint64_t magnitude;
+    bool negative;
+
+    assert(out_value != NULL && (view.data != NULL || view.len == 0));
+
+    negative = view.len != 0 && view.data[0] == '-';
+    if (negative && view.len > 1 && view.data[1] == '+') return false;
+    if (!dstr_parse_u64_view(negative ? dstr_view_slice(view, 1, 0) : view, &magnitude)) return false;
+
+    if (negative) {
+        if (magnitude > (uint64_t) INT64_MAX + 1) return false;
+        *out_value = magnitude == (uint64_t) INT64_MAX + 1 ? INT64_MIN : -(int64_t) magnitude;
+    } else {
+        if (magnitude > INT64_MAX) return false;
+        *out_value = (int64_t) magnitude;
+    }
+    return true;
+}
+
+// 不区分大小写地比较 view 与全小写的 word
+static bool view_equals_word(const DStrView view, const char *word) {
+    size_t i;
+
+    if (view.len != strlen(word)) return false;
+    for (i = 0; i < view.len; ++i) {
+        if (tolower((unsigned char) view.data[i]) != word[i]) return false;
+    }
+    return true;
+}
+
+// 有效数字不超过 19 位且可以精确表示时直接用一次浮点乘除完成（Clinger 快速路径），结果已正确舍入
+#define PARSE_MAX_DIGITS 19
+#define PARSE_MAX_EXACT_POW10 22
+#define PARSE_MAX_EXACT_MANTISSA ((uint64_t) 1 << 53)
+#define PARSE_EXPONENT_LIMIT 100000
+
+static const double exact_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool dstr_parse_double_view(const DStrView view, double *out_value) {
+    char stack_buf[128], *buf;
+    const char *p, *end, *mantissa_begin, *mantissa_end;
+    size_t digit_count, mantissa_chars, buf_size, pos;
+    uint64_t mantissa;
+    long exponent, exp_value;
+    bool negative, seen_point, exp_negative, exact;
+    double value;
+
+    assert(out_value != NULL && (view.data != NULL || view.len == 0));
+
+    p = view.data;
+    end = view.data + view.len;
+    negative = p != end && *p == '-';
+    if (p != end && (*p == '-' || *p == '+')) ++p;
+
+    // 与 dstr_cat_double 的输出对应的特殊值
+    if (p != end && !isdigit((unsigned char) *p) && *p != '.') {
+        const DStrView word = {p, (size_t) (end - p)};
+
+        if (view_equals_word(word, "inf") || view_equals_word(word, "infinity")) value = INFINITY;
+        else if (view_equals_word(word, "nan")) value = NAN;
+        else return false;
+
+        *out_value = negative ? -value : value;
+        return true;
+    }
+
+    // 尾数：值为「去掉前导零的全部数字 × 10^exponent」，前 19 位有效数字累积到 mantissa
+    mantissa_begin = p;
+    mantissa = 0;
+    digit_count = mantissa_chars = 0;
+    exponent = 0;
+    exact = true;
+    for (seen_point = false; p != end && (isdigit((unsigned char) *p) || *p == '.'); ++p) {
+        if (*p == '.') {
+            if (seen_point) return false;
+            seen_point = true;
+            continue;
+        }
+        ++mantissa_chars;
+        if (seen_point) --exponent;
+        if (digit_count == 0 && *p == '0') continue;
+        if (digit_count < PARSE_MAX_DIGITS) mantissa = mantissa * 10 + (uint64_t) (*p - '0');
+        else if (*p != '0') exact = false;
+        ++digit_count;
+    }
+    mantissa_end = p;
+    if (mantissa_chars == 0) return false;
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        exp_negative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+')) ++p;
+        if (p == end) return false;
+        for (exp_value = 0; p != end && isdigit((unsigned char) *p); ++p) {
+            if (exp_value < PARSE_EXPONENT_LIMIT) exp_value = exp_value * 10 + (*p - '0');
+        }
+        exponent += exp_negative ? -exp_value : exp_value;
+    }
+    if (p != end) return false;
+
+    if (digit_count == 0) {
+        *out_value = negative ? -0.0 : 0.0;
+        return true;
+    }
+
+    // 超出 19 位的有效数字全为零时仍可走快速路径
+    if (exact && digit_count > PARSE_MAX_DIGITS) exponent += (long) (digit_count - PARSE_MAX_DIGITS);
+    if (exact && mantissa <= PARSE_MAX_EXACT_MANTISSA &&
+        exponent >= -PARSE_MAX_EXACT_POW10 && exponent <= PARSE_MAX_EXACT_POW10) {
+        value = (double) mantissa;
+        value = exponent < 0 ? value / exact_pow10[-exponent] : value * exact_pow10[exponent];
+        *out_value = negative ? -value : value;
+        return true;
+    }
+    if (exact && digit_count > PARSE_MAX_DIGITS) exponent -= (long) (digit_count - PARSE_MAX_DIGITS);
+
+    // 其余情况交给 strtod 保证正确舍入；改写为不含小数点的「数字e指数」形式，因而与区域设置的小数点无关
+    buf_size = mantissa_chars + 32;
+    buf = buf_size <= sizeof(stack_buf) ? stack_buf : malloc(buf_size);
+    if (buf == NULL) return false;
+
+    for (pos = 0, p = mantissa_begin; p != mantissa_end; ++p) {
+        if (*p == '.' || (pos == 0 && *p == '0')) continue;
+        buf[pos++] = *p;
+    }
+    snprintf(buf + pos, buf_size - pos, "e%ld", exponent);
+
+    value = strtod(buf, NULL);
+    if (buf != stack_buf) free(buf);
+    if (isinf(value)) return false;
+
+    *out_value = negative ? -value : value;
+    return true;
+}
+
+bool dstr_parse_u64(const DString *dstr, uint64_t *out_value) {
+    assert(dstr != NULL && out_value != NULL);
+
+    return dstr_parse_u64_view(dstr_view(dstr), out_value);
+}
+
+bool dstr_parse_i64(const DString *dstr, int64_t *out_value) {
+    assert(dstr != NULL && out_value != NULL);
+
+    return dstr_parse_i64_view(dstr_view(dstr), out_value);
+}
+
+bool dstr_parse_double(const DString *dstr, double *out_value) {
+    assert(dstr != NULL && out_value != NULL);
+
+    return dstr_parse_double_view(dstr_view(dstr), out_value);
+}
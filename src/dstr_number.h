@@ -0,0 +1,39 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_NUMBER_H
+#define DSTR_NUMBER_H
+
+/**
+ * @file dstr_number.h
+ * @brief 库内部共用的数值格式化内核（不对外公开）
+ *
+ * 输出只含 ASCII 数字、符号、'.' 与 'e'，不受区域设置影响，也不写入结尾的 '\0'。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 任意一次格式化输出的最大长度
+#define DSTR_NUMBER_MAX_LEN 32
+
+size_t dstr_number_format_u64(
+    char *out,
+    uint64_t value
+);
+
+size_t dstr_number_format_i64(
+    char *out,
+    int64_t value
+);
+
+/**
+ * 输出能精确还原 value 的十进制表示，格式见 dstr_cat_double。
+ */
+size_t dstr_number_format_double(
+    char *out,
+    double value
+);
+
+#endif // DSTR_NUMBER_H
@@ -0,0 +1,562 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_rope.h"
+#include "dstr_search.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 单个块的容量
+#define ROPE_CHUNK_MAX 1024
+// 跨边界查找时不超过该长度的窗口使用栈上缓冲
+#define ROPE_WINDOW_STACK 256
+
+typedef struct RopeNode RopeNode;
+
+struct RopeNode {
+    RopeNode *left;
+    RopeNode *right;
+    size_t size;       // 子树中的总字节数
+    uint32_t priority; // 堆序优先级，父节点不低于子节点
+    uint32_t len;      // 本块的字节数
+    char data[ROPE_CHUNK_MAX];
+};
+
+struct DStrRope {
+    RopeNode *root;
+    uint32_t seed; // 生成优先级的伪随机状态
+};
+
+// 每个绳索的种子各不相同，否则分别构造的绳索优先级序列相同，反复拼接会退化为链表
+static atomic_uint_fast32_t rope_seed_counter;
+
+// 节点
+static inline size_t node_size(const RopeNode *node) {
+    return node != NULL ? node->size : 0;
+}
+
+static inline void node_update(RopeNode *node) {
+    node->size = node_size(node->left) + node->len + node_size(node->right);
+}
+
+static uint32_t rope_random(DStrRope *rope) {
+    // xorshift32
+    rope->seed ^= rope->seed << 13;
+    rope->seed ^= rope->seed >> 17;
+    rope->seed ^= rope->seed << 5;
+    return rope->seed;
+}
+
+// 取一个新的非零种子：计数器按黄金分割步进，再经 murmur3 的收尾混合打散
+static uint32_t rope_seed_next(void) {
+    uint32_t seed;
+
+    seed = (uint32_t) atomic_fetch_add_explicit(&rope_seed_counter, 1, memory_order_relaxed) * 0x9e3779b9u;
+    seed ^= seed >> 16;
+    seed *= 0x85ebca6bu;
+    seed ^= seed >> 13;
+    seed *= 0xc2b2ae35u;
+    seed ^= seed >> 16;
+    return seed != 0 ? seed : 0x9e3779b9u;
+}
+
+static RopeNode *node_create(DStrRope *rope, const char *data, const size_t len) {
+    RopeNode *node;
+
+    assert(len <= ROPE_CHUNK_MAX);
+
+    node = malloc(sizeof(RopeNode));
+    if (node == NULL) return NULL;
+
+    node->left = node->right = NULL;
+    node->priority = rope_random(rope);
+    node->len = (uint32_t) len;
+    node->size = len;
+    if (len != 0) memcpy(node->data, data, len);
+    return node;
+}
+
+static void node_free_all(RopeNode *node) {
+    if (node == NULL) return;
+
+    node_free_all(node->left);
+    node_free_all(node->right);
+    free(node);
+}
+
+// 树操作
+static RopeNode *rope_merge(RopeNode *left, RopeNode *right) {
+    if (left == NULL) return right;
+    if (right == NULL) return left;
+
+    if (left->priority >= right->priority) {
+        left->right = rope_merge(left->right, right);
+        node_update(left);
+        return left;
+    }
+    right->left = rope_merge(left, right->left);
+    node_update(right);
+    return right;
+}
+
+// 按偏移拆分为 [0, index) 与 [index, size) 两棵树
+// index 落在块内部时把后半块移入 *spare（调用者预先分配），并置 *spare 为 NULL
+static void rope_split(RopeNode *node, size_t index, RopeNode **left, RopeNode **right, RopeNode **spare) {
+    RopeNode *tail;
+    size_t left_size;
+
+    if (node == NULL) {
+        *left = *right = NULL;
+        return;
+    }
+
+    left_size = node_size(node->left);
+    if (index <= left_size) {
+        rope_split(node->left, index, left, &node->left, spare);
+        node_update(node);
+        *right = node;
+    } else if (index >= left_size + node->len) {
+        rope_split(node->right, index - left_size - node->len, &node->right, right, spare);
+        node_update(node);
+        *left = node;
+    } else {
+        assert(spare != NULL && *spare != NULL);
+        tail = *spare;
+        *spare = NULL;
+        index -= left_size;
+
+        // 后半块沿用原节点的优先级，作为右侧子树的根仍满足堆序
+        tail->len = node->len - (uint32_t) index;
+        memcpy(tail->data, node->data + index, tail->len);
+        tail->priority = node->priority;
+        tail->left = NULL;
+        tail->right = node->right;
+        node->len = (uint32_t) index;
+        node->right = NULL;
+        node_update(tail);
+        node_update(node);
+
+        *left = node;
+        *right = tail;
+    }
+}
+
+// 查找包含第 index 个字节的块，*out_offset 返回块内偏移
+static RopeNode *rope_locate(RopeNode *node, size_t index, size_t *out_offset) {
+    size_t left_size;
+
+    *out_offset = 0;
+    while (node != NULL) {
+        left_size = node_size(node->left);
+        if (index < left_size) {
+            node = node->left;
+        } else if (index < left_size + node->len) {
+            *out_offset = index - left_size;
+            return node;
+        } else {
+            index -= left_size + node->len;
+            node = node->right;
+        }
+    }
+    return NULL;
+}
+
+// 沿 rope_locate(index) 的路径调整子树大小，须在修改目标块的长度之前调用
+static void rope_adjust_path(RopeNode *node, size_t index, const size_t added, const size_t removed) {
+    size_t left_size;
+
+    while (node != NULL) {
+        left_size = node_size(node->left);
+        node->size = node->size + added - removed;
+        if (index < left_size) {
+            node = node->left;
+        } else if (index < left_size + node->len) {
+            return;
+        } else {
+            index -= left_size + node->len;
+            node = node->right;
+        }
+    }
+}
+
+static RopeNode *rope_leftmost(RopeNode *node) {
+    while (node->left != NULL) node = node->left;
+    return node;
+}
+
+static RopeNode *rope_rightmost(RopeNode *node) {
+    while (node->right != NULL) node = node->right;
+    return node;
+}
+
+// 将 data[0, len) 切分为块并构造成一棵树
+static RopeNode *rope_build(DStrRope *rope, const char *data, size_t len) {
+    RopeNode *root, *node;
+    size_t piece;
+
+    for (root = NULL; len != 0; data += piece, len -= piece) {
+        piece = len < ROPE_CHUNK_MAX ? len : ROPE_CHUNK_MAX;
+        node = node_create(rope, data, piece);
+        if (node == NULL) {
+            node_free_all(root);
+            return NULL;
+        }
+        root = rope_merge(root, node);
+    }
+    return root;
+}
+
+// 若 pos 恰为块边界，且两侧的块合起来放得进一个块，则把右侧块并入左侧块
+static void rope_coalesce(DStrRope *rope, const size_t pos) {
+    RopeNode *left, *right, *first, *rest, *last;
+    size_t offset;
+
+    if (pos == 0 || pos >= node_size(rope->root)) return;
+    if (rope_locate(rope->root, pos, &offset) == NULL || offset != 0) return;
+
+    rope_split(rope->root, pos, &left, &right, NULL);
+    first = rope_leftmost(right);
+    last = rope_rightmost(left);
+
+    if (last->len + first->len > ROPE_CHUNK_MAX) {
+        rope->root = rope_merge(left, right);
+        return;
+    }
+
+    rope_split(right, first->len, &first, &rest, NULL);
+    rope_adjust_path(left, node_size(left) - 1, first->len, 0);
+    memcpy(last->data + last->len, first->data, first->len);
+    last->len += first->len;
+    free(first);
+
+    rope->root = rope_merge(left, rest);
+}
+
+// 创建、销毁
+DStrRope *dstr_rope_create(void) {
+    DStrRope *rope;
+
+    rope = malloc(sizeof(DStrRope));
+    if (rope == NULL) return NULL;
+
+    rope->root = NULL;
+    rope->seed = rope_seed_next();
+    return rope;
+}
+
+DStrRope *dstr_rope_create_from(const DStrView view) {
+    DStrRope *rope;
+
+    assert(view.data != NULL || view.len == 0);
+
+    rope = dstr_rope_create();
+    if (rope == NULL) return NULL;
+
+    rope->root = rope_build(rope, view.data, view.len);
+    if (rope->root == NULL && view.len != 0) {
+        free(rope);
+        return NULL;
+    }
+    return rope;
+}
+
+void dstr_rope_destroy(DStrRope *rope) {
+    assert(rope != NULL);
+
+    node_free_all(rope->root);
+    free(rope);
+}
+
+// 属性获取
+size_t dstr_rope_length(const DStrRope *rope) {
+    assert(rope != NULL);
+
+    return node_size(rope->root);
+}
+
+char dstr_rope_at(const DStrRope *rope, const size_t index) {
+    const RopeNode *node;
+    size_t offset;
+
+    assert(rope != NULL && index < node_size(rope->root));
+
+    node = rope_locate(rope->root, index, &offset);
+    return node->data[offset];
+}
+
+// 编辑
+bool dstr_rope_insert(DStrRope *rope, const size_t index, const DStrView src) {
+    RopeNode *node, *middle, *spare, *left, *right;
+    size_t size, at, offset;
+
+    assert(rope != NULL && (src.data != NULL || src.len == 0));
+
+    size = node_size(rope->root);
+    if (index > size || src.len == 0) return false;
+
+    // 较短的内容直接并入所在的块（在末尾插入时并入最后一块）
+    if (rope->root != NULL) {
+        at = index < size ? index : index - 1;
+        node = rope_locate(rope->root, at, &offset);
+        if (index == size) offset = node->len;
+        if (src.len <= ROPE_CHUNK_MAX - node->len) {
+            rope_adjust_path(rope->root, at, src.len, 0);
+            memmove(node->data + offset + src.len, node->data + offset, node->len - offset);
+            memcpy(node->data + offset, src.data, src.len);
+            node->len += (uint32_t) src.len;
+            return true;
+        }
+    }
+
+    // 否则把新内容构造成子树后拼接
+    middle = rope_build(rope, src.data, src.len);
+    if (middle == NULL) return false;
+    spare = malloc(sizeof(RopeNode));
+    if (spare == NULL) {
+        node_free_all(middle);
+        return false;
+    }
+
+    rope_split(rope->root, index, &left, &right, &spare);
+    free(spare);
+    rope->root = rope_merge(rope_merge(left, middle), right);
+
+    rope_coalesce(rope, index + src.len);
+    rope_coalesce(rope, index);
+    return true;
+}
+
+bool dstr_rope_append(DStrRope *rope, const DStrView src) {
+    assert(rope != NULL);
+
+    return dstr_rope_insert(rope, node_size(rope->root), src);
+}
+
+bool dstr_rope_remove(DStrRope *rope, const size_t sub_index, size_t sub_count) {
+    RopeNode *node, *left, *middle, *right, *rest, *spare_1, *spare_2;
+    size_t size, offset;
+
+    assert(rope != NULL);
+
+    size = node_size(rope->root);
+    if (sub_index >= size || sub_count > size - sub_index) return false;
+    if (sub_count == 0) sub_count = size - sub_index;
+
+    // 删除范围位于单个块内且不会删空该块时，原地移动
+    node = rope_locate(rope->root, sub_index, &offset);
+    if (offset + sub_count <= node->len && sub_count < node->len) {
+        rope_adjust_path(rope->root, sub_index, 0, sub_count);
+        memmove(node->data + offset, node->data + offset + sub_count, node->len - offset - sub_count);
+        node->len -= (uint32_t) sub_count;
+        rope_coalesce(rope, sub_index);
+        return true;
+    }
+
+    spare_1 = malloc(sizeof(RopeNode));
+    spare_2 = malloc(sizeof(RopeNode));
+    if (spare_1 == NULL || spare_2 == NULL) {
+        free(spare_1);
+        free(spare_2);
+        return false;
+    }
+
+    rope_split(rope->root, sub_index, &left, &rest, &spare_1);
+    rope_split(rest, sub_count, &middle, &right, &spare_2);
+    node_free_all(middle);
+    free(spare_1);
+    free(spare_2);
+    rope->root = rope_merge(left, right);
+
+    rope_coalesce(rope, sub_index);
+    return true;
+}
+
+void dstr_rope_concat(DStrRope *dest, DStrRope *src) {
+    size_t seam;
+
+    assert(dest != NULL && src != NULL && dest != src);
+
+    seam = node_size(dest->root);
+    dest->root = rope_merge(dest->root, src->root);
+    src->root = NULL;
+    rope_coalesce(dest, seam);
+}
+
+DStrRope *dstr_rope_split(DStrRope *rope, const size_t index) {
+    DStrRope *tail;
+    RopeNode *spare;
+
+    assert(rope != NULL);
+
+    if (index > node_size(rope->root)) return NULL;
+
+    tail = dstr_rope_create();
+    spare = malloc(sizeof(RopeNode));
+    if (tail == NULL || spare == NULL) {
+        free(tail);
+        free(spare);
+        return NULL;
+    }
+
+    tail->seed = rope_random(rope);
+    rope_split(rope->root, index, &rope->root, &tail->root, &spare);
+    free(spare);
+    return tail;
+}
+
+// 转换
+// 将 [index, index + len) 复制到 out
+static void rope_copy(const DStrRope *rope, const size_t index, size_t len, char *out) {
+    DStrRopeIter iter;
+    DStrView chunk;
+    size_t piece;
+
+    dstr_rope_iter_init(&iter, rope, index);
+    while (len != 0 && dstr_rope_iter_next(&iter, &chunk)) {
+        piece = chunk.len < len ? chunk.len : len;
+        memcpy(out, chunk.data, piece);
+        out += piece;
+        len -= piece;
+    }
+}
+
+DString *dstr_rope_sub(const DStrRope *rope, const size_t sub_index, const size_t sub_count) {
+    DString *new_dstr;
+    char *out;
+    size_t size, sub_len;
+
+    assert(rope != NULL);
+
+    size = node_size(rope->root);
+    if (sub_index >= size || sub_count > size - sub_index) return NULL;
+
+    sub_len = sub_count == 0 ? size - sub_index : sub_count;
+    new_dstr = dstr_create(NULL);
+    if (new_dstr == NULL) return NULL;
+
+    // 各块直接写入新字符串的空闲容量，只复制一次
+    out = dstr_prepare_append(new_dstr, sub_len);
+    if (out == NULL) {
+        dstr_destroy(new_dstr);
+        return NULL;
+    }
+    rope_copy(rope, sub_index, sub_len, out);
+    dstr_commit_append(new_dstr, sub_len);
+    return new_dstr;
+}
+
+DString *dstr_rope_to_dstr(const DStrRope *rope) {
+    assert(rope != NULL);
+
+    if (rope->root == NULL) return dstr_create(NULL);
+
+    return dstr_rope_sub(rope, 0, 0);
+}
+
+// 遍历
+void dstr_rope_iter_init(DStrRopeIter *iter, const DStrRope *rope, const size_t offset) {
+    assert(iter != NULL && rope != NULL);
+
+    iter->rope = rope;
+    iter->offset = offset;
+}
+
+bool dstr_rope_iter_next(DStrRopeIter *iter, DStrView *out_chunk) {
+    const RopeNode *node;
+    size_t offset;
+
+    assert(iter != NULL && out_chunk != NULL);
+
+    node = rope_locate(iter->rope->root, iter->offset, &offset);
+    if (node == NULL) return false;
+
+    out_chunk->data = node->data + offset;
+    out_chunk->len = node->len - offset;
+    iter->offset += out_chunk->len;
+    return true;
+}
+
+// 查找与比较
+bool dstr_rope_find(const DStrRope *rope, const DStrView sub, const size_t from, size_t *out_index) {
+    DStrRopeIter iter;
+    DStrView chunk;
+    char stack_window[ROPE_WINDOW_STACK];
+    char *window;
+    size_t size, base, start, end, pos;
+    bool found;
+
+    assert(rope != NULL && out_index != NULL);
+
+    size = node_size(rope->root);
+    if (sub.len == 0 || from > size || sub.len > size - from) return false;
+
+    // 跨越块边界的匹配在边界两侧各 sub.len - 1 字节的窗口中查找
+    window = 2 * (sub.len - 1) <= ROPE_WINDOW_STACK ? stack_window : malloc(2 * (sub.len - 1));
+    if (window == NULL) return false;
+
+    found = false;
+    dstr_rope_iter_init(&iter, rope, from);
+    for (base = from; !found && dstr_rope_iter_next(&iter, &chunk); base += chunk.len) {
+        if (base > from && sub.len > 1) {
+            start = base - from > sub.len - 1 ? base - (sub.len - 1) : from;
+            end = size - base > sub.len - 1 ? base + (sub.len - 1) : size;
+            rope_copy(rope, start, end - start, window);
+            pos = dstr_search_first(window, end - start, sub.data, sub.len);
+            if (pos != DSTR_SEARCH_NPOS) {
+                *out_index = start + pos;
+                found = true;
+                break;
+            }
+        }
+
+        pos = dstr_search_first(chunk.data, chunk.len, sub.data, sub.len);
+        if (pos != DSTR_SEARCH_NPOS) {
+            *out_index = base + pos;
+            found = true;
+        }
+    }
+
+    if (window != stack_window) free(window);
+    return found;
+}
+
+int dstr_rope_compare(const DStrRope *rope, const DStrView view) {
+    DStrRopeIter iter;
+    DStrView chunk;
+    size_t done, piece;
+    int result;
+
+    assert(rope != NULL && (view.data != NULL || view.len == 0));
+
+    dstr_rope_iter_init(&iter, rope, 0);
+    for (done = 0; dstr_rope_iter_next(&iter, &chunk); done += chunk.len) {
+        if (done >= view.len) return 1;
+
+        piece = chunk.len < view.len - done ? chunk.len : view.len - done;
+        result = memcmp(chunk.data, view.data + done, piece);
+        if (result != 0) return result;
+        if (piece < chunk.len) return 1;
+    }
+
+    return done < view.len ? -1 : 0;
+}
+
+bool dstr_rope_equals(const DStrRope *rope, const DStrView view) {
+    DStrRopeIter iter;
+    DStrView chunk;
+    size_t done;
+
+    assert(rope != NULL && (view.data != NULL || view.len == 0));
+
+    if (node_size(rope->root) != view.len) return false;
+
+    dstr_rope_iter_init(&iter, rope, 0);
+    for (done = 0; dstr_rope_iter_next(&iter, &chunk); done += chunk.len) {
+        if (!dstr_search_equal(chunk.data, view.data + done, chunk.len)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,601 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_search.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "portable_attributes.h"
+
+#if (COMPILER_GCC || COMPILER_CLANG) && defined(__x86_64__)
+#  define SEARCH_HAS_X86_SIMD 1
+#  include <immintrin.h>
+#else
+#  define SEARCH_HAS_X86_SIMD 0
+#endif
+
+// 过滤阶段累计的校验字节数超过「已扫描长度 × 2 + 该值」时切换到 Two-Way
+#define SEARCH_WORK_SLACK 1024
+
+// Two-Way 算法
+// reverse 为真时把 hay 与 needle 都视为逆序，结果换算回原始下标，用于查找最后一次出现
+#define AT(s, len, i) (reverse ? (s)[(len) - 1 - (i)] : (s)[i])
+
+// 计算 needle 的临界分解位置，period 输出对应的周期
+static size_t critical_factorization(const unsigned char *needle, const size_t needle_len,
+                                     size_t *period, const bool reverse) {
+    size_t max_suffix, max_suffix_rev, j, k, p;
+    unsigned char a, b;
+
+    // 按字典序
+    max_suffix = SIZE_MAX;
+    j = 0;
+    k = p = 1;
+    while (j + k < needle_len) {
+        a = AT(needle, needle_len, j + k);
+        b = AT(needle, needle_len, max_suffix + k);
+        if (a < b) {
+            j += k;
+            k = 1;
+            p = j - max_suffix;
+        } else if (a == b) {
+            if (k != p) {
+                ++k;
+            } else {
+                j += p;
+                k = 1;
+            }
+        } else {
+            max_suffix = j++;
+            k = p = 1;
+        }
+    }
+    *period = p;
+
+    // 按逆字典序
+    max_suffix_rev = SIZE_MAX;
+    j = 0;
+    k = p = 1;
+    while (j + k < needle_len) {
+        a = AT(needle, needle_len, j + k);
+        b = AT(needle, needle_len, max_suffix_rev + k);
+        if (b < a) {
+            j += k;
+            k = 1;
+            p = j - max_suffix_rev;
+        } else if (a == b) {
+            if (k != p) {
+                ++k;
+            } else {
+                j += p;
+                k = 1;
+            }
+        } else {
+            max_suffix_rev = j++;
+            k = p = 1;
+        }
+    }
+
+    // 取较长的后缀
+    if (max_suffix_rev + 1 < max_suffix + 1) return max_suffix + 1;
+    *period = p;
+    return max_suffix_rev + 1;
+}
+
+static size_t two_way(const unsigned char *hay, const size_t hay_len,
+                      const unsigned char *needle, const size_t needle_len, const bool reverse) {
+    size_t suffix, period, memory, i, j;
+    bool periodic;
+
+    if (needle_len > hay_len) return DSTR_SEARCH_NPOS;
+
+    suffix = critical_factorization(needle, needle_len, &period, reverse);
+
+    for (periodic = true, i = 0; i < suffix; ++i) {
+        if (AT(needle, needle_len, i) != AT(needle, needle_len, i + period)) {
+            periodic = false;
+            break;
+        }
+    }
+
+    if (periodic) {
+        // needle 整体具有周期性，记住已匹配的周期数以避免重复比较
+        memory = 0;
+        for (j = 0; j <= hay_len - needle_len;) {
+            i = suffix > memory ? suffix : memory;
+            while (i < needle_len && AT(needle, needle_len, i) == AT(hay, hay_len, i + j)) ++i;
+            if (i >= needle_len) {
+                i = suffix - 1;
+                while (memory < i + 1 && AT(needle, needle_len, i) == AT(hay, hay_len, i + j)) --i;
+                if (i + 1 < memory + 1) {
+                    return reverse ? hay_len - j - needle_len : j;
+                }
+                j += period;
+                memory = needle_len - period;
+            } else {
+                j += i - suffix + 1;
+                memory = 0;
+            }
+        }
+    } else {
+        // 左右两半互不相同，任一失配都可按最大距离移动
+        period = (suffix > needle_len - suffix ? suffix : needle_len - suffix) + 1;
+        for (j = 0; j <= hay_len - needle_len;) {
+            i = suffix;
+            while (i < needle_len && AT(needle, needle_len, i) == AT(hay, hay_len, i + j)) ++i;
+            if (i >= needle_len) {
+                i = suffix - 1;
+                while (i != SIZE_MAX && AT(needle, needle_len, i) == AT(hay, hay_len, i + j)) --i;
+                if (i == SIZE_MAX) {
+                    return reverse ? hay_len - j - needle_len : j;
+                }
+                j += period;
+            } else {
+                j += i - suffix + 1;
+            }
+        }
+    }
+
+    return DSTR_SEARCH_NPOS;
+}
+
+#undef AT
+
+// 标量首尾字节过滤
+// 所有过滤函数只检查候选位置 [0, hay_len - needle_len]，要求 2 <= needle_len <= hay_len
+static size_t scalar_first(const unsigned char *hay, const size_t hay_len,
+                           const unsigned char *needle, const size_t needle_len) {
+    const unsigned char *find, *end;
+    size_t work;
+
+    end = hay + hay_len - needle_len + 1;
+    for (work = 0, find = hay; find < end; ++find) {
+        find = memchr(find, needle[0], end - find);
+        if (find == NULL) break;
+        if (find[needle_len - 1] == needle[needle_len - 1]) {
+            if (memcmp(find + 1, needle + 1, needle_len - 2) == 0) return find - hay;
+            work += needle_len;
+            if (work > (size_t) (find - hay) * 2 + SEARCH_WORK_SLACK) {
+                size_t pos = two_way(find, hay + hay_len - find, needle, needle_len, false);
+                return pos == DSTR_SEARCH_NPOS ? pos : pos + (find - hay);
+            }
+        }
+    }
+    return DSTR_SEARCH_NPOS;
+}
+
+static size_t scalar_last(const unsigned char *hay, const size_t hay_len,
+                          const unsigned char *needle, const size_t needle_len) {
+    size_t end, work;
+
+    // end 为剩余候选位置的个数，候选位置为 [0, end)
+    for (work = 0, end = hay_len - needle_len + 1; end > 0; --end) {
+        if (hay[end - 1] == needle[0] && hay[end + needle_len - 2] == needle[needle_len - 1]) {
+            if (memcmp(hay + end, needle + 1, needle_len - 2) == 0) return end - 1;
+            work += needle_len;
+            if (work > (hay_len - needle_len + 1 - end) * 2 + SEARCH_WORK_SLACK) {
+                return two_way(hay, end - 1 + needle_len, needle, needle_len, true);
+            }
+        }
+    }
+    return DSTR_SEARCH_NPOS;
+}
+
+#if SEARCH_HAS_X86_SIMD
+
+// SSE2 首尾字节过滤：一次比较 16 个候选位置的首字节与尾字节，两者都相同才做完整校验
+static size_t sse2_first(const unsigned char *hay, const size_t hay_len,
+                         const unsigned char *needle, const size_t needle_len) {
+    __m128i first, last, block_first, block_last;
+    unsigned mask, bit;
+    size_t i, work, pos;
+
+    first = _mm_set1_epi8((char) needle[0]);
+    last = _mm_set1_epi8((char) needle[needle_len - 1]);
+
+    for (work = 0, i = 0; i + 16 + needle_len - 1 <= hay_len; i += 16) {
+        block_first = _mm_loadu_si128((const __m128i *) (hay + i));
+        block_last = _mm_loadu_si128((const __m128i *) (hay + i + needle_len - 1));
+        mask = (unsigned) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                                                          _mm_cmpeq_epi8(last, block_last)));
+        while (mask != 0) {
+            bit = (unsigned) __builtin_ctz(mask);
+            if (memcmp(hay + i + bit + 1, needle + 1, needle_len - 2) == 0) return i + bit;
+            work += needle_len;
+            mask &= mask - 1;
+        }
+        if (work > i * 2 + SEARCH_WORK_SLACK) {
+            pos = two_way(hay + i + 16, hay_len - i - 16, needle, needle_len, false);
+            return pos == DSTR_SEARCH_NPOS ? pos : pos + i + 16;
+        }
+    }
+
+    pos = scalar_first(hay + i, hay_len - i, needle, needle_len);
+    return pos == DSTR_SEARCH_NPOS ? pos : pos + i;
+}
+
+static size_t sse2_last(const unsigned char *hay, const size_t hay_len,
+                        const unsigned char *needle, const size_t needle_len) {
+    __m128i first, last, block_first, block_last;
+    unsigned mask, bit;
+    size_t end, base, work;
+
+    first = _mm_set1_epi8((char) needle[0]);
+    last = _mm_set1_epi8((char) needle[needle_len - 1]);
+
+    // end 为剩余候选位置的个数，每轮检查 [end - 16, end)
+    for (work = 0, end = hay_len - needle_len + 1; end >= 16; end = base) {
+        base = end - 16;
+        block_first = _mm_loadu_si128((const __m128i *) (hay + base));
+        block_last = _mm_loadu_si128((const __m128i *) (hay + base + needle_len - 1));
+        mask = (unsigned) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                                                          _mm_cmpeq_epi8(last, block_last)));
+        while (mask != 0) {
+            bit = 31u - (unsigned) __builtin_clz(mask);
+            if (memcmp(hay + base + bit + 1, needle + 1, needle_len - 2) == 0) return base + bit;
+            work += needle_len;
+            mask &= ~(1u << bit);
+        }
+        if (work > (hay_len - needle_len + 1 - base) * 2 + SEARCH_WORK_SLACK) {
+            return base == 0 ? DSTR_SEARCH_NPOS : two_way(hay, base - 1 + needle_len, needle, needle_len, true);
+        }
+    }
+
+    return end == 0 ? DSTR_SEARCH_NPOS : scalar_last(hay, end - 1 + needle_len, needle, needle_len);
+}
+
+// AVX2 版本，逻辑与 SSE2 相同，一次处理 32 个候选位置
+__attribute__((target("avx2")))
+static size_t avx2_first(const unsigned char *hay, const size_t hay_len,
+                         const unsigned char *needle, const size_t needle_len) {
+    __m256i first, last, block_first, block_last;
+    unsigned mask, bit;
+    size_t i, work, pos;
+
+    first = _mm256_set1_epi8((char) needle[0]);
+    last = _mm256_set1_epi8((char) needle[needle_len - 1]);
+
+    for (work = 0, i = 0; i + 32 + needle_len - 1 <= hay_len; i += 32) {
+        block_first = _mm256_loadu_si256((const __m256i *) (hay + i));
+        block_last = _mm256_loadu_si256((const __m256i *) (hay + i + needle_len - 1));
+        mask = (unsigned) _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first),
+                                                                _mm256_cmpeq_epi8(last, block_last)));
+        while (mask != 0) {
+            bit = (unsigned) __builtin_ctz(mask);
+            if (memcmp(hay + i + bit + 1, needle + 1, needle_len - 2) == 0) return i + bit;
+            work += needle_len;
+            mask &= mask - 1;
+        }
+        if (work > i * 2 + SEARCH_WORK_SLACK) {
+            pos = two_way(hay + i + 32, hay_len - i - 32, needle, needle_len, false);
+            return pos == DSTR_SEARCH_NPOS ? pos : pos + i + 32;
+        }
+    }
+
+    pos = sse2_first(hay + i, hay_len - i, needle, needle_len);
+    return pos == DSTR_SEARCH_NPOS ? pos : pos + i;
+}
+
+__attribute__((target("avx2")))
+static size_t avx2_last(const unsigned char *hay, const size_t hay_len,
+                        const unsigned char *needle, const size_t needle_len) {
+    __m256i first, last, block_first, block_last;
+    unsigned mask, bit;
+    size_t end, base, work;
+
+    first = _mm256_set1_epi8((char) needle[0]);
+    last = _mm256_set1_epi8((char) needle[needle_len - 1]);
+
+    for (work = 0, end = hay_len - needle_len + 1; end >= 32; end = base) {
+        base = end - 32;
+        block_first = _mm256_loadu_si256((const __m256i *) (hay + base));
+        block_last = _mm256_loadu_si256((const __m256i *) (hay + base + needle_len - 1));
+        mask = (unsigned) _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first),
+                                                                _mm256_cmpeq_epi8(last, block_last)));
+        while (mask != 0) {
+            bit = 31u - (unsigned) __builtin_clz(mask);
+            if (memcmp(hay + base + bit + 1, needle + 1, needle_len - 2) == 0) return base + bit;
+            work += needle_len;
+            mask &= ~(1u << bit);
+        }
+        if (work > (hay_len - needle_len + 1 - base) * 2 + SEARCH_WORK_SLACK) {
+            return base == 0 ? DSTR_SEARCH_NPOS : two_way(hay, base - 1 + needle_len, needle, needle_len, true);
+        }
+    }
+
+    return end == 0 ? DSTR_SEARCH_NPOS : sse2_last(hay, end - 1 + needle_len, needle, needle_len);
+}
+
+static inline bool cpu_has_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif // SEARCH_HAS_X86_SIMD
+
+// 单字节逆向查找（memrchr 并非标准函数）
+static size_t byte_last(const unsigned char *hay, size_t hay_len, const unsigned char c) {
+    while (hay_len > 0) {
+        if (hay[--hay_len] == c) return hay_len;
+    }
+    return DSTR_SEARCH_NPOS;
+}
+
+size_t dstr_search_first(const char *hay, const size_t hay_len, const char *needle, const size_t needle_len) {
+    const char *find;
+
+    if (needle_len == 0 || needle_len > hay_len) return DSTR_SEARCH_NPOS;
+
+    if (needle_len == 1) {
+        find = memchr(hay, needle[0], hay_len);
+        return find != NULL ? (size_t) (find - hay) : DSTR_SEARCH_NPOS;
+    }
+
+#if SEARCH_HAS_X86_SIMD
+    if (cpu_has_avx2()) {
+        return avx2_first((const unsigned char *) hay, hay_len, (const unsigned char *) needle, needle_len);
+    }
+    return sse2_first((const unsigned char *) hay, hay_len, (const unsigned char *) needle, needle_len);
+#else
+    return scalar_first((const unsigned char *) hay, hay_len, (const unsigned char *) needle, needle_len);
+#endif
+}
+
+size_t dstr_search_last(const char *hay, const size_t hay_len, const char *needle, const size_t needle_len) {
+    if (needle_len == 0 || needle_len > hay_len) return DSTR_SEARCH_NPOS;
+
+    if (needle_len == 1) {
+        return byte_last((const unsigned char *) hay, hay_len, (unsigned char) needle[0]);
+    }
+
+#if SEARCH_HAS_X86_SIMD
+    if (cpu_has_avx2()) {
+        return avx2_last((const unsigned char *) hay, hay_len, (const unsigned char *) needle, needle_len);
+    }
+    return sse2_last((const unsigned char *) hay, hay_len, (const unsigned char *) needle, needle_len);
+#else
+    return scalar_last((const unsigned char *) hay, hay_len, (const unsigned char *) needle, needle_len);
+#endif
+}
+
+// 等值比较
+// 较短时直接使用 memcmp；较长时按块异或并累积差异，每 64 字节（AVX2 为 128 字节）检查一次，
+// 末尾不足一块的部分用与前一块重叠的最后一块收尾
+#define EQUAL_SIMD_MIN 64
+
+#if SEARCH_HAS_X86_SIMD
+static inline __m128i sse2_diff(const unsigned char *a, const unsigned char *b) {
+    return _mm_xor_si128(_mm_loadu_si128((const __m128i *) a), _mm_loadu_si128((const __m128i *) b));
+}
+
+static inline bool sse2_is_zero(const __m128i diff) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) == 0xffff;
+}
+
+static bool sse2_equal(const unsigned char *a, const unsigned char *b, const size_t len) {
+    size_t i;
+
+    for (i = 0; i + 64 <= len; i += 64) {
+        if (!sse2_is_zero(_mm_or_si128(_mm_or_si128(sse2_diff(a + i, b + i), sse2_diff(a + i + 16, b + i + 16)),
+                                       _mm_or_si128(sse2_diff(a + i + 32, b + i + 32),
+                                                    sse2_diff(a + i + 48, b + i + 48))))) {
+            return false;
+        }
+    }
+    for (; i + 16 <= len; i += 16) {
+        if (!sse2_is_zero(sse2_diff(a + i, b + i))) return false;
+    }
+
+    return i == len || sse2_is_zero(sse2_diff(a + len - 16, b + len - 16));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_diff(const unsigned char *a, const unsigned char *b) {
+    return _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) a), _mm256_loadu_si256((const __m256i *) b));
+}
+
+__attribute__((target("avx2")))
+static bool avx2_equal(const unsigned char *a, const unsigned char *b, const size_t len) {
+    __m256i diff;
+    size_t i;
+
+    for (i = 0; i + 128 <= len; i += 128) {
+        diff = _mm256_or_si256(_mm256_or_si256(avx2_diff(a + i, b + i), avx2_diff(a + i + 32, b + i + 32)),
+                               _mm256_or_si256(avx2_diff(a + i + 64, b + i + 64),
+                                               avx2_diff(a + i + 96, b + i + 96)));
+        if (!_mm256_testz_si256(diff, diff)) return false;
+    }
+    for (; i + 32 <= len; i += 32) {
+        diff = avx2_diff(a + i, b + i);
+        if (!_mm256_testz_si256(diff, diff)) return false;
+    }
+    if (i == len) return true;
+
+    diff = avx2_diff(a + len - 32, b + len - 32);
+    return _mm256_testz_si256(diff, diff);
+}
+#endif // SEARCH_HAS_X86_SIMD
+
+bool dstr_search_equal(const char *a, const char *b, const size_t len) {
+    if (a == b) return true;
+    if (len < EQUAL_SIMD_MIN) return memcmp(a, b, len) == 0;
+
+#if SEARCH_HAS_X86_SIMD
+    if (cpu_has_avx2()) {
+        return avx2_equal((const unsigned char *) a, (const unsigned char *) b, len);
+    }
+    return sse2_equal((const unsigned char *) a, (const unsigned char *) b, len);
+#else
+    return memcmp(a, b, len) == 0;
+#endif
+}
+
+// 预编译查找模式
+// 单字节用 memchr；x86-64 上短模式用 SIMD 首尾字节过滤，长模式用 Horspool 跳转表；
+// 其余平台除单字节外都用 Horspool。Horspool 同样受线性预算约束，超出后切换到 Two-Way。
+#if SEARCH_HAS_X86_SIMD
+#  define PATTERN_HORSPOOL_MIN 32
+#else
+#  define PATTERN_HORSPOOL_MIN 4
+#endif
+
+typedef enum PatternStrategy {
+    PATTERN_EMPTY,
+    PATTERN_BYTE,
+    PATTERN_FILTER,
+    PATTERN_HORSPOOL
+} PatternStrategy;
+
+struct DStrPattern {
+    PatternStrategy strategy;
+    size_t len;
+    size_t *skip;     // 正向 Horspool 跳转表，按窗口末字节索引
+    size_t *skip_rev; // 逆向 Horspool 跳转表，按窗口首字节索引
+    unsigned char needle[];
+};
+
+static size_t horspool_first(const DStrPattern *pattern, const unsigned char *hay, const size_t hay_len) {
+    const unsigned char *needle;
+    size_t m, i, work, pos;
+    unsigned char last;
+
+    needle = pattern->needle;
+    m = pattern->len;
+
+    for (work = 0, i = 0; i <= hay_len - m; i += pattern->skip[last]) {
+        last = hay[i + m - 1];
+        if (last == needle[m - 1]) {
+            if (memcmp(hay + i, needle, m - 1) == 0) return i;
+            work += m;
+            if (work > i * 2 + SEARCH_WORK_SLACK) {
+                pos = two_way(hay + i + 1, hay_len - i - 1, needle, m, false);
+                return pos == DSTR_SEARCH_NPOS ? pos : pos + i + 1;
+            }
+        }
+    }
+    return DSTR_SEARCH_NPOS;
+}
+
+static size_t horspool_last(const DStrPattern *pattern, const unsigned char *hay, const size_t hay_len) {
+    const unsigned char *needle;
+    size_t m, i, work;
+    unsigned char first;
+
+    needle = pattern->needle;
+    m = pattern->len;
+
+    for (work = 0, i = hay_len - m;; i -= pattern->skip_rev[first]) {
+        first = hay[i];
+        if (first == needle[0]) {
+            if (memcmp(hay + i + 1, needle + 1, m - 1) == 0) return i;
+            work += m;
+            if (work > (hay_len - m - i) * 2 + SEARCH_WORK_SLACK) {
+                return i == 0 ? DSTR_SEARCH_NPOS : two_way(hay, i - 1 + m, needle, m, true);
+            }
+        }
+        if (i < pattern->skip_rev[first]) break;
+    }
+    return DSTR_SEARCH_NPOS;
+}
+
+DStrPattern *dstr_pattern_create(const char *needle) {
+    assert(needle != NULL);
+
+    return dstr_pattern_create_n(needle, strlen(needle));
+}
+
+DStrPattern *dstr_pattern_create_n(const char *needle, const size_t needle_len) {
+    DStrPattern *pattern;
+    size_t i;
+
+    assert(needle != NULL);
+
+    pattern = malloc(sizeof(DStrPattern) + needle_len);
+    if (pattern == NULL) return NULL;
+
+    memcpy(pattern->needle, needle, needle_len);
+    pattern->len = needle_len;
+    pattern->skip = pattern->skip_rev = NULL;
+
+    if (needle_len == 0) {
+        pattern->strategy = PATTERN_EMPTY;
+    } else if (needle_len == 1) {
+        pattern->strategy = PATTERN_BYTE;
+    } else if (needle_len < PATTERN_HORSPOOL_MIN) {
+        pattern->strategy = PATTERN_FILTER;
+    } else {
+        pattern->skip = malloc(sizeof(size_t) * (UCHAR_MAX + 1) * 2);
+        if (pattern->skip == NULL) {
+            free(pattern);
+            return NULL;
+        }
+        pattern->skip_rev = pattern->skip + UCHAR_MAX + 1;
+
+        for (i = 0; i <= UCHAR_MAX; ++i) {
+            pattern->skip[i] = pattern->skip_rev[i] = needle_len;
+        }
+        for (i = 0; i < needle_len - 1; ++i) {
+            pattern->skip[pattern->needle[i]] = needle_len - 1 - i;
+        }
+        for (i = needle_len - 1; i > 0; --i) {
+            pattern->skip_rev[pattern->needle[i]] = i;
+        }
+        pattern->strategy = PATTERN_HORSPOOL;
+    }
+
+    return pattern;
+}
+
+void dstr_pattern_destroy(DStrPattern *pattern) {
+    assert(pattern != NULL);
+
+    free(pattern->skip);
+    free(pattern);
+}
+
+size_t dstr_pattern_length(const DStrPattern *pattern) {
+    assert(pattern != NULL);
+
+    return pattern->len;
+}
+
+const char *dstr_pattern_needle(const DStrPattern *pattern) {
+    assert(pattern != NULL);
+
+    return (const char *) pattern->needle;
+}
+
+size_t dstr_search_pattern_first(const DStrPattern *pattern, const char *hay, const size_t hay_len) {
+    const char *find;
+
+    if (pattern->len > hay_len) return DSTR_SEARCH_NPOS;
+
+    switch (pattern->strategy) {
+        case PATTERN_BYTE:
+            find = memchr(hay, pattern->needle[0], hay_len);
+            return find != NULL ? (size_t) (find - hay) : DSTR_SEARCH_NPOS;
+        case PATTERN_FILTER:
+            return dstr_search_first(hay, hay_len, (const char *) pattern->needle, pattern->len);
+        case PATTERN_HORSPOOL:
+            return horspool_first(pattern, (const unsigned char *) hay, hay_len);
+        default:
+            return DSTR_SEARCH_NPOS;
+    }
+}
+
+size_t dstr_search_pattern_last(const DStrPattern *pattern, const char *hay, const size_t hay_len) {
+    if (pattern->len > hay_len) return DSTR_SEARCH_NPOS;
+
+    switch (pattern->strategy) {
+        case PATTERN_BYTE:
+            return byte_last((const unsigned char *) hay, hay_len, pattern->needle[0]);
+        case PATTERN_FILTER:
+            return dstr_search_last(hay, hay_len, (const char *) pattern->needle, pattern->len);
+        case PATTERN_HORSPOOL:
+            return horspool_last(pattern, (const unsigned char *) hay, hay_len);
+        default:
+            return DSTR_SEARCH_NPOS;
+    }
+}
@@ -0,0 +1,72 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_SEARCH_H
+#define DSTR_SEARCH_H
+
+/**
+ * @file dstr_search.h
+ * @brief 库内部共用的子串查找与等值比较内核（不对外公开）
+ *
+ * 所有函数均按长度处理，不依赖 '\0' 结尾，可用于含 '\0' 的数据。
+ * x86-64 上使用 SSE2/AVX2 首尾字节过滤（运行时选择），其余平台使用标量过滤；
+ * 候选校验开销过大时切换到 Two-Way 算法，保证最坏情况下仍为线性时间。
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "dynamic_string.h"
+
+// 未找到时的返回值
+#define DSTR_SEARCH_NPOS SIZE_MAX
+
+/**
+ * 在 hay[0, hay_len) 中查找 needle 第一次出现的位置，needle_len 为 0 时返回 DSTR_SEARCH_NPOS。
+ */
+size_t dstr_search_first(
+    const char *hay,
+    size_t hay_len,
+    const char *needle,
+    size_t needle_len
+);
+
+/**
+ * 在 hay[0, hay_len) 中查找 needle 最后一次出现的位置，needle_len 为 0 时返回 DSTR_SEARCH_NPOS。
+ */
+size_t dstr_search_last(
+    const char *hay,
+    size_t hay_len,
+    const char *needle,
+    size_t needle_len
+);
+
+/**
+ * 比较 a[0, len) 与 b[0, len) 是否逐字节相等，a 与 b 相同时直接返回 true。
+ */
+bool dstr_search_equal(
+    const char *a,
+    const char *b,
+    size_t len
+);
+
+/**
+ * 使用预编译模式查找第一次出现的位置。
+ */
+size_t dstr_search_pattern_first(
+    const DStrPattern *pattern,
+    const char *hay,
+    size_t hay_len
+);
+
+/**
+ * 使用预编译模式查找最后一次出现的位置。
+ */
+size_t dstr_search_pattern_last(
+    const DStrPattern *pattern,
+    const char *hay,
+    size_t hay_len
+);
+
+#endif // DSTR_SEARCH_H
@@ -0,0 +1,220 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_THREADS_H
+#define DSTR_THREADS_H
+
+#include <stdbool.h>
+
+/**
+ * @file dstr_threads.h
+ * @brief 内部使用的线程原语适配层：互斥锁、一次性初始化与带析构的线程本地存储
+ *
+ * 依次选用 Win32、POSIX 线程与 C11 <threads.h>，都不可用（或定义了 DSTR_NO_THREADS）时
+ * DSTR_HAS_THREADS 为 0：互斥锁退化为空操作，线程本地存储不可用，调用者应关闭依赖它的功能。
+ * 线程本地存储的析构函数须以 DSTR_TSS_CALL 声明，以匹配 Win32 的回调调用约定。
+ */
+
+#if defined(DSTR_NO_THREADS)
+#  define DSTR_THREADS_NONE 1
+#elif defined(_WIN32)
+#  define DSTR_THREADS_WIN32 1
+#elif defined(__unix__) || defined(__APPLE__)
+#  define DSTR_THREADS_POSIX 1
+#elif !defined(__STDC_NO_THREADS__) && defined(__has_include)
+#  if __has_include(<threads.h>)
+#    define DSTR_THREADS_C11 1
+#  else
+#    define DSTR_THREADS_NONE 1
+#  endif
+#else
+#  define DSTR_THREADS_NONE 1
+#endif
+
+#if defined(DSTR_THREADS_NONE)
+#  define DSTR_HAS_THREADS 0
+#else
+#  define DSTR_HAS_THREADS 1
+#endif
+
+// 线程本地变量
+#if defined(_MSC_VER) && !defined(__clang__)
+#  define DSTR_THREAD_LOCAL __declspec(thread)
+#elif DSTR_HAS_THREADS
+#  define DSTR_THREAD_LOCAL _Thread_local
+#else
+#  define DSTR_THREAD_LOCAL
+#endif
+
+/*─────────────────────────────── Win32 ───────────────────────────────*/
+#if defined(DSTR_THREADS_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#define DSTR_TSS_CALL WINAPI
+#define DSTR_ONCE_INIT INIT_ONCE_STATIC_INIT
+
+typedef SRWLOCK DStrMutex;
+typedef INIT_ONCE DStrOnce;
+typedef DWORD DStrTss;
+
+typedef struct DStrOnceCall {
+    void (*fn)(void);
+} DStrOnceCall;
+
+static BOOL CALLBACK dstr_once_trampoline(PINIT_ONCE once, PVOID param, PVOID *context) {
+    (void) once;
+    (void) context;
+    ((DStrOnceCall *) param)->fn();
+    return TRUE;
+}
+
+static inline bool dstr_mutex_init(DStrMutex *mutex) {
+    InitializeSRWLock(mutex);
+    return true;
+}
+
+static inline void dstr_mutex_destroy(DStrMutex *mutex) {
+    (void) mutex;
+}
+
+static inline void dstr_mutex_lock(DStrMutex *mutex) {
+    AcquireSRWLockExclusive(mutex);
+}
+
+static inline void dstr_mutex_unlock(DStrMutex *mutex) {
+    ReleaseSRWLockExclusive(mutex);
+}
+
+static inline void dstr_once(DStrOnce *once, void (*fn)(void)) {
+    DStrOnceCall call = {fn};
+
+    InitOnceExecuteOnce(once, dstr_once_trampoline, &call, NULL);
+}
+
+// 使用纤程本地存储，它与线程本地存储不同，在线程退出时会调用析构函数
+static inline bool dstr_tss_create(DStrTss *key, void (DSTR_TSS_CALL *dtor)(void *)) {
+    *key = FlsAlloc(dtor);
+    return *key != FLS_OUT_OF_INDEXES;
+}
+
+static inline void dstr_tss_set(const DStrTss key, void *value) {
+    FlsSetValue(key, value);
+}
+
+/*─────────────────────────────── POSIX ───────────────────────────────*/
+#elif defined(DSTR_THREADS_POSIX)
+#include <pthread.h>
+
+#define DSTR_TSS_CALL
+#define DSTR_ONCE_INIT PTHREAD_ONCE_INIT
+
+typedef pthread_mutex_t DStrMutex;
+typedef pthread_once_t DStrOnce;
+typedef pthread_key_t DStrTss;
+
+static inline bool dstr_mutex_init(DStrMutex *mutex) {
+    return pthread_mutex_init(mutex, NULL) == 0;
+}
+
+static inline void dstr_mutex_destroy(DStrMutex *mutex) {
+    pthread_mutex_destroy(mutex);
+}
+
+static inline void dstr_mutex_lock(DStrMutex *mutex) {
+    pthread_mutex_lock(mutex);
+}
+
+static inline void dstr_mutex_unlock(DStrMutex *mutex) {
+    pthread_mutex_unlock(mutex);
+}
+
+static inline void dstr_once(DStrOnce *once, void (*fn)(void)) {
+    pthread_once(once, fn);
+}
+
+static inline bool dstr_tss_create(DStrTss *key, void (*dtor)(void *)) {
+    return pthread_key_create(key, dtor) == 0;
+}
+
+static inline void dstr_tss_set(const DStrTss key, void *value) {
+    pthread_setspecific(key, value);
+}
+
+/*─────────────────────────────── C11 ───────────────────────────────*/
+#elif defined(DSTR_THREADS_C11)
+#include <threads.h>
+
+#define DSTR_TSS_CALL
+#define DSTR_ONCE_INIT ONCE_FLAG_INIT
+
+typedef mtx_t DStrMutex;
+typedef once_flag DStrOnce;
+typedef tss_t DStrTss;
+
+static inline bool dstr_mutex_init(DStrMutex *mutex) {
+    return mtx_init(mutex, mtx_plain) == thrd_success;
+}
+
+static inline void dstr_mutex_destroy(DStrMutex *mutex) {
+    mtx_destroy(mutex);
+}
+
+static inline void dstr_mutex_lock(DStrMutex *mutex) {
+    mtx_lock(mutex);
+}
+
+static inline void dstr_mutex_unlock(DStrMutex *mutex) {
+    mtx_unlock(mutex);
+}
+
+static inline void dstr_once(DStrOnce *once, void (*fn)(void)) {
+    call_once(once, fn);
+}
+
+static inline bool dstr_tss_create(DStrTss *key, void (*dtor)(void *)) {
+    return tss_create(key, dtor) == thrd_success;
+}
+
+static inline void dstr_tss_set(const DStrTss key, void *value) {
+    tss_set(key, value);
+}
+
+/*─────────────────────────────── 无线程 ───────────────────────────────*/
+#else
+
+#define DSTR_TSS_CALL
+#define DSTR_ONCE_INIT false
+
+typedef char DStrMutex;
+typedef bool DStrOnce;
+
+static inline bool dstr_mutex_init(DStrMutex *mutex) {
+    (void) mutex;
+    return true;
+}
+
+static inline void dstr_mutex_destroy(DStrMutex *mutex) {
+    (void) mutex;
+}
+
+static inline void dstr_mutex_lock(DStrMutex *mutex) {
+    (void) mutex;
+}
+
+static inline void dstr_mutex_unlock(DStrMutex *mutex) {
+    (void) mutex;
+}
+
+static inline void dstr_once(DStrOnce *once, void (*fn)(void)) {
+    if (*once) return;
+    *once = true;
+    fn();
+}
+
+#endif
+
+#endif // DSTR_THREADS_H
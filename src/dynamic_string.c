@@ -3,418 +3,1466 @@
 //
 
 #include "dynamic_string.h"
+#include "dstr_matcher.h"
+#include "dstr_matcher_internal.h"
+#include "dstr_number.h"
+#include "dstr_search.h"
 #include <assert.h>
 #include <ctype.h>
+#include <limits.h>
+#include <stdalign.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <wchar.h>
 
 // ADT 类型定义
+// 存储分三级：短字符串直接存放在头部内（复用 data/cap/min_cap 的空间）；
+// 以单次分配方式创建的字符串，数据放在紧随头部的尾随存储中；超出后才转为独立的堆存储
+#define DSTR_FLAG_HEAP 0x01u // store.heap 有效，数据经指针访问
+#define DSTR_FLAG_TAIL 0x02u // store.heap.data 指向尾随存储，与头部同属一次分配，不可单独释放
+#define DSTR_FLAG_COUNTED 0x04u // store.heap.data 位于带引用计数的共享块中，可能与其他字符串共享
+#define DSTR_FLAG_COW 0x08u     // 写时复制：独立堆缓冲一律分配为共享块，克隆、复制时共享而不复制数据
+#define DSTR_FLAG_EMBEDDED 0x10u // 头部位于调用者提供的 DStrStorage 中，不由字符串释放
+
+#ifndef DSTR_PACKED_LAYOUT
+#define DSTR_PACKED_LAYOUT 0 // 非零时 dstr_create 等默认采用单次分配布局
+#endif
+
+#ifndef DSTR_COPY_ON_WRITE
+#define DSTR_COPY_ON_WRITE 0 // 非零时新建的字符串默认启用写时复制
+#endif
+
+// 增长策略与分配器的组合：每种组合全局只有一个实例，字符串头部只保存指向它的指针。
+// 实例以无锁链表串联，只增不减，发布后不再修改
+typedef struct StringTraits {
+    const DStrGrowthPolicy *policy; // NULL 表示跟随全局默认策略
+    const DStrAllocator *allocator; // 头部与数据均经由此分配器申请
+    const struct StringTraits *next;
+} StringTraits;
+
 struct DynamicString {
-    char *data;
     size_t len;
-    size_t cap;
-    size_t min_cap;
+    const StringTraits *traits;
+    union {
+        struct {
+            char *data;
+            size_t cap;
+            size_t min_cap;
+        } heap;
+        char sso[3 * sizeof(size_t)];
+    } store;
+    // 缓存的哈希值（分为高低两半，避免依赖 64 位原子操作），仅在 hash_valid 为真时有效
+    atomic_uint_least32_t hash_lo;
+    atomic_uint_least32_t hash_hi;
+    unsigned char flags;
+    atomic_bool hash_valid;
+    uint32_t tail_cap; // 尾随存储的容量，0 表示没有
+    char tail[];
 };
 
-// 静态函数定义
-// 调整一个「动态字符串」的容量
-static bool capacity_resize(DString *dstr, const size_t new_cap) {
-    char *new_cstr;
-    size_t adjusted_cap;
+#define SSO_CAP sizeof(((DString *) 0)->store.sso)
 
-    if (new_cap == 0) {
-        if (dstr->data != NULL) free(dstr->data);
-        *dstr = (DString)
-        {
-            0
-        };
-        return 0;
-    }
+static_assert(sizeof(DString) <= sizeof(DStrStorage) && alignof(DString) <= alignof(DStrStorage),
+              "DStrStorage 不足以容纳 DString 的头部");
 
-    adjusted_cap = new_cap > dstr->min_cap
-                       ? new_cap
-                       : dstr->min_cap;
+// 写时复制的共享块：引用计数之后紧跟字符数据，共享者各自记录相同的容量
+typedef struct SharedPayload {
+    atomic_size_t refs;
+    char data[];
+} SharedPayload;
 
-    adjusted_cap = adjusted_cap % sizeof(void *) == 0
-                       ? adjusted_cap
-                       : (adjusted_cap / sizeof(void *) + 1) * sizeof(void *);
+#define PAYLOAD_HEADER offsetof(SharedPayload, data)
 
-    new_cstr = (char *) realloc(dstr->data, adjusted_cap);
-    if (new_cstr == NULL) {
-        adjusted_cap = new_cap;
-        new_cstr = (char *) realloc(dstr->data, adjusted_cap);
-        if (new_cstr == NULL) {
-            return false;
-        }
-    }
+// 预置增长策略
+const DStrGrowthPolicy DSTR_GROWTH_EXACT = {100, 0, 100};
+const DStrGrowthPolicy DSTR_GROWTH_1_5X = {150, 0, 25};
+const DStrGrowthPolicy DSTR_GROWTH_2X = {200, 0, 25};
 
-    dstr->data = new_cstr;
-    dstr->cap = adjusted_cap;
+static const DStrGrowthPolicy *default_policy = &DSTR_GROWTH_1_5X;
+static const DStrAllocator *default_allocator = &DSTR_ALLOCATOR_LIBC;
 
-    if (adjusted_cap <= dstr->len) {
-        dstr->len -= dstr->len + 1 - adjusted_cap;
-        new_cstr[dstr->len] = '\0';
-    }
+static const StringTraits libc_traits = {NULL, &DSTR_ALLOCATOR_LIBC, NULL};
+static _Atomic(const StringTraits *) traits_list = &libc_traits;
 
-    return true;
+// 静态函数定义
+// 存储访问
+static inline bool is_heap(const DString *dstr) {
+    return (dstr->flags & DSTR_FLAG_HEAP) != 0;
 }
 
-// API 函数定义
-// 创建、销毁、清空
-DString *dstr_create(const char *cstr) {
-    DString *new_dstr;
-    size_t cstr_len;
+// 数据是否位于需要单独释放的堆缓冲中
+static inline bool owns_payload(const DString *dstr) {
+    return (dstr->flags & (DSTR_FLAG_HEAP | DSTR_FLAG_TAIL)) == DSTR_FLAG_HEAP;
+}
 
-    new_dstr = malloc(sizeof(DString));
-    if (new_dstr == NULL) return NULL;
+static inline bool is_counted(const DString *dstr) {
+    return (dstr->flags & DSTR_FLAG_COUNTED) != 0;
+}
 
-    *new_dstr = (DString){0};
+static inline SharedPayload *shared_of(const DString *dstr) {
+    return (SharedPayload *) (dstr->store.heap.data - PAYLOAD_HEADER);
+}
 
-    if (cstr != NULL && (cstr_len = strlen(cstr)) != 0) {
-        if (!capacity_resize(new_dstr, cstr_len + 1)) {
-            free(new_dstr);
-            return NULL;
-        }
-        memcpy(new_dstr->data, cstr, cstr_len);
-        new_dstr->data[new_dstr->len = cstr_len] = '\0';
-    }
-    return new_dstr;
+// 数据是否正与其他字符串共享，共享时写入前必须先复制出独占的一份
+static inline bool is_shared(const DString *dstr) {
+    return is_counted(dstr) && atomic_load_explicit(&shared_of(dstr)->refs, memory_order_acquire) > 1;
 }
 
-void dstr_destroy(DString *dstr) {
-    assert(dstr != NULL);
+// 哈希缓存：只读的字符串也会写入缓存，同一字符串可能在多个线程中同时计算，因此以原子操作访问。
+// 各线程写入的值相同，先写哈希值再以 release 发布有效标记，读取方以 acquire 检查标记；
+// 使缓存失效只发生在修改内容时，此时调用者本就独占该字符串
+static inline void hash_invalidate(DString *dstr) {
+    atomic_store_explicit(&dstr->hash_valid, false, memory_order_relaxed);
+}
+
+static inline bool hash_cached(const DString *dstr, uint64_t *out_hash) {
+    if (!atomic_load_explicit(&dstr->hash_valid, memory_order_acquire)) return false;
 
-    if (dstr->data != NULL) free(dstr->data);
-    free(dstr);
+    *out_hash = (uint64_t) atomic_load_explicit(&dstr->hash_hi, memory_order_relaxed) << 32 |
+                atomic_load_explicit(&dstr->hash_lo, memory_order_relaxed);
+    return true;
 }
 
-void dstr_clear(DString *dstr) {
-    assert(dstr != NULL);
+// 缓存不属于字符串的内容，对只读的字符串也可以写入
+static inline void hash_publish(const DString *dstr, const uint64_t hash) {
+    DString *cache;
 
-    if (dstr->data == NULL || dstr->len == 0) return;
+    cache = (DString *) dstr;
+    atomic_store_explicit(&cache->hash_lo, (uint32_t) hash, memory_order_relaxed);
+    atomic_store_explicit(&cache->hash_hi, (uint32_t) (hash >> 32), memory_order_relaxed);
+    atomic_store_explicit(&cache->hash_valid, true, memory_order_release);
+}
 
-    dstr->data[0] = '\0';
-    dstr->len = 0;
+// 取可写缓冲即意味着内容将被修改，缓存的哈希值随之失效
+static inline char *buf_of(DString *dstr) {
+    hash_invalidate(dstr);
+    return is_heap(dstr) ? dstr->store.heap.data : dstr->store.sso;
 }
 
-// 属性获取与设置
-const char *dstr_cstr(const DString *dstr) {
-    assert(dstr != NULL);
+static inline const char *cbuf_of(const DString *dstr) {
+    return is_heap(dstr) ? dstr->store.heap.data : dstr->store.sso;
+}
 
-    return dstr->data;
+static inline size_t cap_of(const DString *dstr) {
+    return is_heap(dstr) ? dstr->store.heap.cap : SSO_CAP;
 }
 
-size_t dstr_length(const DString *dstr) {
-    assert(dstr != NULL);
+static inline size_t min_cap_of(const DString *dstr) {
+    return is_heap(dstr) ? dstr->store.heap.min_cap : 0;
+}
 
-    return dstr->len;
+// 可用于存放内容的尾随存储容量：写时复制开启时长内容一律放在可共享的共享块中，不使用尾随存储
+static inline size_t tail_cap_of(const DString *dstr) {
+    return (dstr->flags & DSTR_FLAG_COW) == 0 ? dstr->tail_cap : 0;
 }
 
-size_t dstr_capacity(const DString *dstr) {
-    assert(dstr != NULL);
+// ptr[0, len) 是否落在「动态字符串」自身的缓冲内
+static bool aliases_buffer(const DString *dstr, const char *ptr, const size_t len) {
+    uintptr_t begin, end;
 
-    return dstr->cap;
+    begin = (uintptr_t) cbuf_of(dstr);
+    end = begin + cap_of(dstr);
+    return len != 0 && (uintptr_t) ptr < end && (uintptr_t) ptr + len > begin;
 }
 
-bool dstr_resize_capacity(DString *dstr, const size_t new_capacity) {
-    size_t old_min_cap;
+// ptr 落在扩容前的缓冲 [old_begin, old_end) 内时，换算到当前缓冲中的对应位置
+static const char *rebase_source(const DString *dstr, const uintptr_t old_begin, const uintptr_t old_end,
+                                 const char *ptr) {
+    if ((uintptr_t) ptr < old_begin || (uintptr_t) ptr >= old_end) return ptr;
 
-    assert(dstr != NULL);
+    return cbuf_of(dstr) + ((uintptr_t) ptr - old_begin);
+}
 
-    old_min_cap = dstr->min_cap;
-    dstr->min_cap = 0;
-    if (capacity_resize(dstr, new_capacity)) {
-        dstr->min_cap = new_capacity;
-        return true;
+// 追加 C 字符串片段时求其长度与复制来源：指向自身原内容 [0, old_len] 的片段换算到当前缓冲，
+// 其结尾的 '\0' 可能已被先追加的片段覆盖，因此只在原内容范围内求长度
+static size_t cstr_piece(const DString *dstr, const uintptr_t old_begin, const size_t old_len, const char *piece,
+                         const char **out_source) {
+    const char *source, *content_end, *nul;
+
+    if ((uintptr_t) piece < old_begin || (uintptr_t) piece > old_begin + old_len) {
+        *out_source = piece;
+        return strlen(piece);
     }
-    dstr->min_cap = old_min_cap;
-    return false;
-}
 
-// 复制、追加、插入、删除
-// 复制、追加、插入完整现有字符串到目标字符串
-bool dstr_cpy_cstr(DString *dest, const char *src) {
-    size_t src_len;
+    content_end = cbuf_of(dstr) + old_len;
+    source = cbuf_of(dstr) + ((uintptr_t) piece - old_begin);
+    nul = memchr(source, '\0', (size_t) (content_end - source));
+    *out_source = source;
+    return (size_t) ((nul != NULL ? nul : content_end) - source);
+}
 
-    assert(dest != NULL && src != NULL);
+// 取 policy 与 allocator 组合对应的实例，首次出现时创建；内存不足时返回 NULL
+static const StringTraits *traits_of(const DStrGrowthPolicy *policy, const DStrAllocator *allocator) {
+    const StringTraits *head, *found;
+    StringTraits *fresh;
 
-    src_len = strlen(src);
-    if (src_len == 0) return false;
+    head = atomic_load_explicit(&traits_list, memory_order_acquire);
+    for (found = head; found != NULL; found = found->next) {
+        if (found->policy == policy && found->allocator == allocator) return found;
+    }
 
-    if (capacity_resize(dest, src_len + 1)) {
-        memcpy(dest->data, src, src_len);
-        dest->data[dest->len = src_len] = '\0';
-        return true;
+    fresh = malloc(sizeof(StringTraits));
+    if (fresh == NULL) return NULL;
+    fresh->policy = policy;
+    fresh->allocator = allocator;
+    fresh->next = head;
+
+    // 其他线程可能同时加入了实例，交换失败时只需检查新加入的部分
+    while (!atomic_compare_exchange_weak_explicit(&traits_list, &fresh->next, fresh, memory_order_release,
+                                                  memory_order_acquire)) {
+        for (found = fresh->next; found != head; found = found->next) {
+            if (found->policy == policy && found->allocator == allocator) {
+                free(fresh);
+                return found;
+            }
+        }
+        head = fresh->next;
     }
-    return false;
+    return fresh;
 }
 
-bool dstr_cpy(DString *dest, const DString *src) {
-    assert(dest != NULL && src != NULL);
+static const DStrGrowthPolicy *policy_of(const DString *dstr) {
+    return dstr->traits->policy != NULL ? dstr->traits->policy : default_policy;
+}
 
-    // ReSharper disable once CppDFANullDereference
-    if (src->len == 0) return false;
-    if (capacity_resize(dest, src->len + 1)) {
-        memcpy(dest->data, src->data, src->len);
-        dest->data[dest->len = src->len] = '\0';
-        return true;
-    }
-    return false;
+static inline const DStrAllocator *allocator_of(const DString *dstr) {
+    return dstr->traits->allocator;
 }
 
-bool dstr_cat_cstr(DString *dest, const char *src) {
-    size_t src_len;
+// 经由字符串自身的分配器申请、调整与释放内存
+static inline void *mem_alloc(const DString *dstr, const size_t size) {
+    return allocator_of(dstr)->allocate(allocator_of(dstr)->ctx, size);
+}
 
-    assert(dest != NULL && src != NULL);
+static inline void *mem_realloc(const DString *dstr, void *ptr, const size_t old_size, const size_t new_size) {
+    return allocator_of(dstr)->reallocate(allocator_of(dstr)->ctx, ptr, old_size, new_size);
+}
 
-    src_len = strlen(src);
-    if (src_len == 0) return false;
-    if (capacity_resize(dest, dest->len + src_len + 1)) {
-        memcpy(dest->data + dest->len, src, src_len);
-        dest->data[dest->len += src_len] = '\0';
-        return true;
-    }
-    return false;
+static inline void mem_free(const DString *dstr, void *ptr, const size_t size) {
+    allocator_of(dstr)->deallocate(allocator_of(dstr)->ctx, ptr, size);
 }
 
-bool dstr_cat(DString *dest, const DString *src) {
-    assert(dest != NULL && src != NULL);
+// 独立堆缓冲的申请、调整与释放，返回数据指针；counted 为真时数据之前附带引用计数（初始为 1）
+static char *payload_alloc(const DString *dstr, const size_t cap, const bool counted) {
+    SharedPayload *shared;
 
-    if (src->len == 0) return false;
+    if (!counted) return (char *) mem_alloc(dstr, cap);
 
-    if (capacity_resize(dest, dest->len + src->len + 1)) {
-        memcpy(dest->data + dest->len, src->data, src->len);
-        dest->data[dest->len += src->len] = '\0';
-        return true;
-    }
-    return false;
+    shared = mem_alloc(dstr, PAYLOAD_HEADER + cap);
+    if (shared == NULL) return NULL;
+    atomic_init(&shared->refs, 1);
+    return shared->data;
 }
 
-bool dstr_insert_cstr(DString *dest, const char *src, const size_t index) {
-    size_t src_len;
+static char *payload_realloc(const DString *dstr, char *data, const size_t old_cap, const size_t new_cap,
+                             const bool counted) {
+    SharedPayload *shared;
 
-    assert(dest != NULL && src != NULL);
+    if (!counted) return (char *) mem_realloc(dstr, data, old_cap, new_cap);
 
-    if (index > dest->len) return false;
-    src_len = strlen(src);
-    if (src_len == 0) return false;
+    shared = mem_realloc(dstr, data - PAYLOAD_HEADER, PAYLOAD_HEADER + old_cap, PAYLOAD_HEADER + new_cap);
+    return shared != NULL ? shared->data : NULL;
+}
 
-    if (capacity_resize(dest, dest->len + src_len + 1)) {
-        if (index < dest->len) {
-            memmove(dest->data + index + src_len,
-                    dest->data + index,
-                    dest->len - index
-            );
-        }
-        memcpy(dest->data + index, src, src_len);
-        dest->data[dest->len += src_len] = '\0';
-        return true;
+static void payload_free(const DString *dstr, char *data, const size_t cap, const bool counted) {
+    if (counted) {
+        mem_free(dstr, data - PAYLOAD_HEADER, PAYLOAD_HEADER + cap);
+    } else {
+        mem_free(dstr, data, cap);
     }
-    return false;
 }
 
-bool dstr_insert(DString *dest, const DString *src, const size_t index) {
-    assert(dest != NULL && src != NULL);
+// 放弃当前的独立堆缓冲：普通缓冲直接释放，共享块在最后一个引用放弃时释放
+static void payload_release(DString *dstr) {
+    if (!owns_payload(dstr)) return;
+    if (is_counted(dstr) && atomic_fetch_sub_explicit(&shared_of(dstr)->refs, 1, memory_order_acq_rel) != 1) return;
 
-    if (index > dest->len || src->len == 0) return 0;
+    payload_free(dstr, dstr->store.heap.data, dstr->store.heap.cap, is_counted(dstr));
+}
 
-    if (capacity_resize(dest, dest->len + src->len + 1)) {
-        if (index < dest->len) {
-            memmove(dest->data + index + src->len,
-                    dest->data + index,
-                    dest->len - index
-            );
-        }
-        memcpy(dest->data + index, src->data, src->len);
-        dest->data[dest->len += src->len] = '\0';
-        return true;
-    }
-    return false;
+static inline size_t round_to_pointer(const size_t size) {
+    return size % sizeof(void *) == 0
+               ? size
+               : (size / sizeof(void *) + 1) * sizeof(void *);
 }
 
-// 复制、追加、插入现有字符串的子串到目标字符串
-bool dstr_cpy_sub_cstr(DString *dest, const char *src, const size_t sub_index, const size_t sub_count) {
-    size_t src_len, sub_len;
+// 按策略从 cap 扩大到至少 needed 的目标容量
+static size_t growth_target(const DStrGrowthPolicy *policy, const size_t cap, const size_t needed) {
+    size_t target;
 
-    assert(dest != NULL && src != NULL);
+    if (policy->growth_percent <= 100 || cap > SIZE_MAX / policy->growth_percent) return needed;
 
-    src_len = strlen(src);
-    if (sub_index >= src_len || sub_index + sub_count > src_len) return false;
+    target = cap * policy->growth_percent / 100;
+    if (policy->max_growth != 0 && target - cap > policy->max_growth) {
+        target = cap + policy->max_growth;
+    }
 
-    sub_len = sub_count == 0 ? src_len - sub_index : sub_count;
+    return target > needed ? target : needed;
+}
 
-    if (capacity_resize(dest, sub_len + 1)) {
-        memcpy(dest->data, src + sub_index, sub_len);
-        dest->data[dest->len = sub_len] = '\0';
-        return true;
-    }
-    return false;
+// 将 dstr 初始化为使用 traits 的空字符串头部
+static void header_init(DString *dstr, const StringTraits *traits, const unsigned char flags) {
+    *dstr = (DString){0};
+    dstr->traits = traits;
+    dstr->flags = (unsigned char) (flags | (DSTR_COPY_ON_WRITE ? DSTR_FLAG_COW : 0));
 }
 
-bool dstr_cpy_sub(DString *dest, const DString *src, const size_t sub_index, const size_t sub_count) {
-    size_t sub_len;
+// 从 allocator 分配一个空字符串头部；tail_cap 超过内嵌缓冲时在头部之后一并预留尾随存储
+static DString *header_alloc(const DStrAllocator *allocator, size_t tail_cap) {
+    const StringTraits *traits;
+    DString *new_dstr;
 
-    assert(dest != NULL && src != NULL);
+    if (allocator == NULL) allocator = default_allocator;
+    traits = traits_of(NULL, allocator);
+    if (traits == NULL) return NULL;
+    // 默认开启写时复制时尾随存储不会被使用，不必预留
+    tail_cap = !DSTR_COPY_ON_WRITE && tail_cap > SSO_CAP && tail_cap <= UINT32_MAX ? round_to_pointer(tail_cap) : 0;
 
-    if (sub_index >= src->len || sub_index + sub_count > src->len) return false;
+    new_dstr = allocator->allocate(allocator->ctx, sizeof(DString) + tail_cap);
+    if (new_dstr == NULL) return NULL;
 
-    sub_len = sub_count == 0 ? src->len - sub_index : sub_count;
+    header_init(new_dstr, traits, 0);
+    new_dstr->tail_cap = (uint32_t) tail_cap;
+    return new_dstr;
+}
 
-    if (capacity_resize(dest, sub_len + 1)) {
-        memcpy(dest->data, src->data + sub_index, sub_len);
-        dest->data[dest->len = sub_len] = '\0';
-        return true;
-    }
-    return false;
+static void header_free(DString *dstr) {
+    if (dstr->flags & DSTR_FLAG_EMBEDDED) return;
+
+    mem_free(dstr, dstr, sizeof(DString) + dstr->tail_cap);
 }
 
-bool dstr_cat_sub_cstr(DString *dest, const char *src, const size_t sub_index, const size_t sub_count) {
-    size_t src_len, sub_len;
+// 将内容搬回头部内嵌缓冲，必要时截断
+static void storage_to_inline(DString *dstr) {
+    char inline_buf[SSO_CAP];
 
-    assert(dest != NULL && src != NULL);
+    if (dstr->len >= SSO_CAP) dstr->len = SSO_CAP - 1;
 
-    src_len = strlen(src);
-    if (sub_index >= src_len || sub_index + sub_count > src_len) return false;
+    // 内嵌缓冲与堆指针共用空间，先暂存内容再释放原缓冲
+    memcpy(inline_buf, dstr->store.heap.data, dstr->len);
+    payload_release(dstr);
 
-    sub_len = sub_count == 0 ? src_len - sub_index : sub_count;
+    memcpy(dstr->store.sso, inline_buf, dstr->len);
+    dstr->store.sso[dstr->len] = '\0';
+    dstr->flags &= ~(DSTR_FLAG_HEAP | DSTR_FLAG_TAIL | DSTR_FLAG_COUNTED);
+    hash_invalidate(dstr);
+}
 
-    if (capacity_resize(dest, dest->len + sub_count + 1)) {
-        memcpy(dest->data + dest->len, src + sub_index, sub_len);
-        dest->data[dest->len += src_len] = '\0';
-        return true;
+// 将内容搬到尾随存储，必要时截断
+static void storage_to_tail(DString *dstr) {
+    if (dstr->len >= dstr->tail_cap) dstr->len = dstr->tail_cap - 1;
+
+    memcpy(dstr->tail, buf_of(dstr), dstr->len);
+    dstr->tail[dstr->len] = '\0';
+
+    if (is_heap(dstr)) {
+        payload_release(dstr);
+    } else {
+        dstr->store.heap.min_cap = 0;
     }
-    return false;
+    dstr->store.heap.data = dstr->tail;
+    dstr->store.heap.cap = dstr->tail_cap;
+    dstr->flags = (dstr->flags | DSTR_FLAG_HEAP | DSTR_FLAG_TAIL) & ~DSTR_FLAG_COUNTED;
 }
 
-bool dstr_cat_sub(DString *dest, const DString *src, const size_t sub_index, const size_t sub_count) {
-    size_t sub_len;
+// 调整一个「动态字符串」的容量
+// 依次优先使用头部内嵌缓冲、尾随存储，都放不下时才使用独立的堆缓冲
+static bool capacity_resize(DString *dstr, const size_t new_cap) {
+    char *new_cstr;
+    size_t adjusted_cap;
+    bool counted;
 
-    assert(dest != NULL && src != NULL);
+    if (new_cap == 0) {
+        payload_release(dstr);
+        dstr->flags &= ~(DSTR_FLAG_HEAP | DSTR_FLAG_TAIL | DSTR_FLAG_COUNTED);
+        hash_invalidate(dstr);
+        dstr->store.sso[0] = '\0';
+        dstr->len = 0;
+        return 0;
+    }
 
-    if (sub_index >= src->len || sub_index + sub_count > src->len) return false;
+    adjusted_cap = new_cap > min_cap_of(dstr)
+                       ? new_cap
+                       : min_cap_of(dstr);
 
-    sub_len = sub_count == 0 ? src->len - sub_index : sub_count;
+    if (adjusted_cap <= SSO_CAP) {
+        if (is_heap(dstr)) {
+            storage_to_inline(dstr);
+        }
+    } else if (adjusted_cap <= tail_cap_of(dstr)) {
+        if ((dstr->flags & DSTR_FLAG_TAIL) == 0) {
+            storage_to_tail(dstr);
+        }
+        adjusted_cap = dstr->tail_cap;
+    } else {
+        adjusted_cap = round_to_pointer(adjusted_cap);
+
+        if (owns_payload(dstr) && !is_shared(dstr)) {
+            counted = is_counted(dstr);
+            new_cstr = payload_realloc(dstr, dstr->store.heap.data, dstr->store.heap.cap, adjusted_cap, counted);
+            if (new_cstr == NULL) {
+                adjusted_cap = new_cap;
+                new_cstr = payload_realloc(dstr, dstr->store.heap.data, dstr->store.heap.cap, adjusted_cap, counted);
+                if (new_cstr == NULL) {
+                    return false;
+                }
+            }
+        } else {
+            // 从内嵌缓冲、尾随存储或共享块复制出新的独立缓冲
+            counted = (dstr->flags & DSTR_FLAG_COW) != 0;
+            new_cstr = payload_alloc(dstr, adjusted_cap, counted);
+            if (new_cstr == NULL) {
+                adjusted_cap = new_cap;
+                new_cstr = payload_alloc(dstr, adjusted_cap, counted);
+                if (new_cstr == NULL) {
+                    return false;
+                }
+            }
+            memcpy(new_cstr, buf_of(dstr), dstr->len < adjusted_cap ? dstr->len + 1 : adjusted_cap);
+            if (is_heap(dstr)) {
+                payload_release(dstr);
+            } else {
+                dstr->store.heap.min_cap = 0;
+            }
+            dstr->flags = (dstr->flags | DSTR_FLAG_HEAP) & ~(DSTR_FLAG_TAIL | DSTR_FLAG_COUNTED);
+            if (counted) dstr->flags |= DSTR_FLAG_COUNTED;
+        }
 
-    if (capacity_resize(dest, dest->len + sub_len + 1)) {
-        memcpy(dest->data + dest->len, src->data + sub_index, sub_len);
-        dest->data[dest->len += sub_len] = '\0';
-        return true;
+        dstr->store.heap.data = new_cstr;
+        dstr->store.heap.cap = adjusted_cap;
     }
-    return false;
+
+    if (adjusted_cap <= dstr->len) {
+        dstr->len -= dstr->len + 1 - adjusted_cap;
+        buf_of(dstr)[dstr->len] = '\0';
+    }
+
+    return true;
 }
 
-bool dstr_insert_sub_cstr(DString *dest, const char *src, const size_t index, const size_t sub_index,
-                          const size_t sub_count) {
-    size_t src_len, sub_len;
+// 按增长策略确保容量可容纳 needed 字节（含 '\0'）：
+// 不足时按倍率扩容，空闲低于收缩阈值时才收缩，其余情况不触碰分配器
+static bool capacity_fit(DString *dstr, const size_t needed) {
+    const DStrGrowthPolicy *policy;
+    size_t cap, target;
 
-    assert(dest != NULL && src != NULL);
+    cap = cap_of(dstr);
+    if (needed <= cap && !is_heap(dstr)) return true;
 
-    if (index > dest->len) return false;
-    src_len = strlen(src);
-    if (sub_index >= src_len || sub_index + sub_count > src_len) return false;
+    policy = policy_of(dstr);
 
-    sub_len = sub_count == 0 ? src_len - sub_index : sub_count;
+    // 与其他字符串共享数据时，复制出独占的一份并顺带完成扩容
+    if (is_shared(dstr)) {
+        target = needed > cap ? growth_target(policy, cap, needed) : cap;
+        return capacity_resize(dstr, target) || (target > needed && capacity_resize(dstr, needed));
+    }
 
-    if (capacity_resize(dest, dest->len + sub_len + 1)) {
-        if (index < dest->len) {
-            memmove(dest->data + index + sub_len,
-                    dest->data + index,
-                    dest->len - index
-            );
-        }
-        memcpy(dest->data + index, src + sub_index, sub_len);
-        dest->data[dest->len += sub_len] = '\0';
+    if (needed > cap) {
+        target = growth_target(policy, cap, needed);
+        // 预留余量失败时退回到精确分配
+        return capacity_resize(dstr, target) || (target > needed && capacity_resize(dstr, needed));
+    }
+
+    // 两侧的乘积都可能溢出，溢出时不收缩（此时字符串已接近地址空间上限）
+    if (policy->shrink_percent == 0 || cap > SIZE_MAX / policy->shrink_percent || needed > SIZE_MAX / 100 ||
+        needed * 100 >= cap * policy->shrink_percent) {
         return true;
     }
-    return false;
+
+    target = growth_target(policy, needed, needed);
+    if (target < min_cap_of(dstr)) target = min_cap_of(dstr);
+    if (target >= cap) return true;
+
+    return capacity_resize(dstr, target);
 }
 
-bool dstr_insert_sub(DString *dest, const DString *src, const size_t index, const size_t sub_index,
-                     const size_t sub_count) {
-    size_t sub_len;
+// 原地写入前确保数据未与其他字符串共享
+static bool payload_make_unique(DString *dstr) {
+    return !is_shared(dstr) || capacity_resize(dstr, cap_of(dstr));
+}
 
-    assert(dest != NULL && src != NULL);
+// src 的数据能否以写时复制的方式共享给使用 allocator 的字符串
+static bool payload_shareable(const DString *src, const DStrAllocator *allocator) {
+    return (src->flags & DSTR_FLAG_COW) != 0 && is_counted(src) && allocator_of(src) == allocator;
+}
 
-    if (index > dest->len) return false;
-    if (sub_index >= src->len || sub_index + sub_count > src->len) return false;
+// 让 dest 与 src 共享同一个共享块，dest 原有的数据被释放
+static void payload_share(DString *dest, const DString *src) {
+    uint64_t hash;
+    size_t min_cap;
 
-    sub_len = sub_count == 0 ? src->len - sub_index : sub_count;
+    atomic_fetch_add_explicit(&shared_of(src)->refs, 1, memory_order_relaxed);
 
-    if (capacity_resize(dest, dest->len + sub_len + 1)) {
-        if (index < dest->len) {
-            memmove(dest->data + index + sub_len,
-                    dest->data + index,
-                    dest->len - index
-            );
-        }
-        memcpy(dest->data + index, src->data + sub_index, sub_len);
-        dest->data[dest->len += sub_len] = '\0';
-        return true;
+    min_cap = min_cap_of(dest);
+    if (is_heap(dest)) payload_release(dest);
+
+    dest->store.heap.data = src->store.heap.data;
+    dest->store.heap.cap = src->store.heap.cap;
+    dest->store.heap.min_cap = min_cap;
+    dest->flags = (dest->flags | DSTR_FLAG_HEAP | DSTR_FLAG_COUNTED | DSTR_FLAG_COW) & ~DSTR_FLAG_TAIL;
+    dest->len = src->len;
+    if (hash_cached(src, &hash)) {
+        hash_publish(dest, hash);
+    } else {
+        hash_invalidate(dest);
     }
-    return false;
 }
 
-// 删除子串
-void dstr_remove(DString *dstr, const size_t sub_index, const size_t sub_count) {
-    size_t sub_len;
+// 向刚初始化的空字符串头部写入初始内容 data[0, len)
+static bool fill_from(DString *dstr, const char *data, const size_t len) {
+    if (len == 0) return true;
+    if (!capacity_resize(dstr, len + 1)) return false;
 
-    assert(dstr != NULL);
+    memcpy(buf_of(dstr), data, len);
+    buf_of(dstr)[dstr->len = len] = '\0';
+    return true;
+}
 
-    if (sub_index >= dstr->len || sub_index + sub_count > dstr->len) return;
+// 以 data[0, len) 为内容创建字符串，tail_cap 为尾随存储的容量
+static DString *create_from(const char *data, const size_t len, const DStrAllocator *allocator,
+                            const size_t tail_cap) {
+    DString *new_dstr;
 
-    sub_len = sub_count == 0 ? dstr->len - sub_index : sub_count;
-    if (sub_count != 0 && sub_index + sub_count < dstr->len) {
-        memmove(dstr->data + sub_index,
-                dstr->data + sub_index + sub_count,
-                dstr->len - sub_index - sub_count
-        );
+    new_dstr = header_alloc(allocator, tail_cap);
+    if (new_dstr == NULL) return NULL;
+
+    if (!fill_from(new_dstr, data, len)) {
+        header_free(new_dstr);
+        return NULL;
     }
+    return new_dstr;
+}
+
+// 按字节（无符号）比较，公共前缀相同时较短者较小
+static int compare_bytes(const char *a, const size_t a_len, const char *b, const size_t b_len) {
+    int result;
+
+    if (a == b && a_len == b_len) return 0;
 
-    dstr->data[dstr->len -= sub_len] = '\0';
-    capacity_resize(dstr, dstr->len + 1);
+    result = a_len != 0 && b_len != 0 ? memcmp(a, b, a_len < b_len ? a_len : b_len) : 0;
+    if (result != 0) return result;
+    return a_len < b_len ? -1 : a_len > b_len;
 }
 
-// 删除特定内容
-void dstr_trim(DString *dstr) {
-    char *find;
-    size_t space_len;
+// 在 index 处插入 data[0, len)，data 可以指向 dest 自身的内容
+static bool insert_bytes(DString *dest, const char *data, const size_t len, const size_t index) {
+    size_t offset, before;
+    bool aliased;
 
-    assert(dstr != NULL);
+    aliased = aliases_buffer(dest, data, len);
+    offset = aliased ? (size_t) (data - cbuf_of(dest)) : 0;
 
-    if (dstr->len == 0) return;
+    if (!capacity_fit(dest, dest->len + len + 1)) return false;
 
-    // 去除前导空白字符
-    for (find = dstr->data;
-         find < dstr->data + dstr->len;
-         ++find
-    ) {
-        if (!isspace(*find)) break;
+    if (index < dest->len) {
+        memmove(buf_of(dest) + index + len, buf_of(dest) + index, dest->len - index);
     }
 
-    if (find > dstr->data) {
-        space_len = find - dstr->data;
-        memmove(dstr->data, find, dstr->len - space_len);
-        dstr->data[dstr->len -= space_len] = '\0';
+    if (aliased) {
+        // 源内容中位于 index 之前的部分未移动，其余部分已后移 len 字节
+        before = offset < index ? (index - offset < len ? index - offset : len) : 0;
+        memcpy(buf_of(dest) + index, buf_of(dest) + offset, before);
+        memcpy(buf_of(dest) + index + before, buf_of(dest) + offset + before + len, len - before);
+    } else {
+        memcpy(buf_of(dest) + index, data, len);
     }
+    buf_of(dest)[dest->len += len] = '\0';
+    return true;
+}
 
-    for (find = dstr->data + dstr->len - 1;
-         find >= dstr->data;
-         --find) {
-        if (!isspace(*find)) break;
-    }
+// API 函数定义
+// 创建、销毁、清空
+DString *dstr_create(const char *cstr) {
+    return dstr_create_with_allocator(cstr, NULL);
+}
 
-    if (find < dstr->data + dstr->len - 1) {
-        space_len = dstr->data + dstr->len - 1 - find;
-        dstr->data[dstr->len -= space_len] = '\0';
-    }
+DString *dstr_create_with_allocator(const char *cstr, const DStrAllocator *allocator) {
+    size_t cstr_len;
 
-    capacity_resize(dstr, dstr->len + 1);
+    cstr_len = cstr != NULL ? strlen(cstr) : 0;
+    return create_from(cstr, cstr_len, allocator, DSTR_PACKED_LAYOUT ? cstr_len + 1 : 0);
 }
 
-// 格式化写入
-bool dstr_printf(DString *dstr, const char *format, ...) {
+DString *dstr_create_n(const char *data, const size_t len) {
+    assert(data != NULL || len == 0);
+
+    return create_from(data, len, NULL, DSTR_PACKED_LAYOUT ? len + 1 : 0);
+}
+
+DString *dstr_create_packed(const char *cstr, const size_t capacity) {
+    return dstr_create_packed_with_allocator(cstr, capacity, NULL);
+}
+
+DString *dstr_create_packed_with_allocator(const char *cstr, const size_t capacity,
+                                           const DStrAllocator *allocator) {
+    size_t cstr_len;
+
+    cstr_len = cstr != NULL ? strlen(cstr) : 0;
+    return create_from(cstr, cstr_len, allocator, capacity > cstr_len ? capacity : cstr_len + 1);
+}
+
+void dstr_destroy(DString *dstr) {
+    assert(dstr != NULL);
+
+    payload_release(dstr);
+    header_free(dstr);
+}
+
+void dstr_clear(DString *dstr) {
+    assert(dstr != NULL);
+
+    if (dstr->len == 0) return;
+
+    // 共享的数据不能原地改写，直接放弃
+    if (is_shared(dstr)) {
+        capacity_resize(dstr, 0);
+        return;
+    }
+
+    buf_of(dstr)[0] = '\0';
+    dstr->len = 0;
+}
+
+// 在调用者提供的存储上初始化、清理
+DString *dstr_init(DStrStorage *storage, const char *cstr) {
+    return dstr_init_with_allocator(storage, cstr, NULL);
+}
+
+DString *dstr_init_with_allocator(DStrStorage *storage, const char *cstr, const DStrAllocator *allocator) {
+    const StringTraits *traits;
+    DString *dstr;
+
+    assert(storage != NULL);
+
+    traits = traits_of(NULL, allocator != NULL ? allocator : default_allocator);
+    if (traits == NULL) return NULL;
+
+    dstr = (DString *) storage;
+    header_init(dstr, traits, DSTR_FLAG_EMBEDDED);
+    return fill_from(dstr, cstr, cstr != NULL ? strlen(cstr) : 0) ? dstr : NULL;
+}
+
+void dstr_fini(DString *dstr) {
+    assert(dstr != NULL && (dstr->flags & DSTR_FLAG_EMBEDDED) != 0);
+
+    payload_release(dstr);
+    dstr->flags &= ~(DSTR_FLAG_HEAP | DSTR_FLAG_TAIL | DSTR_FLAG_COUNTED);
+    hash_invalidate(dstr);
+    dstr->store.sso[0] = '\0';
+    dstr->len = 0;
+}
+
+// 缓冲所有权转移
+DString *dstr_adopt(char *buf, const size_t len, const size_t cap) {
+    return dstr_adopt_with_allocator(buf, len, cap, NULL);
+}
+
+DString *dstr_adopt_with_allocator(char *buf, const size_t len, const size_t cap,
+                                   const DStrAllocator *allocator) {
+    DString *new_dstr;
+
+    assert(buf != NULL && len < cap);
+
+    new_dstr = header_alloc(allocator, 0);
+    if (new_dstr == NULL) return NULL;
+
+    // 接管的缓冲没有引用计数，克隆时即便启用了写时复制也会复制数据，直到下一次重新分配
+    new_dstr->store.heap.data = buf;
+    new_dstr->store.heap.cap = cap;
+    new_dstr->store.heap.min_cap = 0;
+    new_dstr->flags |= DSTR_FLAG_HEAP;
+    buf[new_dstr->len = len] = '\0';
+    return new_dstr;
+}
+
+char *dstr_release(DString *dstr, size_t *out_len, size_t *out_cap) {
+    char *buf;
+    size_t cap;
+
+    assert(dstr != NULL);
+
+    if (owns_payload(dstr) && !is_shared(dstr)) {
+        buf = dstr->store.heap.data;
+        cap = dstr->store.heap.cap;
+        if (is_counted(dstr)) {
+            // 独占的共享块去掉引用计数，数据前移到块首，整个块交给调用者
+            buf = (char *) shared_of(dstr);
+            memmove(buf, dstr->store.heap.data, dstr->len + 1);
+            cap += PAYLOAD_HEADER;
+        }
+    } else {
+        cap = dstr->len + 1;
+        buf = mem_alloc(dstr, cap);
+        if (buf == NULL) return NULL;
+        memcpy(buf, cbuf_of(dstr), cap);
+        payload_release(dstr);
+    }
+
+    if (out_len != NULL) *out_len = dstr->len;
+    if (out_cap != NULL) *out_cap = cap;
+    header_free(dstr);
+    return buf;
+}
+
+// 属性获取与设置
+const char *dstr_cstr(const DString *dstr) {
+    assert(dstr != NULL);
+
+    return cbuf_of(dstr);
+}
+
+size_t dstr_length(const DString *dstr) {
+    assert(dstr != NULL);
+
+    return dstr->len;
+}
+
+size_t dstr_capacity(const DString *dstr) {
+    assert(dstr != NULL);
+
+    return cap_of(dstr);
+}
+
+bool dstr_resize_capacity(DString *dstr, const size_t new_capacity) {
+    size_t old_min_cap;
+
+    assert(dstr != NULL);
+
+    old_min_cap = min_cap_of(dstr);
+    if (is_heap(dstr)) dstr->store.heap.min_cap = 0;
+    if (capacity_resize(dstr, new_capacity)) {
+        // 内嵌存储的容量固定，无需记录下限
+        if (is_heap(dstr)) dstr->store.heap.min_cap = new_capacity;
+        return true;
+    }
+    if (is_heap(dstr)) dstr->store.heap.min_cap = old_min_cap;
+    return false;
+}
+
+// 分配器
+void dstr_set_default_allocator(const DStrAllocator *allocator) {
+    default_allocator = allocator != NULL ? allocator : &DSTR_ALLOCATOR_LIBC;
+}
+
+const DStrAllocator *dstr_default_allocator(void) {
+    return default_allocator;
+}
+
+const DStrAllocator *dstr_allocator(const DString *dstr) {
+    assert(dstr != NULL);
+
+    return allocator_of(dstr);
+}
+
+// 增长策略
+void dstr_set_default_growth_policy(const DStrGrowthPolicy *policy) {
+    default_policy = policy != NULL ? policy : &DSTR_GROWTH_1_5X;
+}
+
+const DStrGrowthPolicy *dstr_default_growth_policy(void) {
+    return default_policy;
+}
+
+bool dstr_set_growth_policy(DString *dstr, const DStrGrowthPolicy *policy) {
+    const StringTraits *traits;
+
+    assert(dstr != NULL);
+
+    traits = traits_of(policy, allocator_of(dstr));
+    if (traits == NULL) return false;
+
+    dstr->traits = traits;
+    return true;
+}
+
+const DStrGrowthPolicy *dstr_growth_policy(const DString *dstr) {
+    assert(dstr != NULL);
+
+    return policy_of(dstr);
+}
+
+// 写时复制
+bool dstr_set_copy_on_write(DString *dstr, const bool enable) {
+    char *shared_data;
+
+    assert(dstr != NULL);
+
+    if (!enable) {
+        // 已共享的数据仍按引用计数释放，此后新分配的缓冲不再带计数
+        dstr->flags &= ~DSTR_FLAG_COW;
+        return true;
+    }
+
+    // 已有的普通堆缓冲或尾随存储中的内容转为共享块，之后的克隆才能直接共享
+    if (is_heap(dstr) && !is_counted(dstr)) {
+        shared_data = payload_alloc(dstr, dstr->store.heap.cap, true);
+        if (shared_data == NULL) return false;
+        memcpy(shared_data, dstr->store.heap.data, dstr->len + 1);
+        if (owns_payload(dstr)) mem_free(dstr, dstr->store.heap.data, dstr->store.heap.cap);
+        dstr->store.heap.data = shared_data;
+        dstr->flags = (dstr->flags | DSTR_FLAG_COUNTED) & ~DSTR_FLAG_TAIL;
+    }
+    dstr->flags |= DSTR_FLAG_COW;
+    return true;
+}
+
+bool dstr_copy_on_write(const DString *dstr) {
+    assert(dstr != NULL);
+
+    return (dstr->flags & DSTR_FLAG_COW) != 0;
+}
+
+bool dstr_is_shared(const DString *dstr) {
+    assert(dstr != NULL);
+
+    return is_shared(dstr);
+}
+
+// 复制、追加、插入、删除
+// 复制、追加、插入完整现有字符串到目标字符串
+bool dstr_cpy_cstr(DString *dest, const char *src) {
+    size_t src_len;
+
+    assert(dest != NULL && src != NULL);
+
+    src_len = strlen(src);
+    if (src_len == 0) return false;
+
+    if (capacity_fit(dest, src_len + 1)) {
+        memcpy(buf_of(dest), src, src_len);
+        buf_of(dest)[dest->len = src_len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_cpy(DString *dest, const DString *src) {
+    assert(dest != NULL && src != NULL);
+
+    // ReSharper disable once CppDFANullDereference
+    if (src->len == 0) return false;
+    if (dest == src) return true;
+
+    if (payload_shareable(src, allocator_of(dest))) {
+        payload_share(dest, src);
+        return true;
+    }
+
+    if (capacity_fit(dest, src->len + 1)) {
+        memcpy(buf_of(dest), cbuf_of(src), src->len);
+        buf_of(dest)[dest->len = src->len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_cat_cstr(DString *dest, const char *src) {
+    size_t src_len;
+
+    assert(dest != NULL && src != NULL);
+
+    src_len = strlen(src);
+    if (src_len == 0) return false;
+    if (capacity_fit(dest, dest->len + src_len + 1)) {
+        memcpy(buf_of(dest) + dest->len, src, src_len);
+        buf_of(dest)[dest->len += src_len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_cat_n(DString *dest, const char *data, const size_t len) {
+    size_t offset;
+    bool aliased;
+
+    assert(dest != NULL && data != NULL);
+
+    if (len == 0) return false;
+
+    // data 位于自身缓冲内时，扩容后按偏移重新定位
+    aliased = aliases_buffer(dest, data, len);
+    offset = aliased ? (size_t) (data - cbuf_of(dest)) : 0;
+
+    if (capacity_fit(dest, dest->len + len + 1)) {
+        memcpy(buf_of(dest) + dest->len, aliased ? buf_of(dest) + offset : data, len);
+        buf_of(dest)[dest->len += len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_cat(DString *dest, const DString *src) {
+    assert(dest != NULL && src != NULL);
+
+    if (src->len == 0) return false;
+
+    if (capacity_fit(dest, dest->len + src->len + 1)) {
+        memcpy(buf_of(dest) + dest->len, cbuf_of(src), src->len);
+        buf_of(dest)[dest->len += src->len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_insert_cstr(DString *dest, const char *src, const size_t index) {
+    size_t src_len;
+
+    assert(dest != NULL && src != NULL);
+
+    if (index > dest->len) return false;
+    src_len = strlen(src);
+    if (src_len == 0) return false;
+
+    return insert_bytes(dest, src, src_len, index);
+}
+
+bool dstr_insert(DString *dest, const DString *src, const size_t index) {
+    assert(dest != NULL && src != NULL);
+
+    if (index > dest->len || src->len == 0) return false;
+
+    return insert_bytes(dest, cbuf_of(src), src->len, index);
+}
+
+// 复制、追加、插入现有字符串的子串到目标字符串
+bool dstr_cpy_sub_cstr(DString *dest, const char *src, const size_t sub_index, const size_t sub_count) {
+    size_t src_len, sub_len;
+
+    assert(dest != NULL && src != NULL);
+
+    src_len = strlen(src);
+    if (sub_index >= src_len || sub_index + sub_count > src_len) return false;
+
+    sub_len = sub_count == 0 ? src_len - sub_index : sub_count;
+
+    if (capacity_fit(dest, sub_len + 1)) {
+        memcpy(buf_of(dest), src + sub_index, sub_len);
+        buf_of(dest)[dest->len = sub_len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_cpy_sub(DString *dest, const DString *src, const size_t sub_index, const size_t sub_count) {
+    size_t sub_len;
+
+    assert(dest != NULL && src != NULL);
+
+    if (sub_index >= src->len || sub_index + sub_count > src->len) return false;
+
+    sub_len = sub_count == 0 ? src->len - sub_index : sub_count;
+
+    if (capacity_fit(dest, sub_len + 1)) {
+        memcpy(buf_of(dest), cbuf_of(src) + sub_index, sub_len);
+        buf_of(dest)[dest->len = sub_len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_cat_sub_cstr(DString *dest, const char *src, const size_t sub_index, const size_t sub_count) {
+    size_t src_len, sub_len;
+
+    assert(dest != NULL && src != NULL);
+
+    src_len = strlen(src);
+    if (sub_index >= src_len || sub_index + sub_count > src_len) return false;
+
+    sub_len = sub_count == 0 ? src_len - sub_index : sub_count;
+
+    if (capacity_fit(dest, dest->len + sub_len + 1)) {
+        memcpy(buf_of(dest) + dest->len, src + sub_index, sub_len);
+        buf_of(dest)[dest->len += sub_len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_cat_sub(DString *dest, const DString *src, const size_t sub_index, const size_t sub_count) {
+    size_t sub_len;
+
+    assert(dest != NULL && src != NULL);
+
+    if (sub_index >= src->len || sub_index + sub_count > src->len) return false;
+
+    sub_len = sub_count == 0 ? src->len - sub_index : sub_count;
+
+    if (capacity_fit(dest, dest->len + sub_len + 1)) {
+        memcpy(buf_of(dest) + dest->len, cbuf_of(src) + sub_index, sub_len);
+        buf_of(dest)[dest->len += sub_len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_insert_sub_cstr(DString *dest, const char *src, const size_t index, const size_t sub_index,
+                          const size_t sub_count) {
+    size_t src_len, sub_len;
+
+    assert(dest != NULL && src != NULL);
+
+    if (index > dest->len) return false;
+    src_len = strlen(src);
+    if (sub_index >= src_len || sub_index + sub_count > src_len) return false;
+
+    sub_len = sub_count == 0 ? src_len - sub_index : sub_count;
+
+    return insert_bytes(dest, src + sub_index, sub_len, index);
+}
+
+bool dstr_insert_sub(DString *dest, const DString *src, const size_t index, const size_t sub_index,
+                     const size_t sub_count) {
+    size_t sub_len;
+
+    assert(dest != NULL && src != NULL);
+
+    if (index > dest->len) return false;
+    if (sub_index >= src->len || sub_index + sub_count > src->len) return false;
+
+    sub_len = sub_count == 0 ? src->len - sub_index : sub_count;
+
+    return insert_bytes(dest, cbuf_of(src) + sub_index, sub_len, index);
+}
+
+// 删除子串
+void dstr_remove(DString *dstr, const size_t sub_index, const size_t sub_count) {
+    size_t sub_len;
+
+    assert(dstr != NULL);
+
+    if (sub_index >= dstr->len || sub_index + sub_count > dstr->len) return;
+    if (!payload_make_unique(dstr)) return;
+
+    sub_len = sub_count == 0 ? dstr->len - sub_index : sub_count;
+    if (sub_count != 0 && sub_index + sub_count < dstr->len) {
+        memmove(buf_of(dstr) + sub_index,
+                buf_of(dstr) + sub_index + sub_count,
+                dstr->len - sub_index - sub_count
+        );
+    }
+
+    buf_of(dstr)[dstr->len -= sub_len] = '\0';
+    capacity_fit(dstr, dstr->len + 1);
+}
+
+// 删除特定内容
+void dstr_trim(DString *dstr) {
+    char *find;
+    size_t space_len;
+
+    assert(dstr != NULL);
+
+    if (dstr->len == 0) return;
+    if (!payload_make_unique(dstr)) return;
+
+    // 去除前导空白字符
+    for (find = buf_of(dstr);
+         find < buf_of(dstr) + dstr->len;
+         ++find
+    ) {
+        if (!isspace(*find)) break;
+    }
+
+    if (find > buf_of(dstr)) {
+        space_len = find - buf_of(dstr);
+        memmove(buf_of(dstr), find, dstr->len - space_len);
+        buf_of(dstr)[dstr->len -= space_len] = '\0';
+    }
+
+    for (find = buf_of(dstr) + dstr->len - 1;
+         find >= buf_of(dstr);
+         --find) {
+        if (!isspace(*find)) break;
+    }
+
+    if (find < buf_of(dstr) + dstr->len - 1) {
+        space_len = buf_of(dstr) + dstr->len - 1 - find;
+        buf_of(dstr)[dstr->len -= space_len] = '\0';
+    }
+
+    capacity_fit(dstr, dstr->len + 1);
+}
+
+// 格式化追加的内部实现
+// 格式化到 dstr 末尾的空闲容量，空间不足时按 vsnprintf 报告的长度扩容后重新格式化
+static bool append_vformat(DString *dstr, const char *format, va_list args) {
+    va_list retry;
+    size_t spare;
+    int written;
+
+    spare = cap_of(dstr) - dstr->len;
+    va_copy(retry, args);
+    written = vsnprintf(buf_of(dstr) + dstr->len, spare, format, args);
+    if (written >= 0 && (size_t) written >= spare) {
+        written = capacity_fit(dstr, dstr->len + (size_t) written + 1)
+                      ? vsnprintf(buf_of(dstr) + dstr->len, (size_t) written + 1, format, retry)
+                      : -1;
+    }
+    va_end(retry);
+    if (written < 0) return false;
+
+    dstr->len += (size_t) written;
+    return true;
+}
+
+static bool append_bytes(DString *dstr, const char *data, const size_t len) {
+    if (len == 0) return true;
+    if (!capacity_fit(dstr, dstr->len + len + 1)) return false;
+
+    memcpy(buf_of(dstr) + dstr->len, data, len);
+    buf_of(dstr)[dstr->len += len] = '\0';
+    return true;
+}
+
+// 一个转换说明的参数，按转换字符与长度修饰符取出，重新格式化时可以再次使用
+typedef enum FormatArgKind {
+    FORMAT_ARG_INT,
+    FORMAT_ARG_LONG,
+    FORMAT_ARG_LLONG,
+    FORMAT_ARG_INTMAX,
+    FORMAT_ARG_SIZE,
+    FORMAT_ARG_PTRDIFF,
+    FORMAT_ARG_UINT,
+    FORMAT_ARG_ULONG,
+    FORMAT_ARG_ULLONG,
+    FORMAT_ARG_UINTMAX,
+    FORMAT_ARG_DOUBLE,
+    FORMAT_ARG_LDOUBLE,
+    FORMAT_ARG_WINT,
+    FORMAT_ARG_CSTR,
+    FORMAT_ARG_WSTR,
+    FORMAT_ARG_POINTER
+} FormatArgKind;
+
+typedef struct FormatArg {
+    FormatArgKind kind;
+    union {
+        int i;
+        long l;
+        long long ll;
+        intmax_t im;
+        size_t sz;
+        ptrdiff_t pd;
+        unsigned u;
+        unsigned long ul;
+        unsigned long long ull;
+        uintmax_t um;
+        double d;
+        long double ld;
+        wint_t wc;
+        const char *cstr;
+        const wchar_t *wstr;
+        const void *ptr;
+    } value;
+} FormatArg;
+
+// 解析后的转换说明；text 中的 '*' 已替换为实际数值，可以直接交给 snprintf
+typedef struct FormatSpec {
+    char text[64];
+    char length[3];
+    char conversion;
+    bool left;
+    int width;     // -1 表示未指定
+    int precision; // -1 表示未指定
+} FormatSpec;
+
+#define FORMAT_FLAGS "-+ #0"
+
+static bool spec_put(FormatSpec *spec, size_t *pos, const char *text, const size_t len) {
+    if (*pos + len >= sizeof(spec->text)) return false;
+
+    memcpy(spec->text + *pos, text, len);
+    *pos += len;
+    return true;
+}
+
+// 解析 '%' 之后的转换说明，宽度、精度中的 '*' 从 args 中取值；格式不合法时返回 NULL
+static const char *spec_parse(const char *p, va_list *args, FormatSpec *spec) {
+    char number[16];
+    const char *start;
+    size_t pos, length_len;
+    int value;
+
+    spec->text[0] = '%';
+    pos = 1;
+    spec->left = false;
+    spec->width = spec->precision = -1;
+
+    for (start = p; *p != '\0' && strchr(FORMAT_FLAGS, *p) != NULL; ++p) {
+        if (*p == '-') spec->left = true;
+    }
+    if (!spec_put(spec, &pos, start, (size_t) (p - start))) return NULL;
+
+    // 宽度：负数的 '*' 等价于 '-' 标志
+    if (*p == '*') {
+        value = va_arg(*args, int);
+        ++p;
+        if (value < 0) {
+            if (value == INT_MIN) return NULL;
+            spec->left = true;
+            value = -value;
+            if (!spec_put(spec, &pos, "-", 1)) return NULL;
+        }
+        spec->width = value;
+    } else if (isdigit((unsigned char) *p)) {
+        for (spec->width = 0; isdigit((unsigned char) *p); ++p) {
+            if (spec->width > (INT_MAX - 9) / 10) return NULL;
+            spec->width = spec->width * 10 + (*p - '0');
+        }
+    }
+    if (spec->width >= 0) {
+        snprintf(number, sizeof(number), "%d", spec->width);
+        if (!spec_put(spec, &pos, number, strlen(number))) return NULL;
+    }
+
+    // 精度：负数的 '*' 视为未指定
+    if (*p == '.') {
+        ++p;
+        if (*p == '*') {
+            value = va_arg(*args, int);
+            ++p;
+        } else {
+            for (value = 0; isdigit((unsigned char) *p); ++p) {
+                if (value > (INT_MAX - 9) / 10) return NULL;
+                value = value * 10 + (*p - '0');
+            }
+        }
+        if (value >= 0) {
+            spec->precision = value;
+            snprintf(number, sizeof(number), ".%d", value);
+            if (!spec_put(spec, &pos, number, strlen(number))) return NULL;
+        }
+    }
+
+    for (start = p, length_len = 0; *p != '\0' && strchr("hljztL", *p) != NULL && length_len < 2; ++p) {
+        ++length_len;
+    }
+    memcpy(spec->length, start, length_len);
+    spec->length[length_len] = '\0';
+    if (!spec_put(spec, &pos, start, length_len)) return NULL;
+
+    if (*p == '\0') return NULL;
+    spec->conversion = *p;
+    if (!spec_put(spec, &pos, p, 1)) return NULL;
+    spec->text[pos] = '\0';
+    return p + 1;
+}
+
+// 按转换字符与长度修饰符从 args 中取出参数；不支持的组合返回 false
+static bool arg_fetch(const FormatSpec *spec, va_list *args, FormatArg *arg) {
+    const char *length = spec->length;
+    const bool is_signed = spec->conversion == 'd' || spec->conversion == 'i';
+
+    switch (spec->conversion) {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            if (strcmp(length, "l") == 0) {
+                arg->kind = is_signed ? FORMAT_ARG_LONG : FORMAT_ARG_ULONG;
+                if (is_signed) arg->value.l = va_arg(*args, long);
+                else arg->value.ul = va_arg(*args, unsigned long);
+            } else if (strcmp(length, "ll") == 0) {
+                arg->kind = is_signed ? FORMAT_ARG_LLONG : FORMAT_ARG_ULLONG;
+                if (is_signed) arg->value.ll = va_arg(*args, long long);
+                else arg->value.ull = va_arg(*args, unsigned long long);
+            } else if (strcmp(length, "j") == 0) {
+                arg->kind = is_signed ? FORMAT_ARG_INTMAX : FORMAT_ARG_UINTMAX;
+                if (is_signed) arg->value.im = va_arg(*args, intmax_t);
+                else arg->value.um = va_arg(*args, uintmax_t);
+            } else if (strcmp(length, "z") == 0) {
+                arg->kind = FORMAT_ARG_SIZE;
+                arg->value.sz = va_arg(*args, size_t);
+            } else if (strcmp(length, "t") == 0) {
+                arg->kind = FORMAT_ARG_PTRDIFF;
+                arg->value.pd = va_arg(*args, ptrdiff_t);
+            } else if (length[0] == '\0' || strcmp(length, "h") == 0 || strcmp(length, "hh") == 0) {
+                // char、short 经默认实参提升后以 int 传递
+                arg->kind = is_signed ? FORMAT_ARG_INT : FORMAT_ARG_UINT;
+                if (is_signed) arg->value.i = va_arg(*args, int);
+                else arg->value.u = va_arg(*args, unsigned);
+            } else {
+                return false;
+            }
+            return true;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            if (strcmp(length, "L") == 0) {
+                arg->kind = FORMAT_ARG_LDOUBLE;
+                arg->value.ld = va_arg(*args, long double);
+            } else if (length[0] == '\0' || strcmp(length, "l") == 0) {
+                arg->kind = FORMAT_ARG_DOUBLE;
+                arg->value.d = va_arg(*args, double);
+            } else {
+                return false;
+            }
+            return true;
+        case 'c':
+            if (strcmp(length, "l") == 0) {
+                arg->kind = FORMAT_ARG_WINT;
+                arg->value.wc = va_arg(*args, wint_t);
+            } else {
+                arg->kind = FORMAT_ARG_INT;
+                arg->value.i = va_arg(*args, int);
+            }
+            return true;
+        case 's':
+            if (strcmp(length, "l") == 0) {
+                arg->kind = FORMAT_ARG_WSTR;
+                arg->value.wstr = va_arg(*args, const wchar_t *);
+            } else {
+                arg->kind = FORMAT_ARG_CSTR;
+                arg->value.cstr = va_arg(*args, const char *);
+            }
+            return true;
+        case 'p':
+            arg->kind = FORMAT_ARG_POINTER;
+            arg->value.ptr = va_arg(*args, const void *);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static int arg_format(char *out, const size_t size, const char *text, const FormatArg *arg) {
+    switch (arg->kind) {
+        case FORMAT_ARG_INT: return snprintf(out, size, text, arg->value.i);
+        case FORMAT_ARG_LONG: return snprintf(out, size, text, arg->value.l);
+        case FORMAT_ARG_LLONG: return snprintf(out, size, text, arg->value.ll);
+        case FORMAT_ARG_INTMAX: return snprintf(out, size, text, arg->value.im);
+        case FORMAT_ARG_SIZE: return snprintf(out, size, text, arg->value.sz);
+        case FORMAT_ARG_PTRDIFF: return snprintf(out, size, text, arg->value.pd);
+        case FORMAT_ARG_UINT: return snprintf(out, size, text, arg->value.u);
+        case FORMAT_ARG_ULONG: return snprintf(out, size, text, arg->value.ul);
+        case FORMAT_ARG_ULLONG: return snprintf(out, size, text, arg->value.ull);
+        case FORMAT_ARG_UINTMAX: return snprintf(out, size, text, arg->value.um);
+        case FORMAT_ARG_DOUBLE: return snprintf(out, size, text, arg->value.d);
+        case FORMAT_ARG_LDOUBLE: return snprintf(out, size, text, arg->value.ld);
+        case FORMAT_ARG_WINT: return snprintf(out, size, text, arg->value.wc);
+        case FORMAT_ARG_CSTR: return snprintf(out, size, text, arg->value.cstr);
+        case FORMAT_ARG_WSTR: return snprintf(out, size, text, arg->value.wstr);
+        case FORMAT_ARG_POINTER: return snprintf(out, size, text, arg->value.ptr);
+    }
+    return -1;
+}
+
+// 与 append_vformat 相同的策略，只格式化一个转换说明
+static bool append_arg(DString *dstr, const FormatSpec *spec, const FormatArg *arg) {
+    size_t spare;
+    int written;
+
+    spare = cap_of(dstr) - dstr->len;
+    written = arg_format(buf_of(dstr) + dstr->len, spare, spec->text, arg);
+    if (written >= 0 && (size_t) written >= spare) {
+        written = capacity_fit(dstr, dstr->len + (size_t) written + 1)
+                      ? arg_format(buf_of(dstr) + dstr->len, (size_t) written + 1, spec->text, arg)
+                      : -1;
+    }
+    if (written < 0) return false;
+
+    dstr->len += (size_t) written;
+    return true;
+}
+
+// %S：按长度嵌入 src 的内容；src 为 dstr 自身时嵌入追加前的 old_len 字节
+static bool append_dstr(DString *dstr, const FormatSpec *spec, const DString *src, const size_t old_len) {
+    size_t len, width, pad;
+
+    len = src == dstr ? old_len : src->len;
+    if (spec->precision >= 0 && (size_t) spec->precision < len) len = (size_t) spec->precision;
+    width = spec->width > 0 ? (size_t) spec->width : 0;
+    pad = width > len ? width - len : 0;
+
+    if (!capacity_fit(dstr, dstr->len + len + pad + 1)) return false;
+
+    // 扩容后再取 src 的缓冲，src 为自身时地址可能已经改变
+    if (!spec->left) memset(buf_of(dstr) + dstr->len, ' ', pad);
+    memcpy(buf_of(dstr) + dstr->len + (spec->left ? 0 : pad), cbuf_of(src), len);
+    if (spec->left) memset(buf_of(dstr) + dstr->len + len, ' ', pad);
+    buf_of(dstr)[dstr->len += len + pad] = '\0';
+    return true;
+}
+
+// %n：写出本次已追加的字节数
+static bool store_count(const FormatSpec *spec, va_list *args, const size_t count) {
+    const char *length = spec->length;
+
+    if (length[0] == '\0') *va_arg(*args, int *) = (int) count;
+    else if (strcmp(length, "hh") == 0) *va_arg(*args, signed char *) = (signed char) count;
+    else if (strcmp(length, "h") == 0) *va_arg(*args, short *) = (short) count;
+    else if (strcmp(length, "l") == 0) *va_arg(*args, long *) = (long) count;
+    else if (strcmp(length, "ll") == 0) *va_arg(*args, long long *) = (long long) count;
+    else if (strcmp(length, "j") == 0) *va_arg(*args, intmax_t *) = (intmax_t) count;
+    else if (strcmp(length, "z") == 0) *va_arg(*args, size_t *) = count;
+    else if (strcmp(length, "t") == 0) *va_arg(*args, ptrdiff_t *) = (ptrdiff_t) count;
+    else return false;
+    return true;
+}
+
+// 格式串中是否含有 %S；没有时整体交给 vsnprintf
+static bool format_has_dstr(const char *format) {
+    const char *p;
+
+    for (p = strchr(format, '%'); p != NULL; p = strchr(p, '%')) {
+        ++p;
+        if (*p == '%') {
+            ++p;
+            continue;
+        }
+        p += strspn(p, FORMAT_FLAGS "0123456789.*hljztL");
+        if (*p == 'S') return true;
+        if (*p == '\0') break;
+    }
+    return false;
+}
+
+// 逐个处理转换说明：文字原样复制，%S 自行嵌入，其余交给 snprintf
+static bool append_format_extended(DString *dstr, const char *format, va_list *args, const size_t old_len) {
+    FormatSpec spec;
+    FormatArg arg;
+    const char *p, *percent;
+
+    for (p = format; *p != '\0';) {
+        percent = strchr(p, '%');
+        if (percent == NULL) return append_bytes(dstr, p, strlen(p));
+        if (!append_bytes(dstr, p, (size_t) (percent - p))) return false;
+
+        if (percent[1] == '%') {
+            if (!append_bytes(dstr, "%", 1)) return false;
+            p = percent + 2;
+            continue;
+        }
+
+        p = spec_parse(percent + 1, args, &spec);
+        if (p == NULL) return false;
+
+        if (spec.conversion == 'S') {
+            if (spec.length[0] != '\0') return false;
+            if (!append_dstr(dstr, &spec, va_arg(*args, const DString *), old_len)) return false;
+        } else if (spec.conversion == 'n') {
+            if (!store_count(&spec, args, dstr->len - old_len)) return false;
+        } else {
+            if (!arg_fetch(&spec, args, &arg) || !append_arg(dstr, &spec, &arg)) return false;
+        }
+    }
+    return true;
+}
+
+// 格式化写入
+bool dstr_printf(DString *dstr, const char *format, ...) {
     va_list args, temp_args;
     size_t old_cap;
     int needed_len, written_len;
@@ -430,21 +1478,83 @@ bool dstr_printf(DString *dstr, const char *format, ...) {
         return false;
     }
 
-    old_cap = dstr->cap;
-    if (capacity_resize(dstr, needed_len + 1)) {
-        written_len = vsnprintf(dstr->data, needed_len + 1, format, args);
+    old_cap = cap_of(dstr);
+    if (capacity_fit(dstr, needed_len + 1)) {
+        written_len = vsnprintf(buf_of(dstr), needed_len + 1, format, args);
         va_end(args);
         if (written_len < 0) {
             capacity_resize(dstr, old_cap);
             return false;
         }
 
-        dstr->data[dstr->len = written_len] = '\0';
+        buf_of(dstr)[dstr->len = written_len] = '\0';
         return true;
     }
     return false;
 }
 
+bool dstr_appendf(DString *dstr, const char *format, ...) {
+    va_list args;
+    bool appended;
+
+    assert(dstr != NULL && format != NULL);
+
+    va_start(args, format);
+    appended = dstr_vappendf(dstr, format, args);
+    va_end(args);
+    return appended;
+}
+
+bool dstr_vappendf(DString *dstr, const char *format, va_list args) {
+    va_list args_copy;
+    size_t old_len;
+    bool appended;
+
+    assert(dstr != NULL && format != NULL);
+
+    // 首次格式化直接写入空闲容量，共享的数据需先复制出独占的一份
+    if (!payload_make_unique(dstr)) return false;
+
+    old_len = dstr->len;
+    va_copy(args_copy, args);
+    appended = format_has_dstr(format)
+                   ? append_format_extended(dstr, format, &args_copy, old_len)
+                   : append_vformat(dstr, format, args_copy);
+    va_end(args_copy);
+
+    if (!appended || dstr->len == old_len) {
+        buf_of(dstr)[dstr->len = old_len] = '\0';
+        return false;
+    }
+    return true;
+}
+
+
+// 数值转换
+bool dstr_cat_i64(DString *dest, const int64_t value) {
+    char digits[DSTR_NUMBER_MAX_LEN];
+
+    assert(dest != NULL);
+
+    return dstr_cat_n(dest, digits, dstr_number_format_i64(digits, value));
+}
+
+bool dstr_cat_u64(DString *dest, const uint64_t value) {
+    char digits[DSTR_NUMBER_MAX_LEN];
+
+    assert(dest != NULL);
+
+    return dstr_cat_n(dest, digits, dstr_number_format_u64(digits, value));
+}
+
+bool dstr_cat_double(DString *dest, const double value) {
+    char digits[DSTR_NUMBER_MAX_LEN];
+
+    assert(dest != NULL);
+
+    return dstr_cat_n(dest, digits, dstr_number_format_double(digits, value));
+}
+
 
 // 从现有字符串生成新字符串
 // 提取子串
@@ -457,20 +1567,18 @@ DString *dstr_sub_cstr(const char *cstr, const size_t sub_index, const size_t su
     cstr_len = strlen(cstr);
     if (sub_index >= cstr_len || sub_index + sub_count > cstr_len) return NULL;
 
-    new_dstr = malloc(sizeof(DString));
-    if (new_dstr == NULL) return NULL;
-
-    *new_dstr = (DString){0};
-
     sub_len = sub_count == 0 ? cstr_len - sub_index : sub_count;
 
+    new_dstr = header_alloc(NULL, DSTR_PACKED_LAYOUT ? sub_len + 1 : 0);
+    if (new_dstr == NULL) return NULL;
+
     if (capacity_resize(new_dstr, sub_len + 1)) {
-        memcpy(new_dstr->data, cstr + sub_index, sub_len);
-        new_dstr->data[new_dstr->len = sub_len] = '\0';
+        memcpy(buf_of(new_dstr), cstr + sub_index, sub_len);
+        buf_of(new_dstr)[new_dstr->len = sub_len] = '\0';
         return new_dstr;
     }
 
-    free(new_dstr);
+    header_free(new_dstr);
     return NULL;
 }
 
@@ -482,251 +1590,348 @@ DString *dstr_sub(const DString *dstr, const size_t sub_index, const size_t sub_
 
     if (sub_index >= dstr->len || sub_index + sub_count > dstr->len) return NULL;
 
-    new_dstr = malloc(sizeof(DString));
-    if (new_dstr == NULL) return NULL;
-
-    *new_dstr = (DString){0};
-
     sub_len = sub_count == 0 ? dstr->len - sub_index : sub_count;
 
+    new_dstr = header_alloc(allocator_of(dstr), DSTR_PACKED_LAYOUT ? sub_len + 1 : 0);
+    if (new_dstr == NULL) return NULL;
+
     if (capacity_resize(new_dstr, sub_len + 1)) {
-        memcpy(new_dstr->data, dstr->data + sub_index, sub_len);
-        new_dstr->data[new_dstr->len = sub_len] = '\0';
+        memcpy(buf_of(new_dstr), cbuf_of(dstr) + sub_index, sub_len);
+        buf_of(new_dstr)[new_dstr->len = sub_len] = '\0';
         return new_dstr;
     }
 
-    free(new_dstr);
+    header_free(new_dstr);
     return NULL;
 }
 
 // 克隆
 DString *dstr_clone(const DString *dstr) {
+    assert(dstr != NULL);
+
+    return dstr_clone_with_allocator(dstr, allocator_of(dstr));
+}
+
+DString *dstr_clone_with_allocator(const DString *dstr, const DStrAllocator *allocator) {
     DString *new_dstr;
 
     assert(dstr != NULL);
 
-    new_dstr = malloc(sizeof(DString));
+    if (allocator == NULL) allocator = default_allocator;
+
+    // 启用写时复制时只增加引用计数，首次写入时才复制
+    if (payload_shareable(dstr, allocator)) {
+        new_dstr = header_alloc(allocator, 0);
+        if (new_dstr == NULL) return NULL;
+        payload_share(new_dstr, dstr);
+        return new_dstr;
+    }
+
+    new_dstr = header_alloc(allocator, DSTR_PACKED_LAYOUT && (dstr->flags & DSTR_FLAG_COW) == 0 ? dstr->len + 1 : 0);
     if (new_dstr == NULL) return NULL;
+    new_dstr->flags = (new_dstr->flags & ~DSTR_FLAG_COW) | (dstr->flags & DSTR_FLAG_COW);
 
-    *new_dstr = (DString){0};
     if (capacity_resize(new_dstr, dstr->len + 1)) {
-        memcpy(new_dstr->data, dstr->data, dstr->len);
-        new_dstr->data[new_dstr->len = dstr->len] = '\0';
+        memcpy(buf_of(new_dstr), cbuf_of(dstr), dstr->len);
+        buf_of(new_dstr)[new_dstr->len = dstr->len] = '\0';
         return new_dstr;
     }
 
-    free(new_dstr);
+    header_free(new_dstr);
     return NULL;
 }
 
 // 查找、统计与替换
 bool dstr_find_cstr(const DString *dstr, const char *sub, size_t *out_index, const bool backward) {
-    size_t sub_len;
-    char *find;
+    size_t sub_len, pos;
 
     assert(dstr != NULL && sub != NULL && out_index != NULL);
 
     sub_len = strlen(sub);
     if (sub_len == 0 || sub_len > dstr->len) return false;
 
-    if (backward) {
-        for (find = dstr->data + dstr->len - sub_len;
-             find >= dstr->data;
-             --find
-        ) {
-            if (strncmp(find, sub, sub_len) == 0) {
-                *out_index = find - dstr->data;
-                return true;
-            }
-        }
-    } else {
-        for (find = dstr->data;
-             find <= dstr->data + dstr->len - sub_len;
-             ++find
-        ) {
-            if (strncmp(find, sub, sub_len) == 0) {
-                *out_index = find - dstr->data;
-                return true;
-            }
-        }
-    }
+    pos = backward
+              ? dstr_search_last(cbuf_of(dstr), dstr->len, sub, sub_len)
+              : dstr_search_first(cbuf_of(dstr), dstr->len, sub, sub_len);
+    if (pos == DSTR_SEARCH_NPOS) return false;
 
-    return false;
+    *out_index = pos;
+    return true;
 }
 
 bool dstr_find(const DString *dstr, const DString *sub, size_t *out_index, const bool backward) {
-    char *find;
+    size_t pos;
 
     assert(dstr != NULL && sub != NULL && out_index != NULL);
 
     if (sub->len == 0 || sub->len > dstr->len) return false;
 
+    pos = backward
+              ? dstr_search_last(cbuf_of(dstr), dstr->len, cbuf_of(sub), sub->len)
+              : dstr_search_first(cbuf_of(dstr), dstr->len, cbuf_of(sub), sub->len);
+    if (pos == DSTR_SEARCH_NPOS) return false;
+
+    *out_index = pos;
+    return true;
+}
+
+// 查找目标：普通字符串或预编译模式
+typedef struct Needle {
+    const char *data;
+    size_t len;
+    const DStrPattern *pattern; // 非 NULL 时使用预编译模式查找
+} Needle;
+
+static inline size_t needle_first(const Needle *needle, const char *hay, const size_t hay_len) {
+    return needle->pattern != NULL
+               ? dstr_search_pattern_first(needle->pattern, hay, hay_len)
+               : dstr_search_first(hay, hay_len, needle->data, needle->len);
+}
+
+static inline size_t needle_last(const Needle *needle, const char *hay, const size_t hay_len) {
+    return needle->pattern != NULL
+               ? dstr_search_pattern_last(needle->pattern, hay, hay_len)
+               : dstr_search_last(hay, hay_len, needle->data, needle->len);
+}
+
+// 统计不重叠出现的次数
+static size_t count_matches(const char *data, const size_t len, const Needle *sub) {
+    size_t find_count, start, pos;
+
+    for (find_count = 0, start = 0;
+         (pos = needle_first(sub, data + start, len - start)) != DSTR_SEARCH_NPOS;
+         ++find_count) {
+        start += pos + sub->len;
+    }
+
+    return find_count;
+}
+
+// 查找第 n 次不重叠出现的位置，逆向时从末尾开始计数
+static size_t find_nth_match(const char *data, const size_t len, const Needle *sub, size_t n,
+                             const bool backward) {
+    size_t start, end, pos;
+
     if (backward) {
-        for (find = dstr->data + dstr->len - sub->len;
-             find >= dstr->data;
-             --find
-        ) {
-            if (strncmp(find, sub->data, sub->len) == 0) {
-                *out_index = find - dstr->data;
-                return true;
-            }
+        for (end = len;; end = pos) {
+            pos = needle_last(sub, data, end);
+            if (pos == DSTR_SEARCH_NPOS || --n == 0) return pos;
+        }
+    }
+
+    for (start = 0;; start += pos + sub->len) {
+        pos = needle_first(sub, data + start, len - start);
+        if (pos == DSTR_SEARCH_NPOS) return pos;
+        if (--n == 0) return start + pos;
+    }
+}
+
+// 统计至多 n 处（0 表示全部）将被替换的不重叠匹配，并记录替换范围的边界：
+// 正向为最后一处匹配的结束位置，逆向为最前一处匹配的起始位置
+static size_t locate_matches(const char *data, const size_t len, const Needle *sub, const size_t n,
+                             const bool backward, size_t *out_limit) {
+    size_t find_count, bound, pos;
+
+    find_count = 0;
+    if (backward) {
+        for (bound = len; (n == 0 || find_count < n) &&
+                          (pos = needle_last(sub, data, bound)) != DSTR_SEARCH_NPOS; ++find_count) {
+            bound = pos;
         }
     } else {
-        for (find = dstr->data;
-             find <= dstr->data + dstr->len - sub->len;
-             ++find
-        ) {
-            if (strncmp(find, sub->data, sub->len) == 0) {
-                *out_index = find - dstr->data;
-                return true;
-            }
+        for (bound = 0; (n == 0 || find_count < n) &&
+                        (pos = needle_first(sub, data + bound, len - bound)) != DSTR_SEARCH_NPOS; ++find_count) {
+            bound += pos + sub->len;
         }
     }
 
-    return false;
+    *out_limit = bound;
+    return find_count;
 }
 
-size_t dstr_count_cstr(const DString *dstr, const char *sub) {
-    size_t sub_len;
-    char *find;
-    size_t find_count;
+// 从前向后输出：替换 src[0, limit) 中的全部匹配，其后原样复制；dst 可以与 src 相同（结果不长于原文时）
+static void emit_forward(char *dst, const char *src, const size_t len, const Needle *old, const char *new,
+                         const size_t new_len, const size_t limit) {
+    size_t read, write, pos;
 
-    assert(dstr != NULL && sub != NULL);
+    for (read = 0, write = 0;
+         read < limit && (pos = needle_first(old, src + read, limit - read)) != DSTR_SEARCH_NPOS;
+         read += pos + old->len, write += pos + new_len) {
+        memmove(dst + write, src + read, pos);
+        memcpy(dst + write + pos, new, new_len);
+    }
 
-    sub_len = strlen(sub);
-    if (sub_len == 0 || sub_len > dstr->len) return 0;
+    memmove(dst + write, src + read, len - read);
+    dst[write + len - read] = '\0';
+}
 
-    for (find_count = 0, find = dstr->data;
-         find <= dstr->data + dstr->len - sub_len;
-    ) {
-        if (strncmp(find, sub, sub_len) == 0) {
-            ++find_count;
-            find += sub_len;
+// 从后向前输出：替换 src[limit, len) 中的全部匹配，其前原样复制；dst 可以与 src 相同（结果不短于原文时）
+static void emit_backward(char *dst, const size_t result_len, const char *src, const size_t len,
+                          const Needle *old, const char *new, const size_t new_len, const size_t limit) {
+    size_t read, write, pos, seg;
+
+    dst[result_len] = '\0';
+    for (read = len, write = result_len;
+         read > limit && (pos = needle_last(old, src + limit, read - limit)) != DSTR_SEARCH_NPOS;
+         read = limit + pos) {
+        seg = read - (limit + pos + old->len);
+        write -= seg;
+        memmove(dst + write, src + read - seg, seg);
+        write -= new_len;
+        memcpy(dst + write, new, new_len);
+    }
+
+    memmove(dst, src, read);
+}
+
+// 为长度为 result_len 的新内容单独分配缓冲，*out_cap 返回实际容量
+static char *fresh_payload_alloc(const DString *dstr, const size_t result_len, size_t *out_cap) {
+    char *fresh;
+    size_t needed, target;
+    bool counted;
+
+    needed = result_len + 1;
+    target = needed > cap_of(dstr) ? growth_target(policy_of(dstr), cap_of(dstr), needed) : needed;
+    if (target < min_cap_of(dstr)) target = min_cap_of(dstr);
+    if (target <= SSO_CAP || target <= tail_cap_of(dstr)) target = needed;
+    else target = round_to_pointer(target);
+
+    counted = (dstr->flags & DSTR_FLAG_COW) != 0;
+    fresh = payload_alloc(dstr, target, counted);
+    if (fresh == NULL && target > needed) fresh = payload_alloc(dstr, target = needed, counted);
+
+    *out_cap = target;
+    return fresh;
+}
+
+// 以 fresh_payload_alloc 分配并已写好的缓冲替换原内容：
+// 结果需要独立堆缓冲时直接接管，否则复制回内嵌缓冲或尾随存储后释放；失败时原内容不变
+static bool fresh_payload_adopt(DString *dstr, char *fresh, const size_t fresh_cap, const size_t result_len) {
+    const size_t needed = result_len + 1;
+    const bool counted = (dstr->flags & DSTR_FLAG_COW) != 0;
+
+    if (fresh_cap == needed && (needed <= SSO_CAP || needed <= tail_cap_of(dstr))) {
+        if (!capacity_fit(dstr, needed)) {
+            payload_free(dstr, fresh, fresh_cap, counted);
+            return false;
+        }
+        memcpy(buf_of(dstr), fresh, needed);
+        payload_free(dstr, fresh, fresh_cap, counted);
+    } else {
+        if (is_heap(dstr)) {
+            payload_release(dstr);
         } else {
-            ++find;
+            dstr->store.heap.min_cap = 0;
         }
+        dstr->flags = (dstr->flags | DSTR_FLAG_HEAP) & ~(DSTR_FLAG_TAIL | DSTR_FLAG_COUNTED);
+        if (counted) dstr->flags |= DSTR_FLAG_COUNTED;
+        hash_invalidate(dstr);
+        dstr->store.heap.data = fresh;
+        dstr->store.heap.cap = fresh_cap;
     }
 
-    return find_count;
+    dstr->len = result_len;
+    return true;
 }
 
-size_t dstr_count(const DString *dstr, const DString *sub) {
-    char *find;
-    size_t find_count;
+// 将至多 n 处（0 表示全部）不重叠的 old 替换为 new，逆向时从末尾开始
+// 先统计匹配数并一次性确定结果长度，再单遍输出，整体为线性时间
+static size_t replace_matches(DString *dstr, const Needle *old, const char *new, const size_t new_len,
+                              const size_t n, const bool backward) {
+    size_t find_count, limit, result_len, fresh_cap;
+    char *fresh;
 
-    assert(dstr != NULL && sub != NULL);
+    find_count = locate_matches(cbuf_of(dstr), dstr->len, old, n, backward, &limit);
+    if (find_count == 0) return 0;
 
-    // ReSharper disable once CppDFANullDereference
-    if (sub->len == 0 || sub->len > dstr->len) return 0;
+    if (new_len >= old->len) {
+        if (new_len - old->len > (SIZE_MAX - 1 - dstr->len) / find_count) return 0;
+        result_len = dstr->len + (new_len - old->len) * find_count;
+    } else {
+        result_len = dstr->len - (old->len - new_len) * find_count;
+    }
 
-    for (find_count = 0, find = dstr->data;
-         find <= dstr->data + dstr->len - sub->len;
-    ) {
-        if (strncmp(find, sub->data, sub->len) == 0) {
-            ++find_count;
-            find += sub->len;
+    // 结果不长于原文时从前向后写、不短于原文时从后向前写，写入位置不会越过尚未读取的内容，可以原地进行；
+    // 输出方向与查找方向不一致，或 old、new 位于字符串自身的缓冲内时，改为写入新的缓冲
+    if ((backward ? new_len < old->len : new_len > old->len) ||
+        aliases_buffer(dstr, old->data, old->len) || aliases_buffer(dstr, new, new_len)) {
+        fresh = fresh_payload_alloc(dstr, result_len, &fresh_cap);
+        if (fresh == NULL) return 0;
+        if (backward) {
+            emit_backward(fresh, result_len, cbuf_of(dstr), dstr->len, old, new, new_len, limit);
         } else {
-            ++find;
+            emit_forward(fresh, cbuf_of(dstr), dstr->len, old, new, new_len, limit);
         }
+        return fresh_payload_adopt(dstr, fresh, fresh_cap, result_len) ? find_count : 0;
+    }
+
+    if (backward) {
+        if (!capacity_fit(dstr, result_len + 1)) return 0;
+        emit_backward(buf_of(dstr), result_len, buf_of(dstr), dstr->len, old, new, new_len, limit);
+        dstr->len = result_len;
+    } else {
+        if (!payload_make_unique(dstr)) return 0;
+        emit_forward(buf_of(dstr), buf_of(dstr), dstr->len, old, new, new_len, limit);
+        dstr->len = result_len;
+        capacity_fit(dstr, dstr->len + 1);
     }
 
     return find_count;
 }
 
-bool dstr_find_nth_cstr(const DString *dstr, const char *sub, size_t *out_index, const size_t n, const bool backward) {
+size_t dstr_count_cstr(const DString *dstr, const char *sub) {
     size_t sub_len;
-    char *find;
-    size_t find_count;
 
-    if (n == 0) return false;
-    assert(dstr != NULL && sub != NULL && out_index != NULL);
+    assert(dstr != NULL && sub != NULL);
+
     sub_len = strlen(sub);
-    if (sub_len == 0 || sub_len > dstr->len) return false;
+    if (sub_len == 0 || sub_len > dstr->len) return 0;
 
-    if (backward) {
-        for (find_count = 0, find = dstr->data + dstr->len - sub_len;
-             find >= dstr->data;
-        ) {
-            if (strncmp(find, sub, sub_len) == 0) {
-                ++find_count;
-                if (find_count == n) {
-                    *out_index = find - dstr->data;
-                    return true;
-                }
-                find -= sub_len;
-            } else {
-                --find;
-            }
-        }
-    } else {
-        for (find_count = 0, find = dstr->data;
-             find <= dstr->data + dstr->len - sub_len;
-        ) {
-            if (strncmp(find, sub, sub_len) == 0) {
-                ++find_count;
-                if (find_count == n) {
-                    *out_index = find - dstr->data;
-                    return true;
-                }
-                find += sub_len;
-            } else {
-                ++find;
-            }
-        }
-    }
-    return false;
+    return count_matches(cbuf_of(dstr), dstr->len, &(Needle){sub, sub_len, NULL});
+}
+
+size_t dstr_count(const DString *dstr, const DString *sub) {
+    assert(dstr != NULL && sub != NULL);
+
+    // ReSharper disable once CppDFANullDereference
+    if (sub->len == 0 || sub->len > dstr->len) return 0;
+
+    return count_matches(cbuf_of(dstr), dstr->len, &(Needle){cbuf_of(sub), sub->len, NULL});
+}
+
+bool dstr_find_nth_cstr(const DString *dstr, const char *sub, size_t *out_index, const size_t n, const bool backward) {
+    size_t sub_len, pos;
+
+    if (n == 0) return false;
+    assert(dstr != NULL && sub != NULL && out_index != NULL);
+    sub_len = strlen(sub);
+    if (sub_len == 0 || sub_len > dstr->len) return false;
+
+    pos = find_nth_match(cbuf_of(dstr), dstr->len, &(Needle){sub, sub_len, NULL}, n, backward);
+    if (pos == DSTR_SEARCH_NPOS) return false;
+
+    *out_index = pos;
+    return true;
 }
 
 bool dstr_find_nth(const DString *dstr, const DString *sub, size_t *out_index, const size_t n, const bool backward) {
-    char *find;
-    size_t find_count;
+    size_t pos;
 
     if (n == 0) return false;
     assert(dstr != NULL && sub != NULL && out_index != NULL);
     if (sub->len == 0 || sub->len > dstr->len) return false;
 
-    if (backward) {
-        for (find_count = 0, find = dstr->data + dstr->len - sub->len;
-             find >= dstr->data;
-        ) {
-            if (strncmp(find, sub->data, sub->len) == 0) {
-                ++find_count;
-                if (find_count == n) {
-                    *out_index = find - dstr->data;
-                    return true;
-                }
-                find -= sub->len;
-            } else {
-                --find;
-            }
-        }
-    } else {
-        for (find_count = 0, find = dstr->data;
-             find <= dstr->data + dstr->len - sub->len;
-        ) {
-            if (strncmp(find, sub->data, sub->len) == 0) {
-                ++find_count;
-                if (find_count == n) {
-                    *out_index = find - dstr->data;
-                    return true;
-                }
-                find += sub->len;
-            } else {
-                ++find;
-            }
-        }
-    }
+    pos = find_nth_match(cbuf_of(dstr), dstr->len, &(Needle){cbuf_of(sub), sub->len, NULL}, n, backward);
+    if (pos == DSTR_SEARCH_NPOS) return false;
 
-    return false;
+    *out_index = pos;
+    return true;
 }
 
 
 size_t dstr_replace_cstr(DString *dstr, const char *old, const char *new, const size_t n,
                          const bool backward) {
-    // 局部变量声明
-    size_t find_count;
-    char *find; // 指向当前比较的字符串
-    size_t old_len, new_len;
+    size_t old_len;
 
     // 参数检查
     assert(dstr != NULL && old != NULL && new != NULL);
@@ -734,136 +1939,220 @@ size_t dstr_replace_cstr(DString *dstr, const char *old, const char *new, const
     old_len = strlen(old);
     if (old_len == 0 || old_len > dstr->len) return 0;
 
-    new_len = strlen(new);
-    // 替换
-    if (backward) {
-        for (find_count = 0, find = dstr->data + dstr->len - old_len;
-             find >= dstr->data && (n == 0 ? true : find_count < n);
-        ) {
-            if (strncmp(find, old, old_len) == 0) {
-                ++find_count;
-                // 替换
-                if (old_len != new_len && find + old_len < dstr->data + dstr->len) {
-                    memmove(
-                        find + new_len,
-                        find + old_len,
-                        dstr->data + dstr->len - find - old_len
-                    );
-                }
-                if (new_len > 0) {
-                    memcpy(find, new, new_len);
-                }
-                dstr->len -= old_len;
-                dstr->len += new_len;
-                dstr->data[dstr->len] = '\0';
+    return replace_matches(dstr, &(Needle){old, old_len, NULL}, new, strlen(new), n, backward);
+}
 
-                find -= old_len;
-            } else {
-                --find;
-            }
-        }
-    } else {
-        for (find_count = 0, find = dstr->data;
-             find <= dstr->data + dstr->len - old_len && (n == 0 ? true : find_count < n);
-        ) {
-            if (strncmp(find, old, old_len) == 0) {
-                ++find_count;
-                // 替换
-                if (old_len != new_len && find + old_len < dstr->data + dstr->len) {
-                    memmove(
-                        find + new_len,
-                        find + old_len,
-                        dstr->data + dstr->len - find - old_len
-                    );
-                }
-                if (new_len > 0) {
-                    memcpy(find, new, new_len);
-                }
-                dstr->len -= old_len;
-                dstr->len += new_len;
-                dstr->data[dstr->len] = '\0';
 
-                find += new_len;
-            } else {
-                ++find;
-            }
+size_t dstr_replace(DString *dstr, const DString *old, const DString *new,
+                    const size_t n, const bool backward) {
+    // 参数检查
+    assert(dstr != NULL && old != NULL && new != NULL);
+
+    if (old->len == 0 || old->len > dstr->len) return 0;
+
+    return replace_matches(dstr, &(Needle){cbuf_of(old), old->len, NULL}, cbuf_of(new), new->len, n, backward);
+}
+
+// 预编译批量替换
+// 匹配自动机由各 old 反转后构造：从后向前扫描一遍即可得到每个位置上开始的最长 old，
+// 再从前向后按「最左最长」贪心选取，整个替换只读一遍原内容，耗时与 old 的长度无关
+struct DStrReplaceSet {
+    DStrMatcher *matcher;
+    size_t count;
+    // [0, count) 为 old 的长度，[count, 2 * count) 为 new 的长度，[2 * count, 3 * count) 为 new 在 news 中的偏移
+    size_t *lens;
+    char news[]; // 各 new 的副本，依次存放
+};
+
+DStrReplaceSet *dstr_replace_set_create(const DStrReplacePair *pairs, const size_t count) {
+    DStrReplaceSet *set;
+    char **reversed;
+    char *reversed_data;
+    size_t i, j, old_total, new_total;
+
+    assert(pairs != NULL || count == 0);
+
+    for (old_total = new_total = 0, i = 0; i < count; ++i) {
+        assert(pairs[i].old != NULL && pairs[i].new != NULL);
+        old_total += strlen(pairs[i].old);
+        new_total += strlen(pairs[i].new);
+    }
+
+    set = malloc(sizeof(DStrReplaceSet) + new_total);
+    if (set == NULL) return NULL;
+
+    set->count = count;
+    set->matcher = NULL;
+    set->lens = malloc((count != 0 ? 3 * count : 1) * sizeof(size_t));
+    reversed = malloc((count != 0 ? count : 1) * sizeof(char *));
+    reversed_data = malloc(old_total != 0 ? old_total : 1);
+    if (set->lens != NULL && reversed != NULL && reversed_data != NULL) {
+        for (old_total = new_total = 0, i = 0; i < count; ++i) {
+            set->lens[i] = strlen(pairs[i].old);
+            set->lens[count + i] = strlen(pairs[i].new);
+            set->lens[2 * count + i] = new_total;
+            memcpy(set->news + new_total, pairs[i].new, set->lens[count + i]);
+            new_total += set->lens[count + i];
+
+            reversed[i] = reversed_data + old_total;
+            for (j = 0; j < set->lens[i]; ++j) reversed[i][j] = pairs[i].old[set->lens[i] - 1 - j];
+            old_total += set->lens[i];
         }
+        set->matcher = dstr_matcher_create_n((const char *const *) reversed, set->lens, count);
     }
 
-    return find_count;
+    free(reversed);
+    free(reversed_data);
+    if (set->matcher == NULL) {
+        dstr_replace_set_destroy(set);
+        return NULL;
+    }
+    return set;
 }
 
+void dstr_replace_set_destroy(DStrReplaceSet *set) {
+    assert(set != NULL);
 
-size_t dstr_replace(DString *dstr, const DString *old, const DString *new,
-                    const size_t n, const bool backward) {
-    // 局部变量声明
-    size_t find_count;
-    char *find; // 指向当前比较的字符串
+    if (set->matcher != NULL) dstr_matcher_destroy(set->matcher);
+    free(set->lens);
+    free(set);
+}
 
-    // 参数检查
-    assert(dstr != NULL && old != NULL && new != NULL);
+// 从后向前扫描得到的候选匹配（起点从大到小），选取时未被选中的项 pattern 置为 SIZE_MAX
+typedef struct ReplaceStarts {
+    DStrMatch *items;
+    size_t count;
+    size_t cap;
+} ReplaceStarts;
+
+static bool collect_start(const DStrMatch *match, void *ctx) {
+    ReplaceStarts *starts;
+    DStrMatch *new_items;
+    size_t new_cap;
+
+    starts = ctx;
+    if (starts->count == starts->cap) {
+        new_cap = starts->cap != 0 ? starts->cap * 2 : 16;
+        if (new_cap > SIZE_MAX / sizeof(DStrMatch)) return false;
+        new_items = realloc(starts->items, new_cap * sizeof(DStrMatch));
+        if (new_items == NULL) return false;
+        starts->items = new_items;
+        starts->cap = new_cap;
+    }
+    starts->items[starts->count++] = *match;
+    return true;
+}
 
-    if (old->len == 0 || old->len > dstr->len) return 0;
+size_t dstr_replace_many_set(DString *dstr, const DStrReplaceSet *set) {
+    ReplaceStarts starts;
+    const DStrMatch *match;
+    const size_t *lens;
+    size_t i, find_count, result_len, pos, write, fresh_cap;
+    char *fresh;
 
-    // 替换
-    if (backward) {
-        for (find_count = 0, find = dstr->data + dstr->len - old->len;
-             find >= dstr->data && (n == 0 ? true : find_count < n);
-        ) {
-            if (strncmp(find, old->data, old->len) == 0) {
-                ++find_count;
-                // 替换
-                if (old->len != new->len && find + old->len < dstr->data + dstr->len) {
-                    memmove(
-                        find + new->len,
-                        find + old->len,
-                        dstr->data + dstr->len - find - old->len
-                    );
-                }
-                if (new->len > 0) {
-                    memcpy(find, new, new->len);
-                }
-                dstr->len -= old->len;
-                dstr->len += new->len;
-                dstr->data[dstr->len] = '\0';
+    assert(dstr != NULL && set != NULL);
 
-                find -= old->len;
-            } else {
-                --find;
-            }
+    if (set->count == 0 || dstr->len == 0) return 0;
+
+    starts = (ReplaceStarts){NULL, 0, 0};
+    if (!dstr_matcher_longest_starts(set->matcher, cbuf_of(dstr), dstr->len, collect_start, &starts)) {
+        free(starts.items);
+        return 0;
+    }
+
+    // 按起点从小到大贪心选取互不重叠的匹配，同时计算结果长度
+    lens = set->lens;
+    for (find_count = 0, result_len = dstr->len, pos = 0, i = starts.count; i > 0; --i) {
+        match = &starts.items[i - 1];
+        if (match->index < pos) {
+            starts.items[i - 1].pattern = SIZE_MAX;
+            continue;
         }
-    } else {
-        for (find_count = 0, find = dstr->data;
-             find <= dstr->data + dstr->len - old->len && (n == 0 ? true : find_count < n);
-        ) {
-            if (strncmp(find, old->data, old->len) == 0) {
-                ++find_count;
-                // 替换
-                if (old->len != new->len && find + old->len < dstr->data + dstr->len) {
-                    memmove(
-                        find + new->len,
-                        find + old->len,
-                        dstr->data + dstr->len - find - old->len
-                    );
-                }
-                if (new->len > 0) {
-                    memcpy(find, new, new->len);
-                }
-                dstr->len -= old->len;
-                dstr->len += new->len;
-                dstr->data[dstr->len] = '\0';
+        result_len -= lens[match->pattern];
+        if (lens[set->count + match->pattern] > SIZE_MAX - 1 - result_len) {
+            find_count = 0;
+            break;
+        }
+        result_len += lens[set->count + match->pattern];
+        pos = match->index + lens[match->pattern];
+        ++find_count;
+    }
 
-                find += new->len;
-            } else {
-                ++find;
-            }
+    fresh = find_count != 0 ? fresh_payload_alloc(dstr, result_len, &fresh_cap) : NULL;
+    if (fresh != NULL) {
+        for (write = 0, pos = 0, i = starts.count; i > 0; --i) {
+            match = &starts.items[i - 1];
+            if (match->pattern == SIZE_MAX) continue;
+
+            memcpy(fresh + write, cbuf_of(dstr) + pos, match->index - pos);
+            write += match->index - pos;
+            memcpy(fresh + write, set->news + lens[2 * set->count + match->pattern], lens[set->count + match->pattern]);
+            write += lens[set->count + match->pattern];
+            pos = match->index + lens[match->pattern];
         }
+        memcpy(fresh + write, cbuf_of(dstr) + pos, dstr->len - pos + 1);
+
+        if (!fresh_payload_adopt(dstr, fresh, fresh_cap, result_len)) find_count = 0;
+    } else {
+        find_count = 0;
     }
 
+    free(starts.items);
+    return find_count;
+}
+
+size_t dstr_replace_many(DString *dstr, const DStrReplacePair *pairs, const size_t count) {
+    DStrReplaceSet *set;
+    size_t find_count;
+
+    assert(dstr != NULL && (pairs != NULL || count == 0));
+
+    if (count == 0 || dstr->len == 0) return 0;
+
+    set = dstr_replace_set_create(pairs, count);
+    if (set == NULL) return 0;
+
+    find_count = dstr_replace_many_set(dstr, set);
+    dstr_replace_set_destroy(set);
     return find_count;
 }
 
+// 预编译查找模式
+bool dstr_find_pattern(const DString *dstr, const DStrPattern *pattern, size_t *out_index, const bool backward) {
+    size_t pos;
+
+    assert(dstr != NULL && pattern != NULL && out_index != NULL);
+
+    pos = backward
+              ? dstr_search_pattern_last(pattern, cbuf_of(dstr), dstr->len)
+              : dstr_search_pattern_first(pattern, cbuf_of(dstr), dstr->len);
+    if (pos == DSTR_SEARCH_NPOS) return false;
+
+    *out_index = pos;
+    return true;
+}
+
+size_t dstr_count_pattern(const DString *dstr, const DStrPattern *pattern) {
+    assert(dstr != NULL && pattern != NULL);
+
+    if (dstr_pattern_length(pattern) == 0) return 0;
+
+    return count_matches(cbuf_of(dstr), dstr->len,
+                         &(Needle){dstr_pattern_needle(pattern), dstr_pattern_length(pattern), pattern});
+}
+
+size_t dstr_replace_pattern(DString *dstr, const DStrPattern *pattern, const char *new, const size_t n,
+                            const bool backward) {
+    assert(dstr != NULL && pattern != NULL && new != NULL);
+
+    if (dstr_pattern_length(pattern) == 0 || dstr_pattern_length(pattern) > dstr->len) return 0;
+
+    return replace_matches(dstr, &(Needle){dstr_pattern_needle(pattern), dstr_pattern_length(pattern), pattern},
+                           new, strlen(new), n, backward);
+}
+
 // 判断与比较
+// 均按长度逐字节比较，可用于含 '\0' 的数据
 bool dstr_starts_with_cstr(const DString *dstr, const char *prefix) {
     size_t prefix_len;
 
@@ -872,7 +2161,7 @@ bool dstr_starts_with_cstr(const DString *dstr, const char *prefix) {
     prefix_len = strlen(prefix);
     if (prefix_len == 0 || prefix_len > dstr->len) return false;
 
-    return strncmp(dstr->data, prefix, prefix_len) == 0;
+    return memcmp(cbuf_of(dstr), prefix, prefix_len) == 0;
 }
 
 
@@ -881,7 +2170,7 @@ bool dstr_starts_with(const DString *dstr, const DString *prefix) {
 
     if (prefix->len == 0 || prefix->len > dstr->len) return false;
 
-    return strncmp(dstr->data, prefix->data, prefix->len) == 0;
+    return dstr_search_equal(cbuf_of(dstr), cbuf_of(prefix), prefix->len);
 }
 
 
@@ -892,8 +2181,7 @@ bool dstr_ends_with_cstr(const DString *dstr, const char *suffix) {
     suffix_len = strlen(suffix);
     if (suffix_len == 0 || suffix_len > dstr->len) return false;
 
-    return strncmp(dstr->data + dstr->len - suffix_len,
-                   suffix, suffix_len) == 0;
+    return memcmp(cbuf_of(dstr) + dstr->len - suffix_len, suffix, suffix_len) == 0;
 }
 
 
@@ -901,8 +2189,7 @@ bool dstr_ends_with(const DString *dstr, const DString *suffix) {
     assert(dstr != NULL && suffix != NULL);
     if (suffix->len == 0 || suffix->len > dstr->len) return false;
 
-    return strncmp(dstr->data + dstr->len - suffix->len,
-                   suffix->data, suffix->len) == 0;
+    return dstr_search_equal(cbuf_of(dstr) + dstr->len - suffix->len, cbuf_of(suffix), suffix->len);
 }
 
 
@@ -913,14 +2200,14 @@ bool dstr_contains_cstr(const DString *dstr, const char *sub) {
     sub_len = strlen(sub);
     if (sub_len == 0 || sub_len > dstr->len) return false;
 
-    return strstr(dstr->data, sub) != NULL;
+    return dstr_search_first(cbuf_of(dstr), dstr->len, sub, sub_len) != DSTR_SEARCH_NPOS;
 }
 
 bool dstr_contains(const DString *dstr, const DString *sub) {
     assert(dstr != NULL && sub != NULL);
     if (sub->len == 0 || sub->len > dstr->len) return false;
 
-    return strstr(dstr->data, sub->data) != NULL;
+    return dstr_search_first(cbuf_of(dstr), dstr->len, cbuf_of(sub), sub->len) != DSTR_SEARCH_NPOS;
 }
 
 
@@ -931,25 +2218,406 @@ bool dstr_equals_cstr(const DString *dstr, const char *cstr) {
     cstr_len = strlen(cstr);
     if (cstr_len != dstr->len) return false;
 
-    return strncmp(dstr->data, cstr, cstr_len) == 0;
+    return dstr_search_equal(cbuf_of(dstr), cstr, cstr_len);
 }
 
 
 bool dstr_equals(const DString *dstr_1, const DString *dstr_2) {
+    uint64_t hash_1, hash_2;
+
     assert(dstr_1 != NULL && dstr_2 != NULL);
     if (dstr_1->len != dstr_2->len) return false;
+    // 两者都已缓存哈希值时，哈希不同可直接判定不相等
+    if (hash_cached(dstr_1, &hash_1) && hash_cached(dstr_2, &hash_2) && hash_1 != hash_2) return false;
 
-    return strncmp(dstr_1->data, dstr_2->data, dstr_2->len) == 0;
+    return dstr_search_equal(cbuf_of(dstr_1), cbuf_of(dstr_2), dstr_2->len);
 }
 
 int dstr_compare_cstr(const DString *dstr, const char *cstr) {
     assert(dstr != NULL && cstr != NULL);
 
-    return strcmp(dstr->data, cstr);
+    return compare_bytes(cbuf_of(dstr), dstr->len, cstr, strlen(cstr));
 }
 
 int dstr_compare(const DString *dstr_1, const DString *dstr_2) {
     assert(dstr_1 != NULL && dstr_2 != NULL);
 
-    return strcmp(dstr_1->data, dstr_2->data);
+    return compare_bytes(cbuf_of(dstr_1), dstr_1->len, cbuf_of(dstr_2), dstr_2->len);
+}
+
+// 只读视图
+DStrView dstr_view(const DString *dstr) {
+    assert(dstr != NULL);
+
+    return (DStrView){cbuf_of(dstr), dstr->len};
+}
+
+DStrView dstr_view_sub(const DString *dstr, const size_t sub_index, const size_t sub_count) {
+    assert(dstr != NULL);
+
+    return dstr_view_slice(dstr_view(dstr), sub_index, sub_count);
+}
+
+DStrView dstr_view_cstr(const char *cstr) {
+    assert(cstr != NULL);
+
+    return (DStrView){cstr, strlen(cstr)};
+}
+
+DStrView dstr_view_slice(const DStrView view, const size_t sub_index, const size_t sub_count) {
+    if (sub_index >= view.len || sub_count > view.len - sub_index) return (DStrView){NULL, 0};
+
+    return (DStrView){view.data + sub_index, sub_count == 0 ? view.len - sub_index : sub_count};
+}
+
+bool dstr_cpy_view(DString *dest, const DStrView src) {
+    size_t offset;
+
+    assert(dest != NULL);
+
+    if (src.len == 0) return false;
+    if (src.data == cbuf_of(dest) && src.len == dest->len) return true;
+
+    // 视图可能指向 dest 自身，先在原处移动再调整容量
+    if (aliases_buffer(dest, src.data, src.len)) {
+        offset = (size_t) (src.data - cbuf_of(dest));
+        if (!payload_make_unique(dest)) return false;
+        memmove(buf_of(dest), buf_of(dest) + offset, src.len);
+        buf_of(dest)[dest->len = src.len] = '\0';
+        capacity_fit(dest, dest->len + 1);
+        return true;
+    }
+
+    if (capacity_fit(dest, src.len + 1)) {
+        memcpy(buf_of(dest), src.data, src.len);
+        buf_of(dest)[dest->len = src.len] = '\0';
+        return true;
+    }
+    return false;
+}
+
+bool dstr_cat_view(DString *dest, const DStrView src) {
+    assert(dest != NULL);
+
+    if (src.len == 0) return false;
+
+    return dstr_cat_n(dest, src.data, src.len);
+}
+
+bool dstr_insert_view(DString *dest, const DStrView src, const size_t index) {
+    assert(dest != NULL);
+
+    if (index > dest->len || src.len == 0) return false;
+
+    return insert_bytes(dest, src.data, src.len, index);
+}
+
+// 批量追加
+bool dstr_cat_many(DString *dest, const DStrView *pieces, const size_t count) {
+    uintptr_t old_begin, old_end;
+    size_t total, i;
+    char *write;
+
+    assert(dest != NULL && (pieces != NULL || count == 0));
+
+    for (total = 0, i = 0; i < count; ++i) {
+        assert(pieces[i].data != NULL || pieces[i].len == 0);
+        if (pieces[i].len > SIZE_MAX - 1 - dest->len - total) return false;
+        total += pieces[i].len;
+    }
+    if (total == 0) return false;
+
+    // 片段可能指向自身缓冲，扩容后按原偏移重新定位；追加只写入原内容之后，原内容保持不变
+    old_begin = (uintptr_t) cbuf_of(dest);
+    old_end = old_begin + cap_of(dest);
+    if (!capacity_fit(dest, dest->len + total + 1)) return false;
+
+    write = buf_of(dest) + dest->len;
+    for (i = 0; i < count; ++i) {
+        if (pieces[i].len == 0) continue;
+        memcpy(write, rebase_source(dest, old_begin, old_end, pieces[i].data), pieces[i].len);
+        write += pieces[i].len;
+    }
+    buf_of(dest)[dest->len += total] = '\0';
+    return true;
+}
+
+bool dstr_cat_many_cstr(DString *dest, const char *const *pieces, const size_t count) {
+    uintptr_t old_begin;
+    size_t total, old_len, piece_len, i;
+    const char *source;
+    char *write;
+
+    assert(dest != NULL && (pieces != NULL || count == 0));
+
+    for (total = 0, i = 0; i < count; ++i) {
+        assert(pieces[i] != NULL);
+        piece_len = strlen(pieces[i]);
+        if (piece_len > SIZE_MAX - 1 - dest->len - total) return false;
+        total += piece_len;
+    }
+    if (total == 0) return false;
+
+    old_begin = (uintptr_t) cbuf_of(dest);
+    old_len = dest->len;
+    if (!capacity_fit(dest, dest->len + total + 1)) return false;
+
+    write = buf_of(dest) + dest->len;
+    for (i = 0; i < count; ++i) {
+        piece_len = cstr_piece(dest, old_begin, old_len, pieces[i], &source);
+        memcpy(write, source, piece_len);
+        write += piece_len;
+    }
+    buf_of(dest)[dest->len += total] = '\0';
+    return true;
+}
+
+bool dstr_cat_all(DString *dest, ...) {
+    va_list args;
+    uintptr_t old_begin;
+    const char *piece, *source;
+    size_t total, old_len, piece_len;
+    char *write;
+    bool overflow;
+
+    assert(dest != NULL);
+
+    va_start(args, dest);
+    for (total = 0, overflow = false; (piece = va_arg(args, const char *)) != NULL;) {
+        piece_len = strlen(piece);
+        if (piece_len > SIZE_MAX - 1 - dest->len - total) overflow = true;
+        else total += piece_len;
+    }
+    va_end(args);
+    if (overflow || total == 0) return false;
+
+    old_begin = (uintptr_t) cbuf_of(dest);
+    old_len = dest->len;
+    if (!capacity_fit(dest, dest->len + total + 1)) return false;
+
+    write = buf_of(dest) + dest->len;
+    va_start(args, dest);
+    while ((piece = va_arg(args, const char *)) != NULL) {
+        piece_len = cstr_piece(dest, old_begin, old_len, piece, &source);
+        memcpy(write, source, piece_len);
+        write += piece_len;
+    }
+    va_end(args);
+    buf_of(dest)[dest->len += total] = '\0';
+    return true;
+}
+
+// 直接写入空闲容量
+char *dstr_prepare_append(DString *dstr, const size_t n) {
+    assert(dstr != NULL);
+
+    if (n > SIZE_MAX - 1 - dstr->len) return NULL;
+
+    // 空闲容量已经足够时不触碰分配器，避免在循环读取时反复收缩
+    if (cap_of(dstr) - dstr->len - 1 >= n) {
+        if (!payload_make_unique(dstr)) return NULL;
+    } else if (!capacity_fit(dstr, dstr->len + n + 1)) {
+        return NULL;
+    }
+    return buf_of(dstr) + dstr->len;
+}
+
+bool dstr_commit_append(DString *dstr, const size_t written) {
+    assert(dstr != NULL);
+
+    if (written > cap_of(dstr) - dstr->len - 1) {
+        buf_of(dstr)[dstr->len] = '\0';
+        return false;
+    }
+
+    buf_of(dstr)[dstr->len += written] = '\0';
+    return true;
+}
+
+bool dstr_find_view(const DString *dstr, const DStrView sub, size_t *out_index, const bool backward) {
+    assert(dstr != NULL && out_index != NULL);
+
+    return dstr_view_find(dstr_view(dstr), sub, out_index, backward);
+}
+
+size_t dstr_count_view(const DString *dstr, const DStrView sub) {
+    assert(dstr != NULL);
+
+    if (sub.len == 0 || sub.len > dstr->len) return 0;
+
+    return count_matches(cbuf_of(dstr), dstr->len, &(Needle){sub.data, sub.len, NULL});
+}
+
+bool dstr_contains_view(const DString *dstr, const DStrView sub) {
+    assert(dstr != NULL);
+
+    if (sub.len == 0 || sub.len > dstr->len) return false;
+
+    return dstr_search_first(cbuf_of(dstr), dstr->len, sub.data, sub.len) != DSTR_SEARCH_NPOS;
+}
+
+bool dstr_starts_with_view(const DString *dstr, const DStrView prefix) {
+    assert(dstr != NULL);
+
+    if (prefix.len == 0 || prefix.len > dstr->len) return false;
+
+    return dstr_search_equal(cbuf_of(dstr), prefix.data, prefix.len);
+}
+
+bool dstr_ends_with_view(const DString *dstr, const DStrView suffix) {
+    assert(dstr != NULL);
+
+    if (suffix.len == 0 || suffix.len > dstr->len) return false;
+
+    return dstr_search_equal(cbuf_of(dstr) + dstr->len - suffix.len, suffix.data, suffix.len);
+}
+
+bool dstr_equals_view(const DString *dstr, const DStrView view) {
+    assert(dstr != NULL);
+
+    return dstr_view_equals(dstr_view(dstr), view);
+}
+
+int dstr_compare_view(const DString *dstr, const DStrView view) {
+    assert(dstr != NULL);
+
+    return compare_bytes(cbuf_of(dstr), dstr->len, view.data, view.len);
+}
+
+bool dstr_view_find(const DStrView view, const DStrView sub, size_t *out_index, const bool backward) {
+    size_t pos;
+
+    assert(out_index != NULL);
+
+    if (sub.len == 0 || sub.len > view.len) return false;
+
+    pos = backward
+              ? dstr_search_last(view.data, view.len, sub.data, sub.len)
+              : dstr_search_first(view.data, view.len, sub.data, sub.len);
+    if (pos == DSTR_SEARCH_NPOS) return false;
+
+    *out_index = pos;
+    return true;
+}
+
+bool dstr_view_equals(const DStrView view_1, const DStrView view_2) {
+    if (view_1.len != view_2.len) return false;
+
+    return view_1.len == 0 || dstr_search_equal(view_1.data, view_2.data, view_1.len);
+}
+
+int dstr_view_compare(const DStrView view_1, const DStrView view_2) {
+    return compare_bytes(view_1.data, view_1.len, view_2.data, view_2.len);
+}
+
+// 哈希
+// 采用 wyhash 的结构：每轮吸收 48 字节、三路独立的 64×64→128 位乘法混合，短输入按长度分支只读取一两次
+static const uint64_t hash_secret[4] = {
+    0x2d358dccaa6c78a5u, 0x8bb84b93962eacc9u, 0x4b33a62ed433d4a3u, 0x4d5a2da51de1aa47u
+};
+
+static inline void hash_mum(uint64_t *a, uint64_t *b) {
+#ifdef __SIZEOF_INT128__
+    const unsigned __int128 product = (unsigned __int128) *a * *b;
+
+    *a = (uint64_t) product;
+    *b = (uint64_t) (product >> 64);
+#else
+    const uint64_t ha = *a >> 32, la = (uint32_t) *a, hb = *b >> 32, lb = (uint32_t) *b;
+    const uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+    const uint64_t mid = hl + (ll >> 32) + (uint32_t) lh;
+
+    *a = (mid << 32) | (uint32_t) ll;
+    *b = hh + (mid >> 32) + (lh >> 32);
+#endif
+}
+
+static inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+    hash_mum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t hash_read8(const unsigned char *p) {
+    uint64_t value;
+
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t hash_read4(const unsigned char *p) {
+    uint32_t value;
+
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint64_t hash_bytes(const char *data, const size_t len, uint64_t seed) {
+    const unsigned char *p;
+    uint64_t a, b, see1, see2;
+    size_t i;
+
+    p = (const unsigned char *) data;
+    seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (hash_read4(p) << 32) | hash_read4(p + ((len >> 3) << 2));
+            b = (hash_read4(p + len - 4) << 32) | hash_read4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t) p[0] << 16) | ((uint64_t) p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        i = len;
+        if (i >= 48) {
+            see1 = see2 = seed;
+            do {
+                seed = hash_mix(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+                see1 = hash_mix(hash_read8(p + 16) ^ hash_secret[2], hash_read8(p + 24) ^ see1);
+                see2 = hash_mix(hash_read8(p + 32) ^ hash_secret[3], hash_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = hash_mix(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // 最后 16 字节可能与已吸收的部分重叠，避免逐字节处理尾部
+        a = hash_read8(p + i - 16);
+        b = hash_read8(p + i - 8);
+    }
+
+    a ^= hash_secret[1];
+    b ^= seed;
+    hash_mum(&a, &b);
+    return hash_mix(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]);
+}
+
+uint64_t dstr_hash(const DString *dstr) {
+    uint64_t hash;
+
+    assert(dstr != NULL);
+
+    if (hash_cached(dstr, &hash)) return hash;
+
+    hash = hash_bytes(cbuf_of(dstr), dstr->len, 0);
+    hash_publish(dstr, hash);
+    return hash;
+}
+
+uint64_t dstr_hash_view(const DStrView view) {
+    assert(view.data != NULL || view.len == 0);
+
+    return hash_bytes(view.data, view.len, 0);
+}
+
+uint64_t dstr_hash_view_seeded(const DStrView view, const uint64_t seed) {
+    assert(view.data != NULL || view.len == 0);
+
+    return hash_bytes(view.data, view.len, seed);
 }
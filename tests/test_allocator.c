@@ -0,0 +1,239 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <string.h>
+
+#define STRING_COUNT 16
+#define MODEL_MAX 2048
+
+// 多个字符串共用一个分配器，随机写入、克隆、取子串，检查内容与归还
+static void check_routing(void) {
+    static char models[STRING_COUNT][MODEL_MAX];
+    size_t model_lens[STRING_COUNT];
+    TestAllocStats stats, other_stats;
+    DStrAllocator allocator, other;
+    DString *dstrs[STRING_COUNT], *copy;
+    char buf[256];
+    size_t slot, len, index;
+
+    test_seed(4);
+    allocator = test_stats_allocator(&stats);
+    other = test_stats_allocator(&other_stats);
+    for (slot = 0; slot < STRING_COUNT; ++slot) {
+        dstrs[slot] = dstr_create_with_allocator("", &allocator);
+        CHECK(dstrs[slot] != NULL && dstr_allocator(dstrs[slot]) == &allocator);
+        model_lens[slot] = 0;
+    }
+
+    for (int step = 0; step < 50000; ++step) {
+        slot = test_below(STRING_COUNT);
+        switch (test_below(5)) {
+            case 0:
+                len = 1 + test_below(test_below(4) == 0 ? sizeof(buf) : 8);
+                if (model_lens[slot] + len >= MODEL_MAX) break;
+                test_fill(buf, len, "ab", 2);
+                CHECK(dstr_cat_n(dstrs[slot], buf, len));
+                memcpy(models[slot] + model_lens[slot], buf, len);
+                model_lens[slot] += len;
+                break;
+            case 1:
+                if (model_lens[slot] == 0) break;
+                index = test_below(model_lens[slot]);
+                dstr_remove(dstrs[slot], index, 0);
+                model_lens[slot] = index;
+                break;
+            case 2:
+                // 克隆与子串沿用源字符串的分配器
+                index = test_below(STRING_COUNT);
+                copy = test_below(2) == 0 || model_lens[index] == 0
+                           ? dstr_clone(dstrs[index])
+                           : dstr_sub(dstrs[index], 0, 1 + test_below(model_lens[index]));
+                CHECK(copy != NULL && dstr_allocator(copy) == &allocator);
+                dstr_destroy(dstrs[slot]);
+                dstrs[slot] = copy;
+                model_lens[slot] = dstr_length(copy);
+                memcpy(models[slot], models[index], model_lens[slot]);
+                break;
+            case 3:
+                copy = dstr_clone_with_allocator(dstrs[slot], &other);
+                CHECK(copy != NULL && dstr_allocator(copy) == &other && dstr_equals(copy, dstrs[slot]));
+                dstr_destroy(copy);
+                CHECK(other_stats.live == 0);
+                break;
+            default:
+                dstr_clear(dstrs[slot]);
+                model_lens[slot] = 0;
+                break;
+        }
+
+        CHECK(dstr_length(dstrs[slot]) == model_lens[slot]);
+        CHECK(memcmp(dstr_cstr(dstrs[slot]), models[slot], model_lens[slot]) == 0);
+    }
+
+    for (slot = 0; slot < STRING_COUNT; ++slot) dstr_destroy(dstrs[slot]);
+    CHECK(stats.live == 0 && stats.frees != 0);
+}
+
+// 未指定分配器的字符串使用全局默认分配器
+static void check_default_allocator(void) {
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr;
+
+    allocator = test_stats_allocator(&stats);
+    dstr_set_default_allocator(&allocator);
+    CHECK(dstr_default_allocator() == &allocator);
+    dstr = dstr_create("uses the default allocator set at runtime");
+    CHECK(dstr != NULL && dstr_allocator(dstr) == &allocator && stats.allocs != 0);
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+
+    dstr_set_default_allocator(NULL);
+    CHECK(dstr_default_allocator() == &DSTR_ALLOCATOR_LIBC);
+    dstr = dstr_create("libc");
+    CHECK(dstr != NULL && dstr_allocator(dstr) == &DSTR_ALLOCATOR_LIBC);
+    dstr_destroy(dstr);
+}
+
+// 分配器失败时各写入操作返回失败，内容保持不变
+static void check_failures(void) {
+    static const char long_text[] = "a piece of text long enough to need a heap buffer of its own";
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr;
+
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_create_with_allocator("short", &allocator);
+    CHECK(dstr != NULL);
+
+    stats.fail_after = 0;
+    CHECK(dstr_create_with_allocator("x", &allocator) == NULL);
+    CHECK(dstr_clone(dstr) == NULL && dstr_sub(dstr, 0, 2) == NULL);
+    CHECK(!dstr_cat_cstr(dstr, long_text) && dstr_equals_cstr(dstr, "short"));
+    CHECK(!dstr_insert_cstr(dstr, long_text, 2) && dstr_equals_cstr(dstr, "short"));
+    CHECK(!dstr_cpy_cstr(dstr, long_text) && dstr_equals_cstr(dstr, "short"));
+    CHECK(!dstr_resize_capacity(dstr, 4096) && dstr_equals_cstr(dstr, "short"));
+    // 仍在内嵌缓冲内的写入不需要分配
+    CHECK(dstr_cat_cstr(dstr, "er") && dstr_equals_cstr(dstr, "shorter"));
+
+    stats.fail_after = SIZE_MAX;
+    CHECK(dstr_cpy_cstr(dstr, long_text));
+    stats.fail_after = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (!dstr_cat_cstr(dstr, long_text)) break;
+    }
+    CHECK(dstr_starts_with_cstr(dstr, long_text) && dstr_length(dstr) % (sizeof(long_text) - 1) == 0);
+
+    stats.fail_after = SIZE_MAX;
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+// arena：分配只移动游标，最后一次分配可原地扩缩、可回收
+static void check_arena_allocator(void) {
+    const DStrAllocator *allocator;
+    DStrArena *arena;
+    char *first, *second, *moved;
+    size_t used;
+
+    arena = dstr_arena_create(4096);
+    CHECK(arena != NULL && dstr_arena_used(arena) == 0);
+    allocator = dstr_arena_allocator(arena);
+
+    first = allocator->allocate(allocator->ctx, 100);
+    CHECK(first != NULL && dstr_arena_used(arena) >= 100);
+    memset(first, 'f', 100);
+    used = dstr_arena_used(arena);
+
+    // 最后一次分配原地扩容，随后释放时回收
+    CHECK(allocator->reallocate(allocator->ctx, first, 100, 1000) == first);
+    CHECK(dstr_arena_used(arena) >= used + 900);
+    allocator->deallocate(allocator->ctx, first, 1000);
+    CHECK(dstr_arena_used(arena) == 0);
+
+    first = allocator->allocate(allocator->ctx, 100);
+    memset(first, 'f', 100);
+    second = allocator->allocate(allocator->ctx, 100);
+    CHECK(second != NULL && second != first);
+
+    // 不是最后一次分配时扩容需要搬移，释放不回收
+    moved = allocator->reallocate(allocator->ctx, first, 100, 200);
+    CHECK(moved != NULL && moved != first && memcmp(moved, first, 100) == 0);
+    used = dstr_arena_used(arena);
+    allocator->deallocate(allocator->ctx, second, 100);
+    CHECK(dstr_arena_used(arena) == used);
+
+    // 超出块大小的请求单独成块
+    CHECK(allocator->allocate(allocator->ctx, 10000) != NULL);
+    CHECK(dstr_arena_used(arena) >= used + 10000);
+
+    dstr_arena_reset(arena);
+    CHECK(dstr_arena_used(arena) == 0);
+    dstr_arena_destroy(arena);
+}
+
+// arena 上的字符串：逐字节追加时原地扩容，mark/rewind 与 reset 整体回收
+static void check_arena_strings(void) {
+    char model[64];
+    DStrArena *arena;
+    DStrArenaMark mark, inner;
+    DString *dstr, *kept, *scratch;
+    size_t used, inner_used;
+
+    // 默认块大小足以容纳整个字符串，扩容都发生在同一块内
+    arena = dstr_arena_create(0);
+    CHECK(arena != NULL);
+
+    dstr = dstr_create_with_allocator("", dstr_arena_allocator(arena));
+    CHECK(dstr != NULL && dstr_allocator(dstr) == dstr_arena_allocator(arena));
+    for (int i = 0; i < 10000; ++i) CHECK(dstr_cat_cstr(dstr, "g"));
+    // 不能原地扩容时每次扩容都会留下旧块，累计约为最终容量的三倍
+    CHECK(dstr_arena_used(arena) < 2 * 10000);
+    dstr_arena_reset(arena);
+    CHECK(dstr_arena_used(arena) == 0);
+    dstr_arena_destroy(arena);
+
+    arena = dstr_arena_create(1024);
+    CHECK(arena != NULL);
+    kept = dstr_create_with_allocator("kept before the mark, long enough for a heap buffer",
+                                      dstr_arena_allocator(arena));
+    CHECK(kept != NULL);
+    mark = dstr_arena_mark(arena);
+    used = dstr_arena_used(arena);
+
+    test_seed(44);
+    for (int round = 0; round < 200; ++round) {
+        // 跨越多个块的临时字符串，回退后不再占用空间
+        inner = dstr_arena_mark(arena);
+        inner_used = dstr_arena_used(arena);
+        for (int i = 0; i < 20; ++i) {
+            test_fill(model, sizeof(model) - 1, "hk", 2);
+            model[sizeof(model) - 1] = '\0';
+            scratch = dstr_create_with_allocator(model, dstr_arena_allocator(arena));
+            CHECK(scratch != NULL && dstr_equals_cstr(scratch, model));
+            CHECK(dstr_cat_cstr(scratch, model) && dstr_length(scratch) == 2 * (sizeof(model) - 1));
+        }
+        CHECK(dstr_arena_used(arena) > inner_used);
+        dstr_arena_rewind(arena, inner);
+        CHECK(dstr_arena_used(arena) == inner_used);
+    }
+    CHECK(dstr_arena_used(arena) == used);
+
+    // 标记之前创建的字符串不受回退影响
+    dstr_arena_rewind(arena, mark);
+    CHECK(dstr_equals_cstr(kept, "kept before the mark, long enough for a heap buffer"));
+
+    dstr_arena_destroy(arena);
+}
+
+int main(void) {
+    check_routing();
+    check_default_allocator();
+    check_failures();
+    check_arena_allocator();
+    check_arena_strings();
+    return 0;
+}
@@ -0,0 +1,324 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <stdarg.h>
+#include <string.h>
+
+#define MODEL_MAX 32768
+#define PIECE_MAX 8
+
+// 随机的片段：目标自身的一段（含空段）、另一个字符串的一段或外部缓冲；先在模型中按原内容拼接
+static void check_many(void) {
+    static char model[MODEL_MAX], expected[MODEL_MAX], external[PIECE_MAX][32];
+    const char *cstr_pieces[PIECE_MAX];
+    DStrView pieces[PIECE_MAX];
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dest, *other;
+    size_t model_len, expected_len, count, start, len, calls, i;
+    int form;
+
+    allocator = test_stats_allocator(&stats);
+    dest = dstr_create_with_allocator("", &allocator);
+    other = dstr_create("another string that the pieces may point into");
+    CHECK(dest != NULL && other != NULL);
+    model_len = 0;
+
+    test_seed(19);
+    for (int step = 0; step < 50000; ++step) {
+        // 每步至多增长到原来的 PIECE_MAX + 1 倍
+        if (model_len > MODEL_MAX / (PIECE_MAX + 1) - 64) {
+            model_len = test_below(64);
+            dstr_remove(dest, model_len, 0);
+        }
+
+        // 0：视图片段，1：C 字符串片段，2：以 NULL 结尾的参数列表
+        form = (int) test_below(3);
+        count = test_below(PIECE_MAX + 1);
+        expected_len = 0;
+        for (i = 0; i < count; ++i) {
+            switch (test_below(4)) {
+                case 0:
+                    // C 字符串片段只能取到末尾，由目标的 '\0' 结尾
+                    start = test_below(model_len + 1);
+                    len = form == 0 ? test_below(model_len - start + 1) : model_len - start;
+                    pieces[i] = (DStrView){dstr_cstr(dest) + start, len};
+                    break;
+                case 1:
+                    start = test_below(dstr_length(other) + 1);
+                    pieces[i] = (DStrView){dstr_cstr(other) + start, dstr_length(other) - start};
+                    break;
+                case 2:
+                    pieces[i] = (DStrView){"", 0};
+                    break;
+                default:
+                    len = test_below(sizeof(external[i]));
+                    test_fill(external[i], len, "xyz", 3);
+                    external[i][len] = '\0';
+                    pieces[i] = (DStrView){external[i], len};
+                    break;
+            }
+            cstr_pieces[i] = pieces[i].data;
+            memcpy(expected + expected_len, pieces[i].data, pieces[i].len);
+            expected_len += pieces[i].len;
+        }
+
+        calls = test_stats_calls(&stats);
+        if (form == 0) {
+            CHECK(dstr_cat_many(dest, pieces, count) == (expected_len != 0));
+        } else if (form == 1) {
+            CHECK(dstr_cat_many_cstr(dest, cstr_pieces, count) == (expected_len != 0));
+        } else {
+            // 参数个数固定，缺少的片段以空串补齐
+            for (i = count; i < 4; ++i) cstr_pieces[i] = "";
+            if (count > 4) expected_len = pieces[0].len + pieces[1].len + pieces[2].len + pieces[3].len;
+            CHECK(dstr_cat_all(dest, cstr_pieces[0], cstr_pieces[1], cstr_pieces[2], cstr_pieces[3], NULL) ==
+                  (expected_len != 0));
+        }
+        // 无论片段多少只扩容一次
+        CHECK(test_stats_calls(&stats) - calls <= 1);
+
+        memcpy(model + model_len, expected, expected_len);
+        model_len += expected_len;
+        CHECK(dstr_length(dest) == model_len && memcmp(dstr_cstr(dest), model, model_len) == 0);
+        CHECK(dstr_cstr(dest)[model_len] == '\0');
+    }
+
+    dstr_destroy(other);
+    dstr_destroy(dest);
+    CHECK(stats.live == 0);
+}
+
+// 分配失败或总长度溢出时返回 false，内容不变
+static void check_many_failure(void) {
+    static const char long_piece[] = "a piece long enough to need a heap buffer";
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dest;
+
+    allocator = test_stats_allocator(&stats);
+    dest = dstr_create_with_allocator("kept", &allocator);
+    CHECK(dest != NULL);
+
+    stats.fail_after = 0;
+    CHECK(!dstr_cat_many(dest, (DStrView[]){dstr_view(dest), dstr_view_cstr(long_piece)}, 2));
+    CHECK(!dstr_cat_many_cstr(dest, (const char *[]){long_piece, dstr_cstr(dest)}, 2));
+    CHECK(!dstr_cat_all(dest, dstr_cstr(dest), long_piece, NULL));
+    CHECK(dstr_equals_cstr(dest, "kept"));
+    stats.fail_after = SIZE_MAX;
+
+    CHECK(!dstr_cat_many(dest, (DStrView[]){dstr_view(dest), {long_piece, SIZE_MAX - 2}}, 2));
+    CHECK(!dstr_cat_many(dest, NULL, 0) && !dstr_cat_many_cstr(dest, NULL, 0) && !dstr_cat_all(dest, NULL));
+    CHECK(dstr_equals_cstr(dest, "kept"));
+
+    dstr_destroy(dest);
+    CHECK(stats.live == 0);
+}
+
+// %S 的参照实现：取前 precision 字节（负数表示不限），不足 width 时以空格补齐，left 为真时左对齐
+static size_t expand_dstr(char *out, const bool left, const int width, const int precision, const char *data,
+                          size_t len) {
+    size_t pad;
+
+    if (precision >= 0 && (size_t) precision < len) len = (size_t) precision;
+    pad = width > 0 && (size_t) width > len ? (size_t) width - len : 0;
+    if (!left) memset(out, ' ', pad);
+    memcpy(out + (left ? 0 : pad), data, len);
+    if (left) memset(out + len, ' ', pad);
+    return len + pad;
+}
+
+// 随机的宽度、精度与对齐，写入 spec 并记下参数
+static void random_spec(char *spec, bool *left, int *width, int *precision) {
+    size_t pos = 0;
+
+    *left = test_below(2) == 0;
+    *width = test_below(2) == 0 ? -1 : (int) test_below(12);
+    *precision = test_below(2) == 0 ? -1 : (int) test_below(12);
+    if (*left) spec[pos++] = '-';
+    if (*width >= 0) pos += (size_t) sprintf(spec + pos, "%d", *width);
+    if (*precision >= 0) pos += (size_t) sprintf(spec + pos, ".%d", *precision);
+    spec[pos] = '\0';
+}
+
+static bool vappendf_wrapper(DString *dstr, const char *format, ...) {
+    va_list args;
+    bool result;
+
+    va_start(args, format);
+    result = dstr_vappendf(dstr, format, args);
+    va_end(args);
+    return result;
+}
+
+// 固定的转换顺序 %S %d %s %S，标志、文字与参数随机；最后一个 %S 常为 dstr 自身，嵌入调用前的内容
+static void check_format(void) {
+    // 格式中的文字与其输出
+    static const char *const literals[][2] = {{"", ""}, {"-", "-"}, {"%%", "%"}, {" a%%b ", " a%b "}, {"text", "text"}};
+    static char model[MODEL_MAX], format[256], single[32];
+    char specs[4][16], text[24], content[40];
+    int widths[4], precisions[4], number;
+    size_t model_len, old_len, content_len, text_len, lits[3];
+    bool lefts[4], self;
+    DString *dstr, *other;
+
+    dstr = dstr_create("");
+    other = dstr_create("");
+    CHECK(dstr != NULL && other != NULL);
+    model_len = 0;
+
+    test_seed(20);
+    for (int step = 0; step < 50000; ++step) {
+        if (model_len > MODEL_MAX / 4) {
+            model_len = test_below(64);
+            dstr_remove(dstr, model_len, 0);
+        }
+
+        content_len = test_below(sizeof(content));
+        test_fill(content, content_len, "ab\0", 3);
+        dstr_clear(other);
+        CHECK(dstr_cat_n(other, content, content_len) == (content_len != 0));
+        text_len = test_below(sizeof(text));
+        test_fill(text, text_len, "xyz", 3);
+        text[text_len] = '\0';
+        number = (int) test_rand();
+        self = test_below(2) == 0;
+        for (size_t i = 0; i < 4; ++i) random_spec(specs[i], &lefts[i], &widths[i], &precisions[i]);
+        for (size_t i = 0; i < 3; ++i) lits[i] = test_below(sizeof(literals) / sizeof(literals[0]));
+        snprintf(format, sizeof(format), "%%%sS%s%%%sd%s%%%ss%s%%%sS", specs[0], literals[lits[0]][0], specs[1],
+                 literals[lits[1]][0], specs[2], literals[lits[2]][0], specs[3]);
+
+        // 按段构造期望的结果，%d 与 %s 交给 snprintf
+        old_len = model_len;
+        model_len += expand_dstr(model + model_len, lefts[0], widths[0], precisions[0], content, content_len);
+        model_len += (size_t) sprintf(model + model_len, "%s", literals[lits[0]][1]);
+        snprintf(single, sizeof(single), "%%%sd", specs[1]);
+        model_len += (size_t) sprintf(model + model_len, single, number);
+        model_len += (size_t) sprintf(model + model_len, "%s", literals[lits[1]][1]);
+        snprintf(single, sizeof(single), "%%%ss", specs[2]);
+        model_len += (size_t) sprintf(model + model_len, single, text);
+        model_len += (size_t) sprintf(model + model_len, "%s", literals[lits[2]][1]);
+        model_len += self
+                         ? expand_dstr(model + model_len, lefts[3], widths[3], precisions[3], model, old_len)
+                         : expand_dstr(model + model_len, lefts[3], widths[3], precisions[3], content, content_len);
+
+        if (test_below(2) == 0) {
+            CHECK(dstr_appendf(dstr, format, other, number, text, self ? dstr : other) == (model_len != old_len));
+        } else {
+            CHECK(vappendf_wrapper(dstr, format, other, number, text, self ? dstr : other) == (model_len != old_len));
+        }
+        CHECK(dstr_length(dstr) == model_len && memcmp(dstr_cstr(dstr), model, model_len) == 0);
+    }
+
+    dstr_destroy(other);
+    dstr_destroy(dstr);
+}
+
+// '*' 宽度与精度、空结果与无效的转换说明；空闲容量足够时不调用分配器
+static void check_format_edges(void) {
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr, *empty;
+    size_t len, calls;
+
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_create_with_allocator("a\0b", &allocator);
+    empty = dstr_create("");
+    CHECK(dstr != NULL && empty != NULL && dstr_length(dstr) == 1);
+    CHECK(dstr_cat_n(dstr, "\0b", 2));
+
+    CHECK(dstr_appendf(dstr, "[%*S]", 5, dstr) && dstr_length(dstr) == 3 + 7);
+    CHECK(memcmp(dstr_cstr(dstr), "a\0b[  a\0b]", 10) == 0);
+    CHECK(dstr_appendf(dstr, "[%*.*S]", -4, 2, empty) && dstr_ends_with_cstr(dstr, "[    ]"));
+    CHECK(dstr_appendf(dstr, "[%.*S|%-3.1S]", -1, dstr, dstr) && dstr_ends_with_cstr(dstr, "]|a  ]"));
+    len = dstr_length(dstr);
+
+    // 结果为空或格式无效时返回 false，内容不变
+    CHECK(!dstr_appendf(dstr, "") && !dstr_appendf(dstr, "%S", empty) && !dstr_appendf(dstr, "%.0S", dstr));
+    CHECK(!dstr_appendf(dstr, "ok %hS", dstr) && !dstr_appendf(dstr, "ok %lS", dstr));
+    CHECK(dstr_length(dstr) == len);
+
+    CHECK(dstr_resize_capacity(dstr, 512));
+    calls = test_stats_calls(&stats);
+    for (int i = 0; i < 10; ++i) CHECK(dstr_appendf(dstr, "%d:%s:%5.3S;", i, "spare", empty));
+    CHECK(test_stats_calls(&stats) == calls && dstr_ends_with_cstr(dstr, "9:spare:     ;"));
+
+    dstr_destroy(empty);
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+// 直接写入空闲容量：写入不超过申请的字节数后提交，或提交超出空闲容量的数量而被拒绝
+static void check_prepare(void) {
+    static char model[MODEL_MAX];
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr, *clone;
+    size_t model_len, clone_len, n, written, spare, calls;
+    char *write;
+
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_create_with_allocator("", &allocator);
+    CHECK(dstr != NULL);
+    model_len = 0;
+
+    test_seed(22);
+    for (int step = 0; step < 100000; ++step) {
+        if (model_len > MODEL_MAX / 2) {
+            model_len = test_below(64);
+            dstr_remove(dstr, model_len, 0);
+        }
+
+        // 共享数据时写入前先复制出独占的一份，克隆不受影响
+        clone = test_below(8) == 0 ? dstr_clone(dstr) : NULL;
+        clone_len = model_len;
+        n = test_below(test_below(4) == 0 ? 1024 : 16);
+        spare = dstr_capacity(dstr) - model_len - 1;
+        calls = test_stats_calls(&stats);
+        write = dstr_prepare_append(dstr, n);
+        CHECK(write != NULL && write == dstr_cstr(dstr) + model_len);
+        CHECK(dstr_capacity(dstr) - model_len - 1 >= n);
+        if (spare >= n && clone == NULL) CHECK(test_stats_calls(&stats) == calls);
+
+        written = test_below(n + 1);
+        test_fill(write, written, "rw", 2);
+        memcpy(model + model_len, write, written);
+        spare = dstr_capacity(dstr) - model_len - 1;
+        if (test_below(8) == 0) {
+            CHECK(!dstr_commit_append(dstr, spare + 1 + test_below(8)));
+        } else {
+            CHECK(dstr_commit_append(dstr, written));
+            model_len += written;
+        }
+        CHECK(dstr_length(dstr) == model_len && memcmp(dstr_cstr(dstr), model, model_len) == 0);
+        CHECK(dstr_cstr(dstr)[model_len] == '\0');
+
+        if (clone != NULL) {
+            CHECK(dstr_length(clone) == clone_len && memcmp(dstr_cstr(clone), model, clone_len) == 0);
+            CHECK(dstr_cstr(clone)[clone_len] == '\0');
+            dstr_destroy(clone);
+        }
+    }
+
+    // 所需容量溢出或分配失败时返回 NULL，内容不变
+    CHECK(dstr_prepare_append(dstr, SIZE_MAX) == NULL && dstr_prepare_append(dstr, SIZE_MAX - model_len) == NULL);
+    stats.fail_after = 0;
+    CHECK(dstr_prepare_append(dstr, dstr_capacity(dstr)) == NULL);
+    stats.fail_after = SIZE_MAX;
+    CHECK(dstr_length(dstr) == model_len && memcmp(dstr_cstr(dstr), model, model_len) == 0);
+
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+int main(void) {
+    check_many();
+    check_many_failure();
+    check_format();
+    check_format_edges();
+    check_prepare();
+    return 0;
+}
@@ -0,0 +1,132 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_array.h"
+#include "test_util.h"
+#include <string.h>
+
+#define MODEL_MAX 4000
+#define ITEM_MAX 40
+
+// 以定长字符串数组为参照模型
+typedef struct ModelItem {
+    char data[ITEM_MAX];
+    size_t len;
+} ModelItem;
+
+static ModelItem model[MODEL_MAX];
+static size_t model_count;
+
+static void check_model(const DStrArray *array) {
+    DStrView view;
+
+    CHECK(dstr_array_count(array) == model_count);
+    for (size_t i = 0; i < model_count; ++i) {
+        view = dstr_array_get(array, i);
+        CHECK(view.len == model[i].len && memcmp(view.data, model[i].data, view.len) == 0);
+        CHECK(view.data[view.len] == '\0' && dstr_array_cstr(array, i) == view.data);
+    }
+}
+
+static void check_join(const DStrArray *array, const DStrView separator) {
+    DString *joined;
+    const char *text;
+    size_t pos;
+
+    joined = dstr_join(array, separator);
+    CHECK(joined != NULL);
+    text = dstr_cstr(joined);
+
+    pos = 0;
+    for (size_t i = 0; i < model_count; ++i) {
+        if (i != 0 && separator.len != 0) {
+            CHECK(memcmp(text + pos, separator.data, separator.len) == 0);
+            pos += separator.len;
+        }
+        CHECK(memcmp(text + pos, model[i].data, model[i].len) == 0);
+        pos += model[i].len;
+    }
+    CHECK(pos == dstr_length(joined));
+    dstr_destroy(joined);
+}
+
+static void test_model(void) {
+    DStrArray *array;
+    ModelItem item;
+    DStrView view;
+    size_t index, source;
+    int op;
+
+    array = dstr_array_create();
+    CHECK(array != NULL);
+
+    test_seed(25);
+    for (int step = 0; step < 200000; ++step) {
+        op = (int) test_below(10);
+        item.len = test_below(ITEM_MAX);
+        test_fill(item.data, item.len, "abcdefgh", 8);
+
+        if (op < 4 && model_count < MODEL_MAX) {
+            if (model_count != 0 && test_below(4) == 0) {
+                // 追加表中已有的字符串：来源位于表自身的缓冲内，扩容时不能失效
+                source = test_below(model_count);
+                CHECK(dstr_array_push(array, dstr_array_get(array, source)));
+                item = model[source];
+            } else {
+                CHECK(dstr_array_push(array, (DStrView){item.data, item.len}));
+            }
+            model[model_count++] = item;
+        } else if (op < 7 && model_count != 0) {
+            index = test_below(model_count);
+            if (test_below(3) == 0) {
+                // 以另一个字符串去掉首字节的部分覆盖，来源同样位于表内
+                source = test_below(model_count);
+                view = dstr_array_get(array, source);
+                if (view.len != 0) {
+                    ++view.data;
+                    --view.len;
+                }
+                item.len = view.len;
+                memcpy(item.data, view.data, view.len);
+                CHECK(dstr_array_set(array, index, view));
+            } else {
+                CHECK(dstr_array_set(array, index, (DStrView){item.data, item.len}));
+            }
+            model[index] = item;
+        } else if (op < 9 && model_count != 0) {
+            index = test_below(model_count);
+            CHECK(dstr_array_remove(array, index));
+            memmove(model + index, model + index + 1, (model_count - index - 1) * sizeof(ModelItem));
+            --model_count;
+        } else if (test_below(50) == 0) {
+            CHECK(dstr_array_compact(array) && dstr_array_waste(array) == 0);
+        }
+
+        if (step % 5000 == 0) check_model(array);
+    }
+    check_model(array);
+
+    CHECK(!dstr_array_set(array, model_count, (DStrView){"x", 1}));
+    CHECK(!dstr_array_remove(array, model_count));
+
+    check_join(array, (DStrView){", ", 2});
+    check_join(array, (DStrView){NULL, 0});
+    CHECK(dstr_array_compact(array) && dstr_array_waste(array) == 0);
+    check_model(array);
+
+    dstr_array_clear(array);
+    model_count = 0;
+    check_join(array, (DStrView){"-", 1});
+    CHECK(dstr_array_compact(array));
+    CHECK(dstr_array_reserve(array, 10, 100) && dstr_array_push(array, (DStrView){NULL, 0}));
+    model[model_count++].len = 0;
+    check_join(array, (DStrView){"-", 1});
+
+    dstr_array_destroy(array);
+}
+
+int main(void) {
+    test_model();
+    return 0;
+}
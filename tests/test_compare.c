@@ -0,0 +1,134 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <string.h>
+
+#define TEXT_MAX 300
+
+// 参照模型：按长度逐字节无符号比较，公共前缀相同时较短者较小
+static int naive_compare(const char *a, const size_t a_len, const char *b, const size_t b_len) {
+    for (size_t i = 0; i < a_len && i < b_len; ++i) {
+        if (a[i] != b[i]) return (unsigned char) a[i] < (unsigned char) b[i] ? -1 : 1;
+    }
+    return a_len < b_len ? -1 : a_len > b_len;
+}
+
+static bool naive_contains(const char *hay, const size_t hay_len, const char *sub, const size_t sub_len) {
+    if (sub_len == 0 || sub_len > hay_len) return false;
+    for (size_t i = 0; i + sub_len <= hay_len; ++i) {
+        if (memcmp(hay + i, sub, sub_len) == 0) return true;
+    }
+    return false;
+}
+
+static int sign(const int value) {
+    return (value > 0) - (value < 0);
+}
+
+// 以 a、b 两段内容检查全部判断与比较，字符串形式、视图形式与 C 字符串形式（b 截断于第一个 '\0'）
+static void check_pair(const char *a, const size_t a_len, const char *b, const size_t b_len) {
+    const DStrView view_a = {a, a_len}, view_b = {b, b_len};
+    const size_t cstr_len = strlen(b);
+    const int expected = naive_compare(a, a_len, b, b_len);
+    const bool prefix = b_len != 0 && b_len <= a_len && memcmp(a, b, b_len) == 0;
+    const bool suffix = b_len != 0 && b_len <= a_len && memcmp(a + a_len - b_len, b, b_len) == 0;
+    const bool contains = naive_contains(a, a_len, b, b_len);
+    DString *dstr_a, *dstr_b;
+
+    dstr_a = dstr_create_n(a, a_len);
+    dstr_b = dstr_create_n(b, b_len);
+    CHECK(dstr_a != NULL && dstr_b != NULL);
+
+    CHECK(sign(dstr_compare(dstr_a, dstr_b)) == expected);
+    CHECK(sign(dstr_compare(dstr_b, dstr_a)) == -expected);
+    CHECK(sign(dstr_compare_view(dstr_a, view_b)) == expected);
+    CHECK(sign(dstr_view_compare(view_a, view_b)) == expected);
+    CHECK(sign(dstr_compare_cstr(dstr_a, b)) == naive_compare(a, a_len, b, cstr_len));
+
+    CHECK(dstr_equals(dstr_a, dstr_b) == (expected == 0));
+    CHECK(dstr_equals_view(dstr_a, view_b) == (expected == 0));
+    CHECK(dstr_view_equals(view_a, view_b) == (expected == 0));
+    CHECK(dstr_equals_cstr(dstr_a, b) == (naive_compare(a, a_len, b, cstr_len) == 0));
+
+    CHECK(dstr_starts_with(dstr_a, dstr_b) == prefix && dstr_starts_with_view(dstr_a, view_b) == prefix);
+    CHECK(dstr_ends_with(dstr_a, dstr_b) == suffix && dstr_ends_with_view(dstr_a, view_b) == suffix);
+    CHECK(dstr_contains(dstr_a, dstr_b) == contains && dstr_contains_view(dstr_a, view_b) == contains);
+    CHECK(dstr_starts_with_cstr(dstr_a, b) == (cstr_len != 0 && cstr_len <= a_len && memcmp(a, b, cstr_len) == 0));
+    CHECK(dstr_ends_with_cstr(dstr_a, b) ==
+          (cstr_len != 0 && cstr_len <= a_len && memcmp(a + a_len - cstr_len, b, cstr_len) == 0));
+    CHECK(dstr_contains_cstr(dstr_a, b) == naive_contains(a, a_len, b, cstr_len));
+
+    // 两者都缓存了哈希值后相等判断走哈希的捷径，结果不变
+    (void) dstr_hash(dstr_a);
+    (void) dstr_hash(dstr_b);
+    CHECK(dstr_equals(dstr_a, dstr_b) == (expected == 0) && dstr_equals(dstr_b, dstr_a) == (expected == 0));
+
+    dstr_destroy(dstr_a);
+    dstr_destroy(dstr_b);
+}
+
+// 随机内容：含 '\0' 与高位字节的小字母表，b 常取 a 的前缀、后缀、子串或只差一个字节的副本
+static void check_random(void) {
+    static const char alphabet[] = {'\0', 'a', 'b', '\x7f', '\x80', '\xff'};
+    char a[TEXT_MAX + 1], b[TEXT_MAX + 1];
+    size_t a_len, b_len, start;
+
+    test_seed(11);
+    for (int step = 0; step < 200000; ++step) {
+        a_len = test_below(test_below(4) == 0 ? TEXT_MAX : 40);
+        test_fill(a, a_len, alphabet, test_below(2) == 0 ? 2 : sizeof(alphabet));
+        a[a_len] = '\0';
+
+        switch (test_below(5)) {
+            case 0:
+                b_len = test_below(a_len + 1);
+                memcpy(b, a, b_len);
+                break;
+            case 1:
+                b_len = test_below(a_len + 1);
+                memcpy(b, a + a_len - b_len, b_len);
+                break;
+            case 2:
+                b_len = test_below(a_len + 1);
+                start = test_below(a_len - b_len + 1);
+                memcpy(b, a + start, b_len);
+                break;
+            case 3:
+                // 相同长度，至多一个字节不同，位置落在向量宽度的各处
+                b_len = a_len;
+                memcpy(b, a, b_len);
+                if (b_len != 0) b[test_below(b_len)] = alphabet[test_below(sizeof(alphabet))];
+                break;
+            default:
+                b_len = test_below(test_below(4) == 0 ? TEXT_MAX : 40);
+                test_fill(b, b_len, alphabet, sizeof(alphabet));
+                break;
+        }
+        b[b_len] = '\0';
+        check_pair(a, a_len, b, b_len);
+    }
+}
+
+// 边界：空串、只差结尾、嵌入的 '\0' 与无符号的高位字节
+static void check_edges(void) {
+    check_pair("", 0, "", 0);
+    check_pair("a", 1, "", 0);
+    check_pair("", 0, "a", 1);
+    check_pair("a\0b", 3, "a\0c", 3);
+    check_pair("a\0b", 3, "a", 1);
+    check_pair("a", 1, "a\0", 2);
+    check_pair("\0\0\0", 3, "\0\0", 2);
+    check_pair("\x80", 1, "\x7f", 1);
+    check_pair("\xff" "abc", 4, "a", 1);
+    check_pair("abc\0def", 7, "c\0d", 3);
+    check_pair("abc\0def", 7, "def", 3);
+}
+
+int main(void) {
+    check_edges();
+    check_random();
+    return 0;
+}
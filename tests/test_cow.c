@@ -0,0 +1,173 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 足够长，保证数据位于可共享的堆缓冲中；首尾带空白以便 dstr_trim 有事可做
+static const char BASE[] = "  the quick brown fox jumps over the lazy dog; the dog sleeps, the fox runs away  ";
+
+static DStrPattern *pattern;
+
+// 以第 which 种写入方式修改 dstr，other 为不相关的另一个字符串；返回写入函数的结果。
+// 来源指向 dstr 自身的情形只用于文档声明支持别名的函数
+static bool apply_writer(const int which, DString *dstr, const DString *other) {
+    static const DStrReplacePair pairs[] = {{"the", "THE"}, {"fox", "cat"}, {"o", "0"}};
+    static const char *const cstr_pieces[] = {"<", "mid", ">"};
+    const DStrView pieces[] = {{"[", 1}, dstr_view(dstr), {"]", 1}};
+    char *out;
+
+    switch (which) {
+        case 0: return dstr_cpy_cstr(dstr, "replaced entirely");
+        case 1: return dstr_cpy(dstr, other);
+        case 2: return dstr_cat_cstr(dstr, " tail");
+        case 3: return dstr_cat(dstr, other);
+        case 4: return dstr_cat(dstr, dstr);
+        case 5: return dstr_cat_n(dstr, "a\0b", 3);
+        case 6: return dstr_insert_cstr(dstr, dstr_cstr(dstr) + 30, 5);
+        case 7: return dstr_insert(dstr, dstr, 3);
+        case 8: return dstr_cpy_sub_cstr(dstr, "0123456789", 2, 5);
+        case 9: return dstr_cpy_sub(dstr, other, 1, 3);
+        case 10: return dstr_cat_sub_cstr(dstr, "0123456789", 7, 0);
+        case 11: return dstr_cat_sub(dstr, other, 1, 4);
+        case 12: return dstr_insert_sub_cstr(dstr, dstr_cstr(dstr) + 40, 0, 1, 3);
+        case 13: return dstr_insert_sub(dstr, dstr, 10, 2, 6);
+        case 14: dstr_remove(dstr, 3, 7); return true;
+        case 15: dstr_remove(dstr, 20, 0); return true;
+        case 16: dstr_trim(dstr); return true;
+        case 17: dstr_clear(dstr); return true;
+        case 18: return dstr_printf(dstr, "%d-%s", 42, "printf");
+        case 19: return dstr_appendf(dstr, "[%S|%5.3S]", dstr, other);
+        case 20: return dstr_cat_i64(dstr, -1234567);
+        case 21: return dstr_cat_u64(dstr, 987654321);
+        case 22: return dstr_cat_double(dstr, 0.1);
+        case 23: return dstr_replace_cstr(dstr, "the", "a", 0, false) != 0;
+        case 24: return dstr_replace_cstr(dstr, "o", "OOO", 2, true) != 0;
+        case 25: return dstr_replace(dstr, other, dstr, 0, false) != 0;
+        case 26: return dstr_replace_many(dstr, pairs, sizeof(pairs) / sizeof(pairs[0])) != 0;
+        case 27: return dstr_replace_pattern(dstr, pattern, "<dog>", 0, false) != 0;
+        case 28: return dstr_cpy_view(dstr, dstr_view_sub(dstr, 2, 9));
+        case 29: return dstr_cat_view(dstr, dstr_view_sub(dstr, 0, 5));
+        case 30: return dstr_insert_view(dstr, (DStrView){"view", 4}, 1);
+        case 31: return dstr_cat_many(dstr, pieces, sizeof(pieces) / sizeof(pieces[0]));
+        case 32: return dstr_cat_many_cstr(dstr, cstr_pieces, sizeof(cstr_pieces) / sizeof(cstr_pieces[0]));
+        case 33: return dstr_cat_all(dstr, "x", dstr_cstr(dstr), "y", NULL);
+        case 34:
+            out = dstr_prepare_append(dstr, 8);
+            if (out == NULL) return false;
+            memcpy(out, "prepared", 8);
+            return dstr_commit_append(dstr, 8);
+        case 35: return dstr_resize_capacity(dstr, 16);
+        case 36: return dstr_resize_capacity(dstr, 4096);
+        default: return false;
+    }
+}
+
+#define WRITER_COUNT 37
+
+static bool same_content(const DString *dstr, const DString *expected) {
+    return dstr_length(dstr) == dstr_length(expected) &&
+           memcmp(dstr_cstr(dstr), dstr_cstr(expected), dstr_length(expected)) == 0 &&
+           dstr_cstr(dstr)[dstr_length(dstr)] == '\0';
+}
+
+// writer 作用于共享数据的一方，另一方不受影响，结果与在未共享的字符串上相同，缓存的哈希值随之更新
+static void check_writer(const int which, const bool modify_clone) {
+    DString *original, *clone, *target, *bystander, *expected, *other;
+    bool result, expected_result;
+
+    original = dstr_create(BASE);
+    other = dstr_create("other");
+    expected = dstr_create(BASE);
+    CHECK(original != NULL && other != NULL && expected != NULL);
+    CHECK(dstr_set_copy_on_write(original, true) && dstr_copy_on_write(original));
+
+    // 先计算哈希值，克隆随共享数据一并带走缓存
+    (void) dstr_hash(original);
+    clone = dstr_clone(original);
+    CHECK(clone != NULL && dstr_is_shared(original) && dstr_is_shared(clone));
+    CHECK(dstr_cstr(clone) == dstr_cstr(original) && dstr_hash(clone) == dstr_hash(original));
+
+    target = modify_clone ? clone : original;
+    bystander = modify_clone ? original : clone;
+
+    CHECK(dstr_set_copy_on_write(expected, false));
+    expected_result = apply_writer(which, expected, other);
+    result = apply_writer(which, target, other);
+
+    if (result != expected_result || !same_content(target, expected)) {
+        fprintf(stderr, "writer %d (%s): got \"%s\", expected \"%s\"\n", which, modify_clone ? "clone" : "original",
+                dstr_cstr(target), dstr_cstr(expected));
+    }
+    CHECK(result == expected_result && same_content(target, expected));
+    CHECK(dstr_length(bystander) == sizeof(BASE) - 1 && strcmp(dstr_cstr(bystander), BASE) == 0);
+    CHECK(dstr_hash(target) == dstr_hash_view(dstr_view(target)));
+    CHECK(dstr_hash(bystander) == dstr_hash_view(dstr_view(bystander)));
+
+    // 内容改变后双方不再共享同一块数据；失败或未改变内容的写入可以继续共享
+    if (!same_content(target, bystander)) {
+        CHECK(dstr_cstr(target) != dstr_cstr(bystander));
+        CHECK(!dstr_is_shared(bystander) || !dstr_is_shared(target));
+    }
+
+    dstr_destroy(original);
+    dstr_destroy(clone);
+    dstr_destroy(expected);
+    dstr_destroy(other);
+}
+
+// 多个克隆共享同一块数据，逐个修改或销毁，引用计数归零时数据才释放（由 ASan/泄漏检查兜底）
+static void test_many_sharers(void) {
+    enum { SHARERS = 64 };
+    DString *original, *clones[SHARERS];
+    size_t len, cap;
+    char *released;
+
+    original = dstr_create(BASE);
+    CHECK(original != NULL && dstr_set_copy_on_write(original, true));
+
+    for (size_t i = 0; i < SHARERS; ++i) {
+        clones[i] = i % 2 == 0 ? dstr_clone(original) : dstr_clone(clones[i - 1]);
+        CHECK(clones[i] != NULL && dstr_cstr(clones[i]) == dstr_cstr(original));
+    }
+    // dstr_cpy 也共享数据
+    CHECK(dstr_cpy(clones[0], clones[1]) && dstr_cstr(clones[0]) == dstr_cstr(original));
+
+    for (size_t i = 0; i < SHARERS; ++i) {
+        if (i % 3 == 0) {
+            CHECK(dstr_cat_cstr(clones[i], "!"));
+            CHECK(dstr_length(clones[i]) == sizeof(BASE) && strcmp(dstr_cstr(original), BASE) == 0);
+            dstr_destroy(clones[i]);
+        } else if (i % 3 == 1) {
+            // 取出共享的缓冲时复制出独立的一份
+            released = dstr_release(clones[i], &len, &cap);
+            CHECK(released != NULL && len == sizeof(BASE) - 1 && strcmp(released, BASE) == 0);
+            CHECK(released != dstr_cstr(original));
+            free(released);
+        } else {
+            dstr_destroy(clones[i]);
+        }
+    }
+    CHECK(!dstr_is_shared(original) && strcmp(dstr_cstr(original), BASE) == 0);
+
+    // 独占的共享块可以原地修改
+    CHECK(dstr_cat_cstr(original, "?") && dstr_length(original) == sizeof(BASE));
+    dstr_destroy(original);
+}
+
+int main(void) {
+    pattern = dstr_pattern_create("dog");
+    CHECK(pattern != NULL);
+
+    for (int which = 0; which < WRITER_COUNT; ++which) {
+        check_writer(which, true);
+        check_writer(which, false);
+    }
+    test_many_sharers();
+
+    dstr_pattern_destroy(pattern);
+    return 0;
+}
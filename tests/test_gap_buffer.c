@@ -0,0 +1,100 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_gap_buffer.h"
+#include "test_util.h"
+#include <string.h>
+
+#define MODEL_MAX (256 * 1024)
+
+// 以扁平缓冲与光标为参照模型
+static char model[MODEL_MAX];
+static size_t model_len, model_cursor;
+
+static void check_model(DStrGapBuffer *gap) {
+    DString *flat;
+    DStrView view;
+
+    CHECK(dstr_gap_length(gap) == model_len && dstr_gap_cursor(gap) == model_cursor);
+    for (size_t i = 0; i < model_len; i += 1 + test_below(64)) {
+        CHECK(dstr_gap_at(gap, i) == model[i]);
+    }
+
+    view = dstr_gap_view(gap);
+    CHECK(view.len == model_len && memcmp(view.data, model, model_len) == 0 && view.data[model_len] == '\0');
+
+    flat = dstr_gap_to_dstr(gap);
+    CHECK(flat != NULL && dstr_length(flat) == model_len && memcmp(dstr_cstr(flat), model, model_len) == 0);
+    dstr_destroy(flat);
+}
+
+int main(void) {
+    DStrGapBuffer *gap;
+    char buf[512];
+    size_t len, count, removed, found, expected, index;
+    int op;
+
+    test_seed(12);
+    test_fill(buf, 40, "xyz", 3);
+    gap = dstr_gap_create((DStrView){buf, 40});
+    CHECK(gap != NULL);
+    memcpy(model, buf, 40);
+    model_len = model_cursor = 40;
+
+    for (int step = 0; step < 200000; ++step) {
+        op = (int) test_below(8);
+        if (op < 3 && model_len + sizeof(buf) < MODEL_MAX) {
+            len = 1 + test_below(test_below(8) == 0 ? sizeof(buf) : 8);
+            test_fill(buf, len, "xyz", 3);
+            CHECK(dstr_gap_insert(gap, (DStrView){buf, len}));
+            memmove(model + model_cursor + len, model + model_cursor, model_len - model_cursor);
+            memcpy(model + model_cursor, buf, len);
+            model_len += len;
+            model_cursor += len;
+        } else if (op == 3) {
+            count = test_below(16);
+            removed = dstr_gap_delete_backward(gap, count);
+            CHECK(removed == (count < model_cursor ? count : model_cursor));
+            memmove(model + model_cursor - removed, model + model_cursor, model_len - model_cursor);
+            model_len -= removed;
+            model_cursor -= removed;
+        } else if (op == 4) {
+            count = test_below(16);
+            removed = dstr_gap_delete_forward(gap, count);
+            CHECK(removed == (count < model_len - model_cursor ? count : model_len - model_cursor));
+            memmove(model + model_cursor, model + model_cursor + removed, model_len - model_cursor - removed);
+            model_len -= removed;
+        } else if (op == 5) {
+            // 光标多为小幅移动，偶尔跳到任意位置或越界
+            index = test_below(4) == 0 ? test_below(model_len + 2)
+                                       : model_cursor + test_below(9) - (model_cursor < 4 ? model_cursor : 4);
+            CHECK(dstr_gap_set_cursor(gap, index) == (index <= model_len));
+            if (index <= model_len) model_cursor = index;
+        } else if (op == 6 && test_below(20) == 0) {
+            len = 1 + test_below(4);
+            test_fill(buf, len, "xyz", 3);
+            expected = SIZE_MAX;
+            for (size_t i = 0; i + len <= model_len; ++i) {
+                if (memcmp(model + i, buf, len) == 0) {
+                    expected = i;
+                    break;
+                }
+            }
+            if (dstr_gap_find(gap, (DStrView){buf, len}, &found, false)) {
+                CHECK(found == expected);
+            } else {
+                CHECK(expected == SIZE_MAX);
+            }
+            // 取连续内容后光标不变，之后的编辑仍在原光标处进行
+            CHECK(dstr_gap_cursor(gap) == model_cursor);
+        }
+
+        if (step % 5000 == 0) check_model(gap);
+    }
+    check_model(gap);
+    CHECK(!dstr_gap_insert(gap, (DStrView){NULL, 0}));
+
+    dstr_gap_destroy(gap);
+    return 0;
+}
@@ -0,0 +1,195 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <string.h>
+
+#define MODEL_MAX (64 * 1024)
+
+// 以扁平缓冲为参照模型，随机追加与删除，检查内容及「容量始终容纳内容与 '\0'」
+static void check_model_ops(const DStrGrowthPolicy *policy, const uint64_t seed) {
+    static char model[MODEL_MAX];
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr;
+    char buf[512];
+    size_t model_len, len, index, count;
+
+    test_seed(seed);
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_create_with_allocator("", &allocator);
+    CHECK(dstr != NULL && dstr_set_growth_policy(dstr, policy));
+    CHECK(dstr_growth_policy(dstr) == policy);
+    model_len = 0;
+
+    for (int step = 0; step < 20000; ++step) {
+        if (test_below(3) != 0 && model_len + sizeof(buf) < MODEL_MAX) {
+            len = 1 + test_below(test_below(8) == 0 ? sizeof(buf) - 1 : 16);
+            test_fill(buf, len, "abc", 3);
+            CHECK(dstr_cat_n(dstr, buf, len));
+            memcpy(model + model_len, buf, len);
+            model_len += len;
+        } else if (model_len != 0) {
+            // 偶尔大段删除，以触发收缩
+            index = test_below(model_len);
+            count = test_below(10) == 0 ? model_len - index : 1 + test_below(model_len - index);
+            dstr_remove(dstr, index, count);
+            memmove(model + index, model + index + count, model_len - index - count);
+            model_len -= count;
+        }
+
+        CHECK(dstr_length(dstr) == model_len && dstr_capacity(dstr) > model_len);
+        if (step % 500 == 0) {
+            CHECK(memcmp(dstr_cstr(dstr), model, model_len) == 0 && dstr_cstr(dstr)[model_len] == '\0');
+        }
+    }
+
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+// 逐字节追加时扩容次数应与长度成对数关系
+static void check_geometric_growth(void) {
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr;
+
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_create_with_allocator("", &allocator);
+    CHECK(dstr != NULL && dstr_set_growth_policy(dstr, &DSTR_GROWTH_1_5X));
+
+    for (int i = 0; i < 100000; ++i) CHECK(dstr_cat_cstr(dstr, "x"));
+    // 1.5^30 远大于 100000，另留出创建与内嵌缓冲转为堆缓冲的次数
+    CHECK(test_stats_calls(&stats) < 40);
+
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+// 在阈值附近反复增删不触碰分配器；低于收缩阈值时才收缩，且收缩后仍保留余量
+static void check_hysteresis(void) {
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr;
+    size_t calls, cap, len;
+
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_create_with_allocator("", &allocator);
+    CHECK(dstr != NULL && dstr_set_growth_policy(dstr, &DSTR_GROWTH_1_5X));
+    for (int i = 0; i < 4096; ++i) CHECK(dstr_cat_cstr(dstr, "y"));
+
+    calls = test_stats_calls(&stats);
+    cap = dstr_capacity(dstr);
+    for (int i = 0; i < 10000; ++i) {
+        dstr_remove(dstr, dstr_length(dstr) - 1, 1);
+        CHECK(dstr_cat_cstr(dstr, "y"));
+    }
+    CHECK(test_stats_calls(&stats) == calls && dstr_capacity(dstr) == cap);
+
+    // 删到一半仍高于 25% 的收缩阈值，容量不变
+    dstr_remove(dstr, 0, dstr_length(dstr) / 2);
+    CHECK(test_stats_calls(&stats) == calls && dstr_capacity(dstr) == cap);
+
+    // 低于阈值后收缩，但不收缩到恰好容纳内容
+    len = cap / 8;
+    dstr_remove(dstr, len, 0);
+    CHECK(dstr_length(dstr) == len);
+    CHECK(dstr_capacity(dstr) < cap && dstr_capacity(dstr) > len + 1);
+
+    calls = test_stats_calls(&stats);
+    CHECK(dstr_cat_cstr(dstr, "y"));
+    CHECK(test_stats_calls(&stats) == calls);
+
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+// 精确策略：堆缓冲的容量只比内容多出指针对齐的余量
+static void check_exact_policy(void) {
+    DString *dstr;
+    size_t cap;
+
+    dstr = dstr_create("");
+    CHECK(dstr != NULL && dstr_set_growth_policy(dstr, &DSTR_GROWTH_EXACT));
+    for (int i = 0; i < 2000; ++i) {
+        CHECK(dstr_cat_cstr(dstr, "z"));
+        cap = dstr_capacity(dstr);
+        CHECK(cap > dstr_length(dstr));
+        if (cap > 3 * sizeof(size_t)) CHECK(cap < dstr_length(dstr) + 1 + sizeof(void *));
+    }
+    for (int i = 0; i < 1500; ++i) {
+        dstr_remove(dstr, 0, 1);
+        cap = dstr_capacity(dstr);
+        if (cap > 3 * sizeof(size_t)) CHECK(cap < dstr_length(dstr) + 1 + sizeof(void *));
+    }
+    dstr_destroy(dstr);
+}
+
+// max_growth 限制单次额外扩容，shrink_percent 为 0 时从不自动收缩
+static void check_capped_policy(void) {
+    static const DStrGrowthPolicy capped = {300, 64, 0};
+    DString *dstr;
+    size_t old_cap, cap;
+
+    dstr = dstr_create("");
+    CHECK(dstr != NULL && dstr_set_growth_policy(dstr, &capped));
+    for (int i = 0; i < 5000; ++i) {
+        old_cap = dstr_capacity(dstr);
+        CHECK(dstr_cat_cstr(dstr, "w"));
+        cap = dstr_capacity(dstr);
+        if (cap != old_cap) CHECK(cap <= old_cap + 64 + sizeof(void *));
+    }
+
+    cap = dstr_capacity(dstr);
+    dstr_remove(dstr, 1, 0);
+    CHECK(dstr_length(dstr) == 1 && dstr_capacity(dstr) == cap);
+    dstr_destroy(dstr);
+}
+
+// dstr_resize_capacity 设下的容量是自动收缩的下限
+static void check_min_capacity(void) {
+    DString *dstr;
+
+    dstr = dstr_create("");
+    CHECK(dstr != NULL && dstr_resize_capacity(dstr, 1000));
+    CHECK(dstr_capacity(dstr) >= 1000);
+    for (int i = 0; i < 900; ++i) CHECK(dstr_cat_cstr(dstr, "m"));
+    dstr_remove(dstr, 1, 0);
+    CHECK(dstr_capacity(dstr) >= 1000 && dstr_equals_cstr(dstr, "m"));
+    dstr_destroy(dstr);
+}
+
+// 全局默认策略只影响未单独设置策略的字符串
+static void check_default_policy(void) {
+    DString *follows, *own;
+
+    follows = dstr_create("a");
+    own = dstr_create("b");
+    CHECK(follows != NULL && own != NULL && dstr_set_growth_policy(own, &DSTR_GROWTH_EXACT));
+
+    dstr_set_default_growth_policy(&DSTR_GROWTH_2X);
+    CHECK(dstr_default_growth_policy() == &DSTR_GROWTH_2X);
+    CHECK(dstr_growth_policy(follows) == &DSTR_GROWTH_2X && dstr_growth_policy(own) == &DSTR_GROWTH_EXACT);
+
+    CHECK(dstr_set_growth_policy(own, NULL) && dstr_growth_policy(own) == &DSTR_GROWTH_2X);
+    dstr_set_default_growth_policy(NULL);
+    CHECK(dstr_growth_policy(follows) == &DSTR_GROWTH_1_5X && dstr_growth_policy(own) == &DSTR_GROWTH_1_5X);
+
+    dstr_destroy(follows);
+    dstr_destroy(own);
+}
+
+int main(void) {
+    check_model_ops(&DSTR_GROWTH_1_5X, 1);
+    check_model_ops(&DSTR_GROWTH_2X, 2);
+    check_model_ops(&DSTR_GROWTH_EXACT, 3);
+    check_geometric_growth();
+    check_hysteresis();
+    check_exact_policy();
+    check_capped_policy();
+    check_min_capacity();
+    check_default_policy();
+    return 0;
+}
@@ -0,0 +1,188 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <stdarg.h>
+#include <string.h>
+
+#define LENGTH_MAX 2000
+#define THREAD_COUNT 8
+
+#define WRITER_COUNT 36
+
+static bool vappendf_wrapper(DString *dstr, const char *format, ...) {
+    va_list args;
+    bool result;
+
+    va_start(args, format);
+    result = dstr_vappendf(dstr, format, args);
+    va_end(args);
+    return result;
+}
+
+// 以第 op 个写入操作改写 dstr，参数随机；返回值不重要，只要求缓存与内容一致
+static void apply_writer(DString *dstr, const int op, const DString *other, const DStrPattern *pattern,
+                         const DStrReplaceSet *set) {
+    static const DStrReplacePair pairs[] = {{"ab", "b"}, {"ba", "aab"}};
+    const size_t len = dstr_length(dstr);
+    const size_t index = test_below(len + 1);
+    const size_t count = test_below(len - index + 1);
+    const char *const pieces[] = {"a", "", "bb"};
+    char *write;
+
+    switch (op) {
+        case 0: dstr_clear(dstr); break;
+        case 1: (void) dstr_resize_capacity(dstr, 1 + test_below(len + 64)); break;
+        case 2: (void) dstr_cpy_cstr(dstr, "abba"); break;
+        case 3: (void) dstr_cpy(dstr, other); break;
+        case 4: (void) dstr_cat_cstr(dstr, "ab"); break;
+        case 5: (void) dstr_cat(dstr, test_below(2) == 0 ? other : dstr); break;
+        case 6: (void) dstr_cat_n(dstr, "a\0b", 3); break;
+        case 7: (void) dstr_insert_cstr(dstr, "ba", index); break;
+        case 8: (void) dstr_insert(dstr, test_below(2) == 0 ? other : dstr, index); break;
+        case 9: (void) dstr_cpy_sub_cstr(dstr, "abbaab", test_below(6), test_below(3)); break;
+        case 10: (void) dstr_cpy_sub(dstr, other, test_below(dstr_length(other)), 0); break;
+        case 11: (void) dstr_cat_sub_cstr(dstr, "abbaab", test_below(6), test_below(3)); break;
+        case 12: (void) dstr_cat_sub(dstr, other, 0, test_below(dstr_length(other) + 1)); break;
+        case 13: (void) dstr_insert_sub_cstr(dstr, "abbaab", index, test_below(6), test_below(3)); break;
+        case 14: (void) dstr_insert_sub(dstr, other, index, 0, 0); break;
+        case 15: dstr_remove(dstr, index, count); break;
+        case 16:
+            (void) dstr_cat_cstr(dstr, " \t");
+            dstr_trim(dstr);
+            break;
+        case 17: (void) dstr_printf(dstr, "%zu", len); break;
+        case 18: (void) dstr_appendf(dstr, "%d%S", (int) index, other); break;
+        case 19: (void) vappendf_wrapper(dstr, "%.*S", (int) count, dstr); break;
+        case 20: (void) dstr_cat_i64(dstr, -(int64_t) index); break;
+        case 21: (void) dstr_cat_u64(dstr, count); break;
+        case 22: (void) dstr_cat_double(dstr, (double) index / 8); break;
+        case 23: (void) dstr_replace_cstr(dstr, "ab", "b", test_below(3), test_below(2) == 0); break;
+        case 24: (void) dstr_replace(dstr, other, dstr_length(other) > 4 ? other : dstr, 1, false); break;
+        case 25: (void) dstr_replace_many(dstr, pairs, 2); break;
+        case 26: (void) dstr_replace_many_set(dstr, set); break;
+        case 27: (void) dstr_replace_pattern(dstr, pattern, "a", test_below(3), test_below(2) == 0); break;
+        case 28: (void) dstr_cpy_view(dstr, dstr_view_sub(dstr, index, count)); break;
+        case 29: (void) dstr_cat_view(dstr, dstr_view_sub(dstr, index, count)); break;
+        case 30: (void) dstr_insert_view(dstr, dstr_view_cstr("bab"), index); break;
+        case 31: (void) dstr_cat_many(dstr, (DStrView[]){dstr_view(dstr), dstr_view(other)}, 2); break;
+        case 32: (void) dstr_cat_many_cstr(dstr, pieces, 3); break;
+        case 33: (void) dstr_cat_all(dstr, "a", "b", NULL); break;
+        case 34:
+            write = dstr_prepare_append(dstr, 8);
+            if (write == NULL) break;
+            memcpy(write, "baab", 4);
+            (void) dstr_commit_append(dstr, test_below(5));
+            break;
+        default:
+            // 共享数据的字符串：一方修改不影响另一方的缓存
+            (void) dstr_set_copy_on_write(dstr, test_below(2) == 0);
+            break;
+    }
+}
+
+// 每次写入前先求哈希使其缓存，写入后的哈希必须与按当前内容重新计算的结果一致
+static void check_writers(void) {
+    DString *dstr, *other, *clone;
+    DStrPattern *pattern;
+    DStrReplaceSet *set;
+    uint64_t clone_hash;
+    int op;
+
+    dstr = dstr_create("abba");
+    other = dstr_create("ba");
+    pattern = dstr_pattern_create("ba");
+    set = dstr_replace_set_create((DStrReplacePair[]){{"a", "bb"}, {"bbb", "a"}}, 2);
+    CHECK(dstr != NULL && other != NULL && pattern != NULL && set != NULL);
+    // 足够长时 dstr_cpy 与 other 共享数据，缓存由 other 复制而来或随之失效
+    (void) dstr_set_copy_on_write(other, true);
+
+    test_seed(17);
+    for (int step = 0; step < 200000; ++step) {
+        op = (int) test_below(WRITER_COUNT);
+        clone = test_below(4) == 0 ? dstr_clone(dstr) : NULL;
+        clone_hash = clone != NULL ? dstr_hash(clone) : 0;
+        CHECK(dstr_hash(dstr) == dstr_hash_view(dstr_view(dstr)));
+
+        apply_writer(dstr, op, other, pattern, set);
+
+        if (dstr_length(dstr) > LENGTH_MAX) dstr_remove(dstr, test_below(LENGTH_MAX), 0);
+        CHECK(dstr_hash(dstr) == dstr_hash_view(dstr_view(dstr)));
+        if (clone != NULL) {
+            CHECK(dstr_hash(clone) == clone_hash && dstr_hash(clone) == dstr_hash_view(dstr_view(clone)));
+            dstr_destroy(clone);
+        }
+
+        // other 偶尔随 dstr 变化，以便 dstr_cpy 等取到不同内容
+        if (test_below(16) == 0 && dstr_length(dstr) != 0) {
+            CHECK(dstr_cpy_sub(other, dstr, 0, dstr_length(dstr) < 64 ? 0 : 1 + test_below(64)));
+        }
+    }
+
+    dstr_replace_set_destroy(set);
+    dstr_pattern_destroy(pattern);
+    dstr_destroy(other);
+    dstr_destroy(dstr);
+}
+
+// 种子为 0 的结果即 dstr_hash_view；各长度下改动任一字节都会改变哈希
+static void check_values(void) {
+    char buf[300];
+    uint64_t hash;
+    DString *dstr;
+
+    test_seed(71);
+    for (size_t len = 0; len < sizeof(buf); ++len) {
+        test_fill(buf, len, "ab\0", 3);
+        hash = dstr_hash_view((DStrView){buf, len});
+        CHECK(dstr_hash_view_seeded((DStrView){buf, len}, 0) == hash);
+        CHECK(dstr_hash_view_seeded((DStrView){buf, len}, 1) != hash);
+
+        dstr = dstr_create_n(buf, len);
+        CHECK(dstr != NULL && dstr_hash(dstr) == hash);
+        if (len != 0) {
+            buf[test_below(len)] ^= 0x20;
+            CHECK(dstr_hash_view((DStrView){buf, len}) != hash);
+        }
+        dstr_destroy(dstr);
+    }
+}
+
+// 多个线程同时对同一个未修改的字符串求哈希，首次计算与写入缓存可能并发发生
+typedef struct HashWorker {
+    const DString *dstr;
+    uint64_t expected;
+} HashWorker;
+
+static void worker_hash(void *arg) {
+    const HashWorker *worker = arg;
+
+    for (int i = 0; i < 1000; ++i) CHECK(dstr_hash(worker->dstr) == worker->expected);
+}
+
+static void check_threads(void) {
+    HashWorker worker;
+    void *args[THREAD_COUNT];
+    DString *dstr;
+
+    dstr = dstr_create("");
+    CHECK(dstr != NULL);
+    worker.dstr = dstr;
+    for (size_t i = 0; i < THREAD_COUNT; ++i) args[i] = &worker;
+
+    for (int round = 0; round < 50; ++round) {
+        CHECK(dstr_cat_cstr(dstr, "shared read-only key "));
+        worker.expected = dstr_hash_view(dstr_view(dstr));
+        test_run_threads(worker_hash, args, THREAD_COUNT);
+    }
+    dstr_destroy(dstr);
+}
+
+int main(void) {
+    check_values();
+    check_writers();
+    check_threads();
+    return 0;
+}
@@ -0,0 +1,115 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_interner.h"
+#include "test_util.h"
+#include <string.h>
+
+#define KEY_COUNT 20000
+#define THREAD_COUNT 8
+
+// 第 k 个键的内容，偶数键以 '\0' 开头，各键互不相同
+static DStrView key_of(const size_t k, char *buf) {
+    int len;
+
+    buf[0] = '\0';
+    len = snprintf(buf + 1, 31, "key %zu", k);
+    return k % 2 == 0 ? (DStrView){buf, (size_t) len + 1} : (DStrView){buf + 1, (size_t) len};
+}
+
+// 与参照模型比较：每个键最多对应一个指针，查询不加入，数量等于不同内容的个数
+static void check_model(void) {
+    static const DString *pointers[KEY_COUNT];
+    DStrInterner *interner;
+    const DString *str;
+    DStrView view;
+    char buf[32];
+    size_t distinct, k;
+
+    interner = dstr_interner_create();
+    CHECK(interner != NULL && dstr_interner_count(interner) == 0);
+    CHECK(dstr_interner_lookup(interner, dstr_view_cstr("absent")) == NULL);
+
+    test_seed(16);
+    distinct = 0;
+    for (int step = 0; step < 200000; ++step) {
+        k = test_below(test_below(4) == 0 ? KEY_COUNT : 64);
+        view = key_of(k, buf);
+        CHECK(dstr_interner_lookup(interner, view) == pointers[k]);
+        if (test_below(4) == 0) continue;
+
+        str = dstr_intern(interner, view);
+        CHECK(str != NULL && dstr_equals_view(str, view));
+        CHECK(dstr_hash(str) == dstr_hash_view(view));
+        if (pointers[k] == NULL) {
+            pointers[k] = str;
+            ++distinct;
+        }
+        CHECK(str == pointers[k]);
+        CHECK(dstr_interner_count(interner) == distinct);
+    }
+
+    // 空串与 C 字符串形式
+    str = dstr_intern(interner, (DStrView){NULL, 0});
+    CHECK(str != NULL && dstr_length(str) == 0 && dstr_intern_cstr(interner, "") == str);
+    CHECK(dstr_intern_cstr(interner, "key 1") == pointers[1] || pointers[1] == NULL);
+    CHECK(dstr_intern_cstr(interner, "key 1") == dstr_interner_lookup(interner, dstr_view_cstr("key 1")));
+
+    dstr_interner_destroy(interner);
+}
+
+// 多线程：各线程以不同顺序驻留同一批键，每个键在所有线程中得到同一个指针
+typedef struct InternWorker {
+    DStrInterner *interner;
+    uint64_t seed;
+    const DString *pointers[KEY_COUNT];
+} InternWorker;
+
+static void worker_intern(void *arg) {
+    InternWorker *worker = arg;
+    const DString *str;
+    char buf[32];
+    DStrView view;
+    size_t k, start, stride;
+
+    // 以与 KEY_COUNT 互质的步长遍历全部键，起点与步长因线程而异
+    start = (size_t) (worker->seed * 7919) % KEY_COUNT;
+    stride = worker->seed % 2 == 0 ? 3 : 7;
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        k = (start + i * stride) % KEY_COUNT;
+        view = key_of(k, buf);
+        str = dstr_interner_lookup(worker->interner, view);
+        worker->pointers[k] = dstr_intern(worker->interner, view);
+        CHECK(worker->pointers[k] != NULL && dstr_equals_view(worker->pointers[k], view));
+        CHECK(str == NULL || str == worker->pointers[k]);
+    }
+}
+
+static void check_threads(void) {
+    static InternWorker workers[THREAD_COUNT];
+    void *args[THREAD_COUNT];
+    DStrInterner *interner;
+    size_t i, k;
+
+    interner = dstr_interner_create();
+    CHECK(interner != NULL);
+    for (i = 0; i < THREAD_COUNT; ++i) {
+        workers[i].interner = interner;
+        workers[i].seed = i + 1;
+        args[i] = &workers[i];
+    }
+    test_run_threads(worker_intern, args, THREAD_COUNT);
+
+    CHECK(dstr_interner_count(interner) == KEY_COUNT);
+    for (k = 0; k < KEY_COUNT; ++k) {
+        for (i = 1; i < THREAD_COUNT; ++i) CHECK(workers[i].pointers[k] == workers[0].pointers[k]);
+    }
+    dstr_interner_destroy(interner);
+}
+
+int main(void) {
+    check_model();
+    check_threads();
+    return 0;
+}
@@ -0,0 +1,215 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <string.h>
+
+// 内嵌缓冲的容量与头部中的堆指针、容量、下限三个字段共用空间
+#define SSO_CAP (3 * sizeof(size_t))
+
+// 数据是否位于 dstr 的头部之内
+static bool data_inline(const DString *dstr) {
+    const char *data, *header;
+
+    data = dstr_cstr(dstr);
+    header = (const char *) dstr;
+    return data >= header && data < header + sizeof(DStrStorage);
+}
+
+// 短字符串只申请头部，数据放在头部之内
+static void check_short_strings(void) {
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr, *copy;
+    size_t header_bytes;
+    char buf[SSO_CAP];
+
+    allocator = test_stats_allocator(&stats);
+    for (size_t len = 0; len < SSO_CAP; ++len) {
+        test_fill(buf, len, "a\0b", 3);
+        buf[len] = '\0';
+        dstr = dstr_create_with_allocator("", &allocator);
+        CHECK(dstr != NULL && stats.allocs == 1);
+        CHECK(dstr_cat_n(dstr, buf, len) == (len != 0));
+        CHECK(stats.allocs == 1 && stats.reallocs == 0);
+        CHECK(data_inline(dstr) && dstr_capacity(dstr) == SSO_CAP);
+        CHECK(dstr_length(dstr) == len && memcmp(dstr_cstr(dstr), buf, len + 1) == 0);
+
+        copy = dstr_clone(dstr);
+        CHECK(copy != NULL && stats.allocs == 2 && data_inline(copy) && dstr_equals(copy, dstr));
+
+        header_bytes = stats.live / 2;
+        dstr_destroy(copy);
+        CHECK(stats.live == header_bytes);
+        dstr_destroy(dstr);
+        CHECK(stats.live == 0);
+        stats = (TestAllocStats){.fail_after = SIZE_MAX};
+    }
+}
+
+// 越过内嵌容量时转为堆缓冲，缩回后重新内嵌并释放堆缓冲
+static void check_transitions(void) {
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr;
+    size_t header_bytes;
+
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_create_with_allocator("", &allocator);
+    CHECK(dstr != NULL);
+    header_bytes = stats.live;
+
+    for (int round = 0; round < 50; ++round) {
+        while (dstr_length(dstr) < SSO_CAP - 1) CHECK(dstr_cat_cstr(dstr, "s"));
+        CHECK(data_inline(dstr) && stats.live == header_bytes);
+
+        CHECK(dstr_cat_cstr(dstr, "t"));
+        CHECK(!data_inline(dstr) && dstr_capacity(dstr) > SSO_CAP && stats.live > header_bytes);
+        for (int i = 0; i < 100; ++i) CHECK(dstr_cat_cstr(dstr, "u"));
+
+        dstr_remove(dstr, 2, 0);
+        CHECK(dstr_equals_cstr(dstr, "ss"));
+        CHECK(data_inline(dstr) && dstr_capacity(dstr) == SSO_CAP && stats.live == header_bytes);
+    }
+
+    // 显式缩容与清空同样回到内嵌缓冲
+    CHECK(dstr_cpy_cstr(dstr, "a string that is clearly longer than the inline buffer"));
+    CHECK(!data_inline(dstr));
+    CHECK(dstr_resize_capacity(dstr, 8));
+    CHECK(data_inline(dstr) && dstr_equals_cstr(dstr, "a strin") && stats.live == header_bytes);
+    CHECK(dstr_cpy_cstr(dstr, "a string that is clearly longer than the inline buffer"));
+    dstr_resize_capacity(dstr, 0);
+    CHECK(data_inline(dstr) && dstr_length(dstr) == 0 && stats.live == header_bytes);
+
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+// 数据是否位于从 dstr 开始的 size 字节之内
+static bool data_within(const DString *dstr, const size_t size) {
+    const char *data, *header;
+
+    data = dstr_cstr(dstr);
+    header = (const char *) dstr;
+    return data >= header && data < header + size;
+}
+
+// 尾随存储：头部与数据同属一次分配，超出时转到独立堆缓冲，缩回后重新使用尾随存储
+static void check_packed(void) {
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr, *copy;
+    size_t packed_bytes, calls;
+
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_create_packed_with_allocator("head", 256, &allocator);
+    CHECK(dstr != NULL && stats.allocs == 1 && dstr_equals_cstr(dstr, "head"));
+    packed_bytes = stats.live;
+
+    // 写时复制开启时不预留尾随存储，长内容一律放在可共享的共享块中
+    if (dstr_copy_on_write(dstr)) {
+        CHECK(packed_bytes < 256);
+        dstr_destroy(dstr);
+        CHECK(stats.live == 0);
+        return;
+    }
+    CHECK(packed_bytes >= sizeof(DStrStorage) + 256);
+
+    // 在尾随存储内增长不再申请内存
+    while (dstr_length(dstr) < 255) CHECK(dstr_cat_cstr(dstr, "p"));
+    CHECK(stats.allocs == 1 && stats.reallocs == 0 && data_within(dstr, packed_bytes));
+    CHECK(dstr_capacity(dstr) >= 256);
+
+    // 超出后转到独立的堆缓冲
+    CHECK(dstr_cat_cstr(dstr, "q"));
+    CHECK(stats.allocs == 2 && !data_within(dstr, packed_bytes) && stats.live > packed_bytes);
+    for (int i = 0; i < 300; ++i) CHECK(dstr_cat_cstr(dstr, "r"));
+
+    // 缩回后重新使用尾随存储并释放堆缓冲
+    dstr_remove(dstr, 50, 0);
+    CHECK(dstr_length(dstr) == 50 && data_within(dstr, packed_bytes) && !data_inline(dstr));
+    CHECK(stats.live == packed_bytes);
+
+    // 更短时回到内嵌缓冲，再增长时直接使用尾随存储
+    dstr_remove(dstr, 3, 0);
+    CHECK(dstr_equals_cstr(dstr, "hea") && data_inline(dstr));
+    calls = test_stats_calls(&stats);
+    while (dstr_length(dstr) < 200) CHECK(dstr_cat_cstr(dstr, "s"));
+    CHECK(test_stats_calls(&stats) == calls && data_within(dstr, packed_bytes) && !data_inline(dstr));
+
+    // 克隆只在以 DSTR_PACKED_LAYOUT 编译时采用单次分配布局，此处只检查内容与归还
+    copy = dstr_clone(dstr);
+    CHECK(copy != NULL && dstr_equals(copy, dstr));
+    dstr_destroy(copy);
+
+    CHECK(stats.live == packed_bytes);
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+// 以参照模型检查在内嵌与堆缓冲之间来回切换的各类写入
+static void check_model(void) {
+    char model[256], buf[64];
+    DString *dstr;
+    size_t model_len, len, index, count;
+
+    test_seed(2);
+    dstr = dstr_create("");
+    CHECK(dstr != NULL);
+    model_len = 0;
+
+    for (int step = 0; step < 100000; ++step) {
+        switch (test_below(4)) {
+            case 0:
+                len = test_below(2 * SSO_CAP);
+                if (model_len + len >= sizeof(model)) break;
+                test_fill(buf, len, "xy\0", 3);
+                CHECK(dstr_cat_n(dstr, buf, len) == (len != 0));
+                memcpy(model + model_len, buf, len);
+                model_len += len;
+                break;
+            case 1:
+                len = test_below(2 * SSO_CAP);
+                test_fill(buf, len, "xy\0", 3);
+                // 空内容的复制不做任何修改
+                CHECK(dstr_cpy_view(dstr, (DStrView){buf, len}) == (len != 0));
+                if (len == 0) break;
+                memcpy(model, buf, len);
+                model_len = len;
+                break;
+            case 2:
+                len = 1 + test_below(SSO_CAP);
+                if (model_len + len >= sizeof(model)) break;
+                index = test_below(model_len + 1);
+                test_fill(buf, len, "xy\0", 3);
+                CHECK(dstr_insert_view(dstr, (DStrView){buf, len}, index));
+                memmove(model + index + len, model + index, model_len - index);
+                memcpy(model + index, buf, len);
+                model_len += len;
+                break;
+            default:
+                if (model_len == 0) break;
+                index = test_below(model_len);
+                count = 1 + test_below(model_len - index);
+                dstr_remove(dstr, index, count);
+                memmove(model + index, model + index + count, model_len - index - count);
+                model_len -= count;
+                break;
+        }
+
+        CHECK(dstr_length(dstr) == model_len && memcmp(dstr_cstr(dstr), model, model_len) == 0);
+        CHECK(dstr_cstr(dstr)[model_len] == '\0' && dstr_capacity(dstr) > model_len);
+        if (dstr_capacity(dstr) == SSO_CAP) CHECK(data_inline(dstr));
+    }
+    dstr_destroy(dstr);
+}
+
+int main(void) {
+    check_short_strings();
+    check_transitions();
+    check_packed();
+    check_model();
+    return 0;
+}
@@ -0,0 +1,146 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_map.h"
+#include "test_util.h"
+#include <string.h>
+
+#define MODEL_MAX 4096
+#define KEY_MAX 6 // 键长 0 到 5，字母表为 4 个字符，共 1365 个不同的键
+
+// 以线性表为参照模型
+typedef struct ModelEntry {
+    char key[KEY_MAX];
+    size_t len;
+    void *value;
+} ModelEntry;
+
+static ModelEntry model[MODEL_MAX];
+static size_t model_count;
+
+static ModelEntry *model_find(const char *key, const size_t len) {
+    for (size_t i = 0; i < model_count; ++i) {
+        if (model[i].len == len && memcmp(model[i].key, key, len) == 0) return &model[i];
+    }
+    return NULL;
+}
+
+static void check_model(const DStrMap *map) {
+    DStrMapIter iter;
+    const DString *key;
+    ModelEntry *entry;
+    void *value;
+    size_t seen;
+
+    CHECK(dstr_map_size(map) == model_count);
+
+    for (size_t i = 0; i < model_count; ++i) {
+        CHECK(dstr_map_get(map, (DStrView){model[i].key, model[i].len}, &value) && value == model[i].value);
+    }
+
+    // 遍历恰好访问每个键一次
+    seen = 0;
+    dstr_map_iter_init(&iter, map);
+    while (dstr_map_iter_next(&iter, &key, &value)) {
+        entry = model_find(dstr_cstr(key), dstr_length(key));
+        CHECK(entry != NULL && entry->value == value && dstr_hash(key) == dstr_hash_view(dstr_view(key)));
+        ++seen;
+    }
+    CHECK(seen == model_count);
+}
+
+static void test_model(void) {
+    DStrMap *map;
+    DString *dstr_key;
+    ModelEntry *entry;
+    char key[KEY_MAX];
+    void *value, *found;
+    size_t len;
+    bool present;
+    int op;
+
+    map = dstr_map_create();
+    CHECK(map != NULL);
+
+    test_seed(18);
+    for (int step = 0; step < 400000; ++step) {
+        // 字母表很小，键的重复、删除后重新插入（墓碑复用）都会频繁发生
+        len = test_below(KEY_MAX);
+        test_fill(key, len, "ab\0c", 4);
+        value = (void *) (uintptr_t) (step + 1);
+        entry = model_find(key, len);
+        op = (int) test_below(10);
+
+        if (op < 4) {
+            if (op == 3) {
+                dstr_key = dstr_create_n(key, len);
+                CHECK(dstr_key != NULL && dstr_map_put_dstr(map, dstr_key, value));
+                dstr_destroy(dstr_key);
+            } else {
+                CHECK(dstr_map_put(map, (DStrView){key, len}, value));
+            }
+            if (entry != NULL) {
+                entry->value = value;
+            } else {
+                CHECK(model_count < MODEL_MAX);
+                memcpy(model[model_count].key, key, len);
+                model[model_count].len = len;
+                model[model_count++].value = value;
+            }
+        } else if (op < 7) {
+            present = dstr_map_remove(map, (DStrView){key, len}, &found);
+            CHECK(present == (entry != NULL));
+            if (entry != NULL) {
+                CHECK(found == entry->value);
+                *entry = model[--model_count];
+            }
+        } else if (op < 9) {
+            found = NULL;
+            present = dstr_map_get(map, (DStrView){key, len}, &found);
+            CHECK(present == (entry != NULL) && (!present || found == entry->value));
+        } else if (test_below(2000) == 0) {
+            dstr_map_clear(map);
+            model_count = 0;
+            CHECK(dstr_map_reserve(map, 1000));
+        }
+
+        if (step % 20000 == 0) check_model(map);
+    }
+    check_model(map);
+    dstr_map_destroy(map);
+}
+
+// 大量不同的键：验证扩容与 C 字符串接口
+static void test_growth(void) {
+    enum { COUNT = 200000 };
+    DStrMap *map;
+    char key[32];
+    void *value;
+
+    map = dstr_map_create();
+    CHECK(map != NULL);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        snprintf(key, sizeof(key), "key-%zu", i);
+        CHECK(dstr_map_put_cstr(map, key, (void *) (uintptr_t) (i + 1)));
+    }
+    CHECK(dstr_map_size(map) == COUNT);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        snprintf(key, sizeof(key), "key-%zu", i);
+        CHECK(dstr_map_get_cstr(map, key, &value) && value == (void *) (uintptr_t) (i + 1));
+        if (i % 2 == 0) CHECK(dstr_map_remove(map, dstr_view_cstr(key), NULL));
+    }
+    CHECK(dstr_map_size(map) == COUNT / 2);
+    CHECK(!dstr_map_get_cstr(map, "key-0", NULL) && dstr_map_get_cstr(map, "key-1", NULL));
+    CHECK(!dstr_map_get_cstr(map, "missing", NULL));
+
+    dstr_map_destroy(map);
+}
+
+int main(void) {
+    test_model();
+    test_growth();
+    return 0;
+}
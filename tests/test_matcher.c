@@ -0,0 +1,157 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_matcher.h"
+#include "test_util.h"
+#include <string.h>
+
+#define PATTERN_MAX 256
+#define PATTERN_LEN_MAX 16
+#define MATCH_MAX (1 << 20)
+
+typedef struct MatchList {
+    DStrMatch matches[MATCH_MAX];
+    size_t count;
+    size_t limit; // 收集到这么多个后要求停止
+} MatchList;
+
+static const char *patterns[PATTERN_MAX];
+static size_t lengths[PATTERN_MAX];
+static char pattern_text[PATTERN_MAX][PATTERN_LEN_MAX + 1];
+
+static bool collect(const DStrMatch *match, void *ctx) {
+    MatchList *list = ctx;
+
+    CHECK(list->count < MATCH_MAX);
+    list->matches[list->count++] = *match;
+    return list->count < list->limit;
+}
+
+// 参照模型：按结束位置从前到后，同一结束位置上先长后短，等长（重复的模式）按下标
+static void naive_matches(const char *text, const size_t text_len, const size_t count, MatchList *out) {
+    size_t end, len, i;
+
+    out->count = 0;
+    for (end = 1; end <= text_len; ++end) {
+        for (len = end < PATTERN_LEN_MAX ? end : PATTERN_LEN_MAX; len > 0; --len) {
+            for (i = 0; i < count; ++i) {
+                if (lengths[i] == len && memcmp(text + end - len, patterns[i], len) == 0) {
+                    CHECK(out->count < MATCH_MAX);
+                    out->matches[out->count++] = (DStrMatch){i, end - len};
+                }
+            }
+        }
+    }
+}
+
+static bool same_match(const DStrMatch *a, const DStrMatch *b) {
+    return a->pattern == b->pattern && a->index == b->index;
+}
+
+// 比较各接口与参照模型
+static void check_text(const DStrMatcher *matcher, const char *text, const size_t text_len, const size_t count) {
+    static MatchList expected, actual;
+    static size_t counts[PATTERN_MAX];
+    DString *dstr;
+    DStrMatch first;
+    size_t total, i;
+
+    naive_matches(text, text_len, count, &expected);
+    dstr = dstr_create_n(text, text_len);
+    CHECK(dstr != NULL);
+
+    actual.count = 0;
+    actual.limit = SIZE_MAX;
+    CHECK(dstr_matcher_find_all(matcher, dstr, collect, &actual) == expected.count);
+    CHECK(actual.count == expected.count);
+    for (i = 0; i < expected.count; ++i) CHECK(same_match(&actual.matches[i], &expected.matches[i]));
+
+    // 回调要求停止后不再报告
+    if (expected.count > 1) {
+        actual.count = 0;
+        actual.limit = 1 + test_below(expected.count - 1);
+        CHECK(dstr_matcher_find_all(matcher, dstr, collect, &actual) == actual.limit);
+        for (i = 0; i < actual.count; ++i) CHECK(same_match(&actual.matches[i], &expected.matches[i]));
+    }
+
+    CHECK(dstr_matcher_find_first(matcher, dstr, &first) == (expected.count != 0));
+    if (expected.count != 0) CHECK(same_match(&first, &expected.matches[0]));
+    CHECK(dstr_matcher_contains_any(matcher, dstr) == (expected.count != 0));
+
+    total = dstr_matcher_count(matcher, dstr, counts);
+    CHECK(total == expected.count);
+    for (i = 0; i < expected.count; ++i) --counts[expected.matches[i].pattern];
+    for (i = 0; i < count; ++i) CHECK(counts[i] == 0);
+
+    dstr_destroy(dstr);
+}
+
+// 随机的模式集合：小字母表（含 '\0'）、互为前后缀、重复与空模式
+static void check_random(void) {
+    static char text[2048];
+    DStrMatcher *matcher;
+    size_t count, text_len, i, start;
+    bool with_nul;
+
+    test_seed(8);
+    for (int step = 0; step < 3000; ++step) {
+        count = 1 + test_below(test_below(4) == 0 ? 64 : 8);
+        with_nul = test_below(2) == 0;
+        text_len = test_below(test_below(8) == 0 ? sizeof(text) : 100);
+        test_fill(text, text_len, with_nul ? "ab\0" : "abc", 3);
+
+        for (i = 0; i < count; ++i) {
+            patterns[i] = pattern_text[i];
+            if (i != 0 && test_below(8) == 0) {
+                // 重复前面的某个模式，或取其前缀
+                start = test_below(i);
+                lengths[i] = test_below(2) == 0 ? lengths[start] : test_below(lengths[start] + 1);
+                memcpy(pattern_text[i], pattern_text[start], lengths[i]);
+            } else if (text_len != 0 && test_below(2) == 0) {
+                lengths[i] = 1 + test_below(text_len < 12 ? text_len : 12);
+                memcpy(pattern_text[i], text + test_below(text_len - lengths[i] + 1), lengths[i]);
+            } else {
+                lengths[i] = test_below(8);
+                test_fill(pattern_text[i], lengths[i], with_nul ? "ab\0" : "abc", 3);
+            }
+            pattern_text[i][lengths[i]] = '\0';
+        }
+
+        // 不含 '\0' 的集合同时检查以 C 字符串构造的版本
+        matcher = with_nul ? dstr_matcher_create_n(patterns, lengths, count) : dstr_matcher_create(patterns, count);
+        CHECK(matcher != NULL && dstr_matcher_pattern_count(matcher) == count);
+        check_text(matcher, text, text_len, count);
+        dstr_matcher_destroy(matcher);
+    }
+}
+
+// 较大的字母表与较多的模式，覆盖字节等价类的压缩
+static void check_dictionary(void) {
+    static char text[20000];
+    DStrMatcher *matcher;
+    size_t count, i;
+
+    test_seed(88);
+    count = PATTERN_MAX;
+    for (i = 0; i < count; ++i) {
+        lengths[i] = 1 + test_below(6);
+        test_fill(pattern_text[i], lengths[i], "etaoinshrdlu", 12);
+        patterns[i] = pattern_text[i];
+    }
+    matcher = dstr_matcher_create_n(patterns, lengths, count);
+    CHECK(matcher != NULL);
+
+    for (int round = 0; round < 5; ++round) {
+        test_fill(text, sizeof(text), "etaoinshrdlucmfwyp \xff", 20);
+        check_text(matcher, text, sizeof(text), count);
+    }
+    check_text(matcher, "", 0, count);
+    dstr_matcher_destroy(matcher);
+}
+
+int main(void) {
+    check_random();
+    check_dictionary();
+    return 0;
+}
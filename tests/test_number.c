@@ -0,0 +1,212 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+static uint64_t bits_of(const double value) {
+    uint64_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double double_of(const uint64_t bits) {
+    double value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 以 strtod 逐个尝试 1 到 17 位有效数字，求能还原 value 的最短位数
+static int shortest_digits(const double value) {
+    char buf[40];
+
+    for (int precision = 1; precision < 17; ++precision) {
+        snprintf(buf, sizeof(buf), "%.*e", precision - 1, value);
+        if (strtod(buf, NULL) == value) return precision;
+    }
+    return 17;
+}
+
+// 统计格式化结果中的有效数字位数（去掉符号、小数点、指数与首尾的 0）
+static int significant_digits(const char *text) {
+    const char *begin, *end;
+    int count;
+
+    end = strchr(text, 'e');
+    if (end == NULL) end = text + strlen(text);
+    begin = text;
+    while (begin < end && (*begin == '-' || *begin == '0' || *begin == '.')) ++begin;
+    while (end > begin && (end[-1] == '0' || end[-1] == '.')) --end;
+
+    for (count = 0; begin < end; ++begin) {
+        if (*begin != '.') ++count;
+    }
+    return count;
+}
+
+static void test_integers(void) {
+    static const int64_t edges[] = {0, 1, -1, 9, 10, -10, 99, 100, INT32_MAX, INT32_MIN, INT64_MAX, INT64_MIN,
+                                    INT64_MAX - 1, INT64_MIN + 1, 1000000000000000000, -999999999999999999};
+    DString *dstr;
+    char expected[32];
+    int64_t i64, parsed;
+    uint64_t u64, value;
+
+    dstr = dstr_create(NULL);
+    CHECK(dstr != NULL);
+
+    test_seed(21);
+    for (size_t i = 0; i < 200000; ++i) {
+        i64 = i < sizeof(edges) / sizeof(edges[0]) ? edges[i] : (int64_t) (test_rand() >> test_below(64));
+        if (test_below(2) && i64 != INT64_MIN) i64 = -i64;
+
+        dstr_clear(dstr);
+        CHECK(dstr_cat_i64(dstr, i64));
+        snprintf(expected, sizeof(expected), "%" PRId64, i64);
+        CHECK(strcmp(dstr_cstr(dstr), expected) == 0);
+        CHECK(dstr_parse_i64(dstr, &parsed) && parsed == i64);
+
+        u64 = test_rand() >> test_below(64);
+        dstr_clear(dstr);
+        CHECK(dstr_cat_u64(dstr, u64));
+        snprintf(expected, sizeof(expected), "%" PRIu64, u64);
+        CHECK(strcmp(dstr_cstr(dstr), expected) == 0);
+        CHECK(dstr_parse_u64(dstr, &value) && value == u64);
+    }
+
+    // 边界与非法输入
+    CHECK(dstr_parse_i64_view(dstr_view_cstr("9223372036854775807"), &i64) && i64 == INT64_MAX);
+    CHECK(dstr_parse_i64_view(dstr_view_cstr("-9223372036854775808"), &i64) && i64 == INT64_MIN);
+    CHECK(!dstr_parse_i64_view(dstr_view_cstr("9223372036854775808"), &i64));
+    CHECK(!dstr_parse_i64_view(dstr_view_cstr("-9223372036854775809"), &i64));
+    CHECK(dstr_parse_u64_view(dstr_view_cstr("18446744073709551615"), &u64) && u64 == UINT64_MAX);
+    CHECK(!dstr_parse_u64_view(dstr_view_cstr("18446744073709551616"), &u64));
+    CHECK(!dstr_parse_u64_view(dstr_view_cstr("-1"), &u64));
+    CHECK(!dstr_parse_i64_view(dstr_view_cstr(""), &i64));
+    CHECK(!dstr_parse_i64_view(dstr_view_cstr("-"), &i64));
+    CHECK(!dstr_parse_i64_view(dstr_view_cstr(" 1"), &i64));
+    CHECK(!dstr_parse_i64_view(dstr_view_cstr("1x"), &i64));
+
+    dstr_destroy(dstr);
+}
+
+static void test_double_format(void) {
+    static const double edges[] = {0.0, -0.0, 1.0, -1.0, 0.1, 0.2, 0.3, 1e-6, 1e-7, 1e20, 1e21, 1e22, 123456789012345678.0,
+                                   5e-324, 2.2250738585072014e-308, 2.2250738585072009e-308, 1.7976931348623157e308,
+                                   9007199254740993.0, 0.000001234, 4.35, 1e23, 8.41e21};
+    DString *dstr;
+    double value, parsed;
+    size_t longer;
+    int shortest, produced;
+
+    dstr = dstr_create(NULL);
+    CHECK(dstr != NULL);
+
+    test_seed(42);
+    longer = 0;
+    for (size_t i = 0; i < 300000; ++i) {
+        if (i < sizeof(edges) / sizeof(edges[0])) {
+            value = edges[i];
+        } else if (i % 3 == 0) {
+            // 较短的十进制数，覆盖常见的「整齐」数值
+            value = (double) (int64_t) (test_rand() % 2000001 - 1000000) / (double) (1 + test_below(100000));
+        } else {
+            do value = double_of(test_rand()); while (!isfinite(value));
+        }
+
+        dstr_clear(dstr);
+        CHECK(dstr_cat_double(dstr, value));
+
+        // 由 strtod 读回与由 dstr_parse_double 读回都应精确还原
+        CHECK(bits_of(strtod(dstr_cstr(dstr), NULL)) == bits_of(value));
+        CHECK(dstr_parse_double(dstr, &parsed) && bits_of(parsed) == bits_of(value));
+
+        // 舍入区间边界上的值（如 1e23）不计入：Grisu2 在那里会输出完整的位数
+        if (i % 10 == 0 && i >= sizeof(edges) / sizeof(edges[0]) && value != 0.0) {
+            shortest = shortest_digits(value);
+            produced = significant_digits(dstr_cstr(dstr));
+            CHECK(produced >= shortest && produced <= shortest + 2);
+            longer += produced > shortest;
+        }
+    }
+    // Grisu2 只在极少数情况下多出位数
+    CHECK(longer < 300);
+
+    // 定点写法的范围为 1e-6 <= |value| < 1e21
+    dstr_clear(dstr);
+    CHECK(dstr_cat_double(dstr, 1e-6) && strcmp(dstr_cstr(dstr), "0.000001") == 0);
+    dstr_clear(dstr);
+    CHECK(dstr_cat_double(dstr, 1e-7) && strcmp(dstr_cstr(dstr), "1e-7") == 0);
+    dstr_clear(dstr);
+    CHECK(dstr_cat_double(dstr, 1e20) && strcmp(dstr_cstr(dstr), "100000000000000000000") == 0);
+    dstr_clear(dstr);
+    CHECK(dstr_cat_double(dstr, 1e21) && strcmp(dstr_cstr(dstr), "1e+21") == 0);
+    dstr_clear(dstr);
+    CHECK(dstr_cat_double(dstr, -0.0) && strcmp(dstr_cstr(dstr), "-0") == 0);
+    dstr_clear(dstr);
+    CHECK(dstr_cat_double(dstr, NAN) && strcmp(dstr_cstr(dstr), "nan") == 0);
+    dstr_clear(dstr);
+    CHECK(dstr_cat_double(dstr, -INFINITY) && strcmp(dstr_cstr(dstr), "-inf") == 0);
+
+    dstr_destroy(dstr);
+}
+
+static void test_double_parse(void) {
+    static const char *const valid[] = {"0", "-0", "+1", "1.", ".5", "1e5", "1E+5", "1e-5", "inf", "-Infinity",
+                                        "NaN", "2.2250738585072011e-308", "4.9406564584124654e-324",
+                                        "1.7976931348623157e308", "0.1000000000000000055511151231257827",
+                                        "9007199254740993", "1e-400"};
+    static const char *const invalid[] = {"", "-", ".", "e5", "1e", "1e+", "1.2.3", " 1", "1 ", "0x10", "infx",
+                                          "1e400", "-1e309", "1,5"};
+    char text[128];
+    double parsed, expected;
+    size_t len, digits, i;
+    bool ok;
+
+    for (i = 0; i < sizeof(valid) / sizeof(valid[0]); ++i) {
+        CHECK(dstr_parse_double_view(dstr_view_cstr(valid[i]), &parsed));
+        expected = strtod(valid[i], NULL);
+        CHECK(bits_of(parsed) == bits_of(expected) || (isnan(parsed) && isnan(expected)));
+    }
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        CHECK(!dstr_parse_double_view(dstr_view_cstr(invalid[i]), &parsed));
+    }
+
+    // 随机的十进制文本与 strtod（正确舍入）逐位比较，有效数字超过 19 位时走慢速路径
+    test_seed(7);
+    for (size_t n = 0; n < 300000; ++n) {
+        len = 0;
+        if (test_below(2)) text[len++] = '-';
+        digits = 1 + test_below(test_below(4) == 0 ? 40 : 19);
+        for (i = 0; i < digits; ++i) text[len++] = (char) ('0' + test_below(10));
+        if (test_below(2)) {
+            text[len++] = '.';
+            for (i = test_below(12); i > 0; --i) text[len++] = (char) ('0' + test_below(10));
+        }
+        if (test_below(3) != 0) {
+            len += (size_t) snprintf(text + len, sizeof(text) - len, "e%d", (int) test_below(700) - 350);
+        }
+        text[len] = '\0';
+
+        ok = dstr_parse_double_view((DStrView){text, len}, &parsed);
+        expected = strtod(text, NULL);
+        if (isinf(expected)) {
+            CHECK(!ok);
+        } else {
+            CHECK(ok && bits_of(parsed) == bits_of(expected));
+        }
+    }
+}
+
+int main(void) {
+    test_integers();
+    test_double_format();
+    test_double_parse();
+    return 0;
+}
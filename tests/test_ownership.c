@@ -0,0 +1,267 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <string.h>
+
+#define MODEL_MAX 4096
+
+// 接管缓冲：不复制内容，追加超出容量时经由同一分配器扩容，销毁时按最终容量归还
+static void check_adopt(void) {
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr;
+    char *buf;
+
+    allocator = test_stats_allocator(&stats);
+    buf = allocator.allocate(allocator.ctx, 16);
+    CHECK(buf != NULL);
+    memcpy(buf, "adopted", 7);
+
+    dstr = dstr_adopt_with_allocator(buf, 7, 16, &allocator);
+    CHECK(dstr != NULL && dstr_cstr(dstr) == buf && dstr_equals_cstr(dstr, "adopted"));
+    CHECK(dstr_capacity(dstr) == 16 && dstr_allocator(dstr) == &allocator);
+    for (int i = 0; i < 100; ++i) CHECK(dstr_cat_cstr(dstr, " and grown"));
+    CHECK(dstr_starts_with_cstr(dstr, "adopted and grown") && dstr_length(dstr) == 7 + 100 * 10);
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+
+    // 未指定分配器时使用全局默认分配器（默认即 malloc）；内容可含 '\0'，buf[len] 被写为 '\0'
+    buf = malloc(8);
+    CHECK(buf != NULL);
+    memcpy(buf, "a\0bXXXXX", 8);
+    dstr = dstr_adopt(buf, 3, 8);
+    CHECK(dstr != NULL && dstr_length(dstr) == 3 && buf[3] == '\0' && dstr_allocator(dstr) == &DSTR_ALLOCATOR_LIBC);
+    dstr_destroy(dstr);
+
+    // 创建失败时缓冲仍归调用者所有
+    buf = allocator.allocate(allocator.ctx, 32);
+    CHECK(buf != NULL);
+    stats.fail_after = 0;
+    CHECK(dstr_adopt_with_allocator(buf, 0, 32, &allocator) == NULL);
+    stats.fail_after = SIZE_MAX;
+    allocator.deallocate(allocator.ctx, buf, 32);
+    CHECK(stats.live == 0);
+}
+
+// 以各种方式得到的字符串：短字符串、独立堆缓冲、尾随存储、共享数据、接管的缓冲
+static DString *make_string(const int form, const char *model, const size_t len, const DStrAllocator *allocator,
+                            DString **clone) {
+    DString *dstr;
+    size_t cap;
+    char *buf;
+
+    *clone = NULL;
+    switch (form) {
+        case 0:
+            dstr = dstr_create_with_allocator("", allocator);
+            break;
+        case 1:
+            dstr = dstr_create_packed_with_allocator("", len + 1 + test_below(32), allocator);
+            break;
+        case 2:
+            cap = len + 1 + test_below(32);
+            buf = allocator->allocate(allocator->ctx, cap);
+            CHECK(buf != NULL);
+            dstr = dstr_adopt_with_allocator(buf, 0, cap, allocator);
+            break;
+        default:
+            dstr = dstr_create_with_allocator("", allocator);
+            CHECK(dstr != NULL);
+            (void) dstr_set_copy_on_write(dstr, true);
+            break;
+    }
+    CHECK(dstr != NULL);
+    CHECK(len == 0 || dstr_cat_n(dstr, model, len));
+    if (form == 3) {
+        *clone = dstr_clone(dstr);
+        CHECK(*clone != NULL);
+    }
+    return dstr;
+}
+
+// 取出的缓冲内容、长度与 '\0' 结尾正确，按返回的容量归还后没有遗留；
+// 独占的堆缓冲原样交出，其余情形复制出一份，共享数据的另一方不受影响
+static void check_release(void) {
+    static char model[MODEL_MAX];
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr, *clone;
+    const char *before;
+    size_t len, out_len, out_cap;
+    char *buf;
+    int form;
+
+    allocator = test_stats_allocator(&stats);
+    test_seed(23);
+    for (int step = 0; step < 20000; ++step) {
+        form = (int) test_below(4);
+        len = test_below(test_below(4) == 0 ? MODEL_MAX : 40);
+        test_fill(model, len, "r\0", 2);
+        dstr = make_string(form, model, len, &allocator, &clone);
+        before = dstr_cstr(dstr);
+
+        out_len = out_cap = SIZE_MAX;
+        buf = test_below(4) == 0 ? dstr_release(dstr, NULL, &out_cap) : dstr_release(dstr, &out_len, &out_cap);
+        CHECK(buf != NULL && out_cap > len && memcmp(buf, model, len) == 0 && buf[len] == '\0');
+        CHECK(out_len == len || out_len == SIZE_MAX);
+        // 接管的缓冲没有引用计数，内嵌缓冲放不下时仍是独占的同一块
+        if (form == 2 && len >= 3 * sizeof(size_t)) CHECK(buf == before);
+
+        if (clone != NULL) {
+            CHECK(dstr_length(clone) == len && memcmp(dstr_cstr(clone), model, len) == 0);
+            dstr_destroy(clone);
+        }
+        allocator.deallocate(allocator.ctx, buf, out_cap);
+        CHECK(stats.live == 0);
+    }
+
+    // 复制失败时返回 NULL，字符串保持不变
+    dstr = dstr_create_with_allocator("short", &allocator);
+    CHECK(dstr != NULL);
+    stats.fail_after = 0;
+    CHECK(dstr_release(dstr, &out_len, &out_cap) == NULL && dstr_equals_cstr(dstr, "short"));
+    stats.fail_after = SIZE_MAX;
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+// 接管后再取出得到同一个缓冲与容量；中间修改过的字符串按其最终的容量交出
+static void check_round_trip(void) {
+    size_t len, cap;
+    DString *dstr;
+    char *buf;
+
+    buf = malloc(64);
+    CHECK(buf != NULL);
+    strcpy(buf, "round trip");
+    dstr = dstr_adopt(buf, strlen(buf), 64);
+    CHECK(dstr != NULL);
+    CHECK(dstr_release(dstr, &len, &cap) == buf && len == 10 && cap == 64 && strcmp(buf, "round trip") == 0);
+
+    dstr = dstr_adopt(buf, len, cap);
+    CHECK(dstr != NULL);
+    for (int i = 0; i < 20; ++i) CHECK(dstr_cat_cstr(dstr, "!"));
+    buf = dstr_release(dstr, &len, &cap);
+    CHECK(buf != NULL && len == 30 && cap > len && strcmp(buf, "round trip!!!!!!!!!!!!!!!!!!!!") == 0);
+    free(buf);
+}
+
+// 栈上的存储：短字符串不申请内存，增长后经由分配器，fini 归还全部数据，之后存储可以重新初始化
+static void check_storage(void) {
+    static char model[MODEL_MAX];
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DStrStorage storage;
+    DString *dstr, *source;
+    size_t model_len, len;
+    char buf[64];
+
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_init_with_allocator(&storage, "on the stack", &allocator);
+    CHECK(dstr == (DString *) &storage && dstr_equals_cstr(dstr, "on the stack"));
+    CHECK(test_stats_calls(&stats) == 0 && dstr_allocator(dstr) == &allocator);
+    dstr_fini(dstr);
+
+    dstr = dstr_init_with_allocator(&storage, NULL, &allocator);
+    CHECK(dstr != NULL && dstr_length(dstr) == 0 && test_stats_calls(&stats) == 0);
+    model_len = 0;
+
+    test_seed(24);
+    for (int step = 0; step < 50000; ++step) {
+        switch (test_below(6)) {
+            case 0:
+            case 1:
+                len = 1 + test_below(test_below(4) == 0 ? sizeof(buf) : 8);
+                if (model_len + len >= MODEL_MAX) break;
+                test_fill(buf, len, "st", 2);
+                CHECK(dstr_cat_n(dstr, buf, len));
+                memcpy(model + model_len, buf, len);
+                model_len += len;
+                break;
+            case 2:
+                if (model_len == 0) break;
+                model_len = test_below(model_len);
+                dstr_remove(dstr, model_len, 0);
+                break;
+            case 3:
+                // 与共享数据的字符串互相复制，fini 只减少引用计数
+                source = dstr_clone(dstr);
+                CHECK(source != NULL && dstr_equals(source, dstr));
+                (void) dstr_set_copy_on_write(source, true);
+                CHECK(dstr_cat_cstr(source, "shared") && dstr_cpy(dstr, source));
+                memcpy(model + model_len, "shared", 6);
+                model_len += 6;
+                dstr_destroy(source);
+                break;
+            case 4:
+                // 清理后在同一存储上重新初始化
+                dstr_fini(dstr);
+                CHECK(stats.live == 0);
+                model_len = test_below(2) == 0 ? 0 : 5;
+                dstr = dstr_init_with_allocator(&storage, model_len == 0 ? "" : "fresh", &allocator);
+                CHECK(dstr == (DString *) &storage);
+                memcpy(model, "fresh", model_len);
+                break;
+            default:
+                CHECK(dstr_resize_capacity(dstr, model_len + 1 + test_below(256)));
+                break;
+        }
+        CHECK(dstr_length(dstr) == model_len && memcmp(dstr_cstr(dstr), model, model_len) == 0);
+        CHECK(dstr_cstr(dstr)[model_len] == '\0');
+        if (model_len >= MODEL_MAX / 2) {
+            dstr_fini(dstr);
+            dstr = dstr_init_with_allocator(&storage, "", &allocator);
+            model_len = 0;
+        }
+    }
+    dstr_fini(dstr);
+    CHECK(stats.live == 0);
+}
+
+// destroy 与 release 只释放数据而不释放存储；初始化失败时返回 NULL
+static void check_storage_exits(void) {
+    static const char long_text[] = "a piece of text long enough to need a heap buffer of its own";
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DStrStorage storage;
+    DString *dstr;
+    size_t len, cap;
+    char *buf;
+
+    allocator = test_stats_allocator(&stats);
+    dstr = dstr_init_with_allocator(&storage, long_text, &allocator);
+    CHECK(dstr != NULL && stats.live != 0);
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+
+    dstr = dstr_init_with_allocator(&storage, "short", &allocator);
+    CHECK(dstr != NULL);
+    buf = dstr_release(dstr, &len, &cap);
+    CHECK(buf != NULL && len == 5 && strcmp(buf, "short") == 0);
+    allocator.deallocate(allocator.ctx, buf, cap);
+
+    dstr = dstr_init(&storage, long_text);
+    CHECK(dstr != NULL && dstr_allocator(dstr) == dstr_default_allocator());
+    buf = dstr_release(dstr, &len, &cap);
+    CHECK(buf != NULL && len == sizeof(long_text) - 1 && strcmp(buf, long_text) == 0);
+    free(buf);
+
+    stats.fail_after = 0;
+    CHECK(dstr_init_with_allocator(&storage, long_text, &allocator) == NULL);
+    CHECK(dstr_init_with_allocator(&storage, "fits inline", &allocator) == (DString *) &storage);
+    stats.fail_after = SIZE_MAX;
+    dstr_fini((DString *) &storage);
+    CHECK(stats.live == 0);
+}
+
+int main(void) {
+    check_adopt();
+    check_release();
+    check_round_trip();
+    check_storage();
+    check_storage_exits();
+    return 0;
+}
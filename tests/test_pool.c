@@ -0,0 +1,196 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <string.h>
+
+#define THREAD_COUNT 8
+#define STRINGS_PER_THREAD 2000
+
+// 直接经由分配器接口：各级大小的申请、改写、调整与释放，空闲块按后进先出复用
+static void check_blocks(void) {
+    const DStrAllocator *pool = &DSTR_ALLOCATOR_POOL;
+    unsigned char *blocks[512], *again, *block;
+    size_t sizes[512], size, i, j;
+
+    test_seed(5);
+    for (int round = 0; round < 20; ++round) {
+        for (i = 0; i < 512; ++i) {
+            sizes[i] = 1 + test_below(test_below(8) == 0 ? 1024 : 256);
+            blocks[i] = pool->allocate(pool->ctx, sizes[i]);
+            CHECK(blocks[i] != NULL);
+            memset(blocks[i], (int) (i & 0xff), sizes[i]);
+        }
+        for (i = 0; i < 512; ++i) {
+            // 调整大小后原内容保留
+            size = 1 + test_below(512);
+            blocks[i] = pool->reallocate(pool->ctx, blocks[i], sizes[i], size);
+            CHECK(blocks[i] != NULL);
+            for (j = 0; j < (size < sizes[i] ? size : sizes[i]); ++j) CHECK(blocks[i][j] == (i & 0xff));
+            memset(blocks[i], (int) (i & 0xff), size);
+            sizes[i] = size;
+        }
+        // 按随机顺序释放
+        for (i = 0; i < 512; ++i) {
+            j = i + test_below(512 - i);
+            block = blocks[j];
+            size = sizes[j];
+            blocks[j] = blocks[i];
+            sizes[j] = sizes[i];
+            for (size_t k = 0; k < size; ++k) CHECK(block[k] == block[0]);
+            pool->deallocate(pool->ctx, block, size);
+        }
+    }
+
+    // 刚释放的块被同一级的下一次申请取回
+    for (size = 1; size <= 256; size += 7) {
+        blocks[0] = pool->allocate(pool->ctx, size);
+        pool->deallocate(pool->ctx, blocks[0], size);
+        again = pool->allocate(pool->ctx, size);
+        CHECK(again == blocks[0]);
+        pool->deallocate(pool->ctx, again, size);
+    }
+}
+
+// 以内存池为默认分配器的字符串，按参照模型随机改写
+static void check_strings(void) {
+    char models[64][128], buf[64];
+    size_t lens[64], slot, len;
+    DString *dstrs[64];
+
+    dstr_set_default_allocator(&DSTR_ALLOCATOR_POOL);
+    for (slot = 0; slot < 64; ++slot) {
+        dstrs[slot] = dstr_create("");
+        CHECK(dstrs[slot] != NULL && dstr_allocator(dstrs[slot]) == &DSTR_ALLOCATOR_POOL);
+        lens[slot] = 0;
+    }
+    dstr_set_default_allocator(NULL);
+
+    test_seed(55);
+    for (int step = 0; step < 100000; ++step) {
+        slot = test_below(64);
+        len = 1 + test_below(sizeof(buf));
+        if (lens[slot] + len < sizeof(models[slot]) && test_below(3) != 0) {
+            test_fill(buf, len, "pool", 4);
+            CHECK(dstr_cat_n(dstrs[slot], buf, len));
+            memcpy(models[slot] + lens[slot], buf, len);
+            lens[slot] += len;
+        } else if (test_below(2) == 0) {
+            dstr_destroy(dstrs[slot]);
+            dstrs[slot] = dstr_create_with_allocator("", &DSTR_ALLOCATOR_POOL);
+            CHECK(dstrs[slot] != NULL);
+            lens[slot] = 0;
+        } else if (lens[slot] != 0) {
+            lens[slot] = test_below(lens[slot]);
+            dstr_remove(dstrs[slot], lens[slot], 0);
+        }
+        CHECK(dstr_length(dstrs[slot]) == lens[slot] && memcmp(dstr_cstr(dstrs[slot]), models[slot], lens[slot]) == 0);
+    }
+
+    for (slot = 0; slot < 64; ++slot) dstr_destroy(dstrs[slot]);
+}
+
+// 多线程：每个线程创建一批字符串，再由另一个线程校验并销毁
+typedef struct PoolWorker {
+    size_t index;
+    DString *strings[STRINGS_PER_THREAD];
+    struct PoolWorker *peer; // 由本线程销毁其字符串的线程
+} PoolWorker;
+
+static void fill_expected(char *out, const size_t owner, const size_t i) {
+    snprintf(out, 64, "thread %zu string %zu %.*s", owner, i, (int) (i % 40), "........................................");
+}
+
+static void worker_create(void *arg) {
+    PoolWorker *worker = arg;
+    char expected[64];
+
+    for (size_t i = 0; i < STRINGS_PER_THREAD; ++i) {
+        fill_expected(expected, worker->index, i);
+        worker->strings[i] = dstr_create_with_allocator(expected, &DSTR_ALLOCATOR_POOL);
+        CHECK(worker->strings[i] != NULL);
+        // 顺带在本线程内反复申请、释放，使本地缓存溢出到仓库
+        if (i % 3 == 0) dstr_destroy(dstr_clone(worker->strings[i]));
+    }
+}
+
+static void worker_destroy(void *arg) {
+    PoolWorker *worker = arg, *peer = worker->peer;
+    char expected[64];
+    DString *dstr;
+
+    for (size_t i = 0; i < STRINGS_PER_THREAD; ++i) {
+        fill_expected(expected, peer->index, i);
+        CHECK(dstr_equals_cstr(peer->strings[i], expected));
+        dstr_destroy(peer->strings[i]);
+        peer->strings[i] = NULL;
+
+        // 从仓库取回其他线程归还的块
+        dstr = dstr_create_with_allocator(expected, &DSTR_ALLOCATOR_POOL);
+        CHECK(dstr != NULL && dstr_equals_cstr(dstr, expected));
+        dstr_destroy(dstr);
+    }
+}
+
+static void check_threads(void) {
+    static PoolWorker workers[THREAD_COUNT];
+    void *args[THREAD_COUNT];
+
+    for (size_t round = 0; round < 4; ++round) {
+        for (size_t i = 0; i < THREAD_COUNT; ++i) {
+            workers[i].index = i;
+            workers[i].peer = &workers[(i + 1 + round) % THREAD_COUNT];
+            args[i] = &workers[i];
+        }
+        test_run_threads(worker_create, args, THREAD_COUNT);
+        test_run_threads(worker_destroy, args, THREAD_COUNT);
+    }
+}
+
+#if defined(TEST_THREADS_POSIX)
+// 线程退出时其他线程本地存储的析构函数可能在内存池归还缓存之后才释放字符串，
+// 此时块应直接进入仓库，而不是留在已归还的缓存里泄漏（由 AddressSanitizer 的泄漏检查发现）
+static pthread_key_t late_key;
+
+static void late_destructor(void *value) {
+    DString *dstr = value;
+
+    // 第一轮只重新登记，使释放推迟到内存池的析构函数之后的下一轮
+    if (dstr_length(dstr) != 0) {
+        dstr_clear(dstr);
+        CHECK(pthread_setspecific(late_key, dstr) == 0);
+        return;
+    }
+    dstr_destroy(dstr);
+}
+
+static void late_free_worker(void *arg) {
+    DString *dstr;
+
+    (void) arg;
+    dstr = dstr_create_with_allocator("freed by a late thread-exit destructor", &DSTR_ALLOCATOR_POOL);
+    CHECK(dstr != NULL);
+    CHECK(pthread_setspecific(late_key, dstr) == 0);
+}
+
+static void check_late_free(void) {
+    void *args[THREAD_COUNT] = {0};
+
+    CHECK(pthread_key_create(&late_key, late_destructor) == 0);
+    test_run_threads(late_free_worker, args, THREAD_COUNT);
+    CHECK(pthread_key_delete(late_key) == 0);
+}
+#endif
+
+int main(void) {
+    check_blocks();
+    check_strings();
+    check_threads();
+#if defined(TEST_THREADS_POSIX)
+    check_late_free();
+#endif
+    dstr_pool_trim();
+    return 0;
+}
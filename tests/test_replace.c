@@ -0,0 +1,279 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <string.h>
+
+#define NPOS SIZE_MAX
+#define TEXT_MAX (1 << 20)
+
+static size_t naive_first(const char *hay, const size_t hay_len, const char *needle, const size_t needle_len) {
+    if (needle_len == 0 || needle_len > hay_len) return NPOS;
+    for (size_t i = 0; i + needle_len <= hay_len; ++i) {
+        if (memcmp(hay + i, needle, needle_len) == 0) return i;
+    }
+    return NPOS;
+}
+
+static size_t naive_last(const char *hay, const size_t hay_len, const char *needle, const size_t needle_len) {
+    if (needle_len == 0 || needle_len > hay_len) return NPOS;
+    for (size_t i = hay_len - needle_len + 1; i > 0; --i) {
+        if (memcmp(hay + i - 1, needle, needle_len) == 0) return i - 1;
+    }
+    return NPOS;
+}
+
+// 参照模型：逐次查找并替换至多 n 处（0 表示全部）不重叠的匹配，逆向时从末尾开始，返回替换的次数
+static size_t naive_replace(char *text, size_t *text_len, const char *old, const size_t old_len, const char *new,
+                            const size_t new_len, const size_t n, const bool backward) {
+    static char scratch[2 * TEXT_MAX];
+    size_t count, pos, bound;
+
+    for (count = 0, bound = backward ? *text_len : 0; n == 0 || count < n; ++count) {
+        if (backward) {
+            pos = naive_last(text, bound, old, old_len);
+        } else {
+            pos = naive_first(text + bound, *text_len - bound, old, old_len);
+            if (pos != NPOS) pos += bound;
+        }
+        if (pos == NPOS) break;
+
+        memcpy(scratch, text + pos + old_len, *text_len - pos - old_len);
+        memcpy(text + pos, new, new_len);
+        memcpy(text + pos + new_len, scratch, *text_len - pos - old_len);
+        *text_len = *text_len - old_len + new_len;
+        bound = backward ? pos : pos + new_len;
+    }
+    return count;
+}
+
+// 随机替换：结果或长或短或等长，两个方向、部分与全部替换，覆盖原地与另起缓冲的各条路径
+static void check_random(void) {
+    static char model[2 * TEXT_MAX];
+    char old[16], new[32], text[512];
+    DString *dstr, *old_dstr, *new_dstr;
+    size_t model_len, old_len, new_len, n, expected;
+    bool backward;
+
+    test_seed(9);
+    for (int step = 0; step < 20000; ++step) {
+        model_len = test_below(test_below(8) == 0 ? sizeof(text) : 64);
+        test_fill(text, model_len, "ab\0", 3);
+        memcpy(model, text, model_len);
+        dstr = dstr_create_n(text, model_len);
+        CHECK(dstr != NULL);
+
+        for (int round = 0; round < 4 && model_len * sizeof(new) < TEXT_MAX; ++round) {
+            old_len = 1 + test_below(sizeof(old) - 1);
+            if (old_len <= model_len && test_below(2) == 0) {
+                memcpy(old, model + test_below(model_len - old_len + 1), old_len);
+            } else {
+                old_len = 1 + test_below(3);
+                test_fill(old, old_len, "ab\0", 3);
+            }
+            new_len = test_below(sizeof(new));
+            test_fill(new, new_len, "abc", 3);
+            n = test_below(4);
+            backward = test_below(2) == 0;
+
+            expected = naive_replace(model, &model_len, old, old_len, new, new_len, n, backward);
+            old_dstr = dstr_create_n(old, old_len);
+            new_dstr = dstr_create_n(new, new_len);
+            CHECK(old_dstr != NULL && new_dstr != NULL);
+            CHECK(dstr_replace(dstr, old_dstr, new_dstr, n, backward) == expected);
+            CHECK(dstr_length(dstr) == model_len && memcmp(dstr_cstr(dstr), model, model_len) == 0);
+            CHECK(dstr_cstr(dstr)[model_len] == '\0');
+            dstr_destroy(old_dstr);
+            dstr_destroy(new_dstr);
+        }
+        dstr_destroy(dstr);
+    }
+}
+
+// old 或 new 取自字符串自身的内容
+static void check_aliasing(void) {
+    DString *dstr, *copy;
+
+    dstr = dstr_create("abcabcabc");
+    CHECK(dstr != NULL);
+    CHECK(dstr_replace(dstr, dstr, dstr, 0, false) == 1 && dstr_equals_cstr(dstr, "abcabcabc"));
+
+    // new 为自身：每处 "b" 替换为替换前的整个内容
+    copy = dstr_create("b");
+    CHECK(copy != NULL);
+    CHECK(dstr_replace(dstr, copy, dstr, 0, true) == 3);
+    CHECK(dstr_equals_cstr(dstr, "aabcabcabccaabcabcabccaabcabcabcc"));
+    dstr_destroy(copy);
+
+    // old 与 new 都是自身缓冲内的 C 字符串（分别为末尾的 "xy" 与 "-xy"）
+    CHECK(dstr_cpy_cstr(dstr, "xy-xy-xy"));
+    CHECK(dstr_replace_cstr(dstr, dstr_cstr(dstr) + 6, dstr_cstr(dstr) + 5, 2, false) == 2);
+    CHECK(dstr_equals_cstr(dstr, "-xy--xy-xy"));
+    dstr_destroy(dstr);
+}
+
+// 大量匹配：逐次原地替换为平方时间，此处的规模会使测试明显变慢
+static void check_large(void) {
+    DString *dstr;
+    size_t len;
+
+    dstr = dstr_create("");
+    CHECK(dstr != NULL);
+    for (len = 0; len < TEXT_MAX / 2; len += 4) CHECK(dstr_cat_cstr(dstr, "abca"));
+
+    CHECK(dstr_replace_cstr(dstr, "a", "<a>", 0, false) == len / 2);
+    CHECK(dstr_length(dstr) == 2 * len && dstr_starts_with_cstr(dstr, "<a>bc<a><a>bc"));
+    CHECK(dstr_replace_cstr(dstr, "<a>", "a", 0, true) == len / 2);
+    CHECK(dstr_length(dstr) == len && dstr_starts_with_cstr(dstr, "abcaabca"));
+    CHECK(dstr_replace_cstr(dstr, "bc", "", 0, true) == len / 4);
+    CHECK(dstr_length(dstr) == len / 2 && dstr_ends_with_cstr(dstr, "aaaa"));
+    CHECK(dstr_replace_cstr(dstr, "a", "xyz", 0, true) == len / 2);
+    CHECK(dstr_length(dstr) == 3 * len / 2 && dstr_count_cstr(dstr, "xyz") == len / 2);
+    dstr_destroy(dstr);
+}
+
+// 需要新缓冲而分配失败时不替换，字符串保持不变
+static void check_failure(void) {
+    TestAllocStats stats;
+    DStrAllocator allocator;
+    DString *dstr;
+    char text[200];
+
+    allocator = test_stats_allocator(&stats);
+    memset(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    dstr = dstr_create_with_allocator(text, &allocator);
+    CHECK(dstr != NULL);
+
+    stats.fail_after = 0;
+    CHECK(dstr_replace_cstr(dstr, "a", "bb", 0, false) == 0 && dstr_equals_cstr(dstr, text));
+    CHECK(dstr_replace_cstr(dstr, "a", "bb", 0, true) == 0 && dstr_equals_cstr(dstr, text));
+    CHECK(dstr_replace_cstr(dstr, "aa", "b", 0, true) == 0 && dstr_equals_cstr(dstr, text));
+    CHECK(dstr_replace_many(dstr, (DStrReplacePair[]){{"aa", "b"}, {"a", "cc"}}, 2) == 0);
+    CHECK(dstr_equals_cstr(dstr, text));
+    stats.fail_after = SIZE_MAX;
+
+    dstr_destroy(dstr);
+    CHECK(stats.live == 0);
+}
+
+// 参照模型：逐个位置取在此开始的最长 old（等长时取靠前的一组），替换后从匹配之后继续
+static size_t naive_replace_many(const char *text, const size_t text_len, const DStrReplacePair *pairs,
+                                 const size_t *old_lens, const size_t count, char *out, size_t *out_len) {
+    size_t replaced, written, best, i, k;
+
+    for (replaced = written = i = 0; i < text_len;) {
+        best = count;
+        for (k = 0; k < count; ++k) {
+            if (old_lens[k] != 0 && old_lens[k] <= text_len - i && memcmp(text + i, pairs[k].old, old_lens[k]) == 0 &&
+                (best == count || old_lens[k] > old_lens[best])) {
+                best = k;
+            }
+        }
+        if (best == count) {
+            out[written++] = text[i++];
+            continue;
+        }
+        memcpy(out + written, pairs[best].new, strlen(pairs[best].new));
+        written += strlen(pairs[best].new);
+        i += old_lens[best];
+        ++replaced;
+    }
+    *out_len = written;
+    return replaced;
+}
+
+// 随机的替换组：互为前后缀、重复与空的 old，结果与参照模型一致，预先构造的替换组与直接调用结果相同
+static void check_many(void) {
+    static char olds[16][8], news[16][8], text[600], expected[600 * 8];
+    DStrReplacePair pairs[16];
+    size_t old_lens[16], count, text_len, expected_len, replaced, k;
+    DStrReplaceSet *set;
+    DString *dstr, *again;
+
+    test_seed(10);
+    for (int step = 0; step < 10000; ++step) {
+        count = test_below(test_below(4) == 0 ? 16 : 5);
+        text_len = test_below(test_below(8) == 0 ? sizeof(text) - 1 : 40);
+        test_fill(text, text_len, "abc", 3);
+        text[text_len] = '\0';
+
+        for (k = 0; k < count; ++k) {
+            if (k != 0 && test_below(6) == 0) {
+                // 与前面的某组相同，或是它的前缀
+                old_lens[k] = test_below(2) == 0 ? old_lens[k - 1] : test_below(old_lens[k - 1] + 1);
+                memcpy(olds[k], olds[k - 1], old_lens[k]);
+            } else {
+                old_lens[k] = test_below(test_below(4) == 0 ? sizeof(olds[k]) : 4);
+                test_fill(olds[k], old_lens[k], "abc", 3);
+            }
+            olds[k][old_lens[k]] = '\0';
+            test_fill(news[k], test_below(sizeof(news[k])), "XYZ", 3);
+            news[k][test_below(sizeof(news[k]))] = '\0';
+            pairs[k] = (DStrReplacePair){olds[k], news[k]};
+        }
+
+        replaced = naive_replace_many(text, text_len, pairs, old_lens, count, expected, &expected_len);
+        dstr = dstr_create(text);
+        again = dstr_create(text);
+        CHECK(dstr != NULL && again != NULL);
+
+        CHECK(dstr_replace_many(dstr, pairs, count) == replaced);
+        CHECK(dstr_length(dstr) == expected_len && memcmp(dstr_cstr(dstr), expected, expected_len) == 0);
+
+        // 替换组保存副本，构造后改写 pairs 不影响结果
+        set = dstr_replace_set_create(pairs, count);
+        CHECK(set != NULL);
+        for (k = 0; k < count; ++k) olds[k][0] = news[k][0] = 'Q';
+        CHECK(dstr_replace_many_set(again, set) == replaced && dstr_equals(again, dstr));
+        dstr_replace_set_destroy(set);
+
+        dstr_destroy(dstr);
+        dstr_destroy(again);
+    }
+}
+
+// 一组 old 互为前缀时仍为线性：逐位置取最长匹配的做法在此要 O(n·max_len)
+static void check_many_large(void) {
+    static char longest[1001];
+    DStrReplacePair pairs[2];
+    DStrReplaceSet *set;
+    DString *dstr, *copy;
+    size_t len;
+
+    memset(longest, 'a', sizeof(longest) - 2);
+    longest[sizeof(longest) - 2] = 'b';
+    pairs[0] = (DStrReplacePair){"a", "b"};
+    pairs[1] = (DStrReplacePair){longest, "!"};
+
+    dstr = dstr_create("aaaaaaaaaaaaaaaa");
+    CHECK(dstr != NULL);
+    while (dstr_length(dstr) < TEXT_MAX) CHECK(dstr_cat(dstr, dstr));
+    CHECK(dstr_cat_cstr(dstr, longest));
+    len = dstr_length(dstr);
+    copy = dstr_clone(dstr);
+    CHECK(copy != NULL);
+
+    // 只有末尾一处完整匹配长模式，其余每个 'a' 单独替换
+    CHECK(dstr_replace_many(dstr, pairs, 2) == len - 1000 + 1);
+    CHECK(dstr_length(dstr) == len - 999 && dstr_ends_with_cstr(dstr, "bbb!"));
+
+    set = dstr_replace_set_create(pairs, 2);
+    CHECK(set != NULL);
+    CHECK(dstr_replace_many_set(copy, set) == len - 1000 + 1 && dstr_equals(copy, dstr));
+    dstr_replace_set_destroy(set);
+    dstr_destroy(copy);
+    dstr_destroy(dstr);
+}
+
+int main(void) {
+    check_random();
+    check_aliasing();
+    check_large();
+    check_failure();
+    check_many();
+    check_many_large();
+    return 0;
+}
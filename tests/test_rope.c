@@ -0,0 +1,140 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dstr_rope.h"
+#include "test_util.h"
+#include <string.h>
+#include <time.h>
+
+#define MODEL_MAX (64 * 1024)
+
+// 以扁平缓冲为参照模型
+static char model[MODEL_MAX];
+static size_t model_len;
+
+static void check_model(const DStrRope *rope) {
+    DStrRopeIter iter;
+    DStrView chunk;
+    DString *flat;
+    size_t pos;
+
+    CHECK(dstr_rope_length(rope) == model_len);
+    CHECK(dstr_rope_equals(rope, (DStrView){model, model_len}));
+
+    for (pos = 0, dstr_rope_iter_init(&iter, rope, 0); dstr_rope_iter_next(&iter, &chunk); pos += chunk.len) {
+        CHECK(chunk.len != 0 && pos + chunk.len <= model_len && memcmp(chunk.data, model + pos, chunk.len) == 0);
+    }
+    CHECK(pos == model_len);
+
+    flat = dstr_rope_to_dstr(rope);
+    CHECK(flat != NULL && dstr_length(flat) == model_len && memcmp(dstr_cstr(flat), model, model_len) == 0);
+    dstr_destroy(flat);
+}
+
+static void test_model(void) {
+    DStrRope *rope, *tail;
+    DString *sub;
+    char buf[3000];
+    size_t index, count, len, found, expected, i;
+    int op;
+
+    test_seed(13);
+    rope = dstr_rope_create();
+    CHECK(rope != NULL);
+
+    for (int step = 0; step < 20000; ++step) {
+        op = (int) test_below(7);
+        if (op <= 1 && model_len + sizeof(buf) < MODEL_MAX) {
+            len = 1 + test_below(test_below(4) == 0 ? sizeof(buf) : 16);
+            test_fill(buf, len, "abc", 3);
+            index = test_below(model_len + 1);
+            CHECK(dstr_rope_insert(rope, index, (DStrView){buf, len}));
+            memmove(model + index + len, model + index, model_len - index);
+            memcpy(model + index, buf, len);
+            model_len += len;
+        } else if (op == 2 && model_len != 0) {
+            index = test_below(model_len);
+            count = 1 + test_below(model_len - index < 2000 ? model_len - index : 2000);
+            CHECK(dstr_rope_remove(rope, index, count));
+            memmove(model + index, model + index + count, model_len - index - count);
+            model_len -= count;
+        } else if (op == 3) {
+            // 拆分后再拼回，内容应保持不变
+            index = test_below(model_len + 1);
+            tail = dstr_rope_split(rope, index);
+            CHECK(tail != NULL && dstr_rope_length(rope) == index);
+            dstr_rope_concat(rope, tail);
+            CHECK(dstr_rope_length(tail) == 0);
+            dstr_rope_destroy(tail);
+        } else if (op == 4 && model_len != 0) {
+            index = test_below(model_len);
+            CHECK(dstr_rope_at(rope, index) == model[index]);
+            count = test_below(model_len - index + 1);
+            sub = dstr_rope_sub(rope, index, count);
+            expected = count != 0 ? count : model_len - index;
+            CHECK(sub != NULL && dstr_length(sub) == expected && memcmp(dstr_cstr(sub), model + index, expected) == 0);
+            dstr_destroy(sub);
+        } else if (op == 5) {
+            len = 1 + test_below(6);
+            test_fill(buf, len, "abc", 3);
+            index = test_below(model_len + 1);
+            expected = SIZE_MAX;
+            for (i = index; i + len <= model_len; ++i) {
+                if (memcmp(model + i, buf, len) == 0) {
+                    expected = i;
+                    break;
+                }
+            }
+            if (dstr_rope_find(rope, (DStrView){buf, len}, index, &found)) {
+                CHECK(found == expected);
+            } else {
+                CHECK(expected == SIZE_MAX);
+            }
+        }
+
+        if (step % 500 == 0) check_model(rope);
+    }
+    check_model(rope);
+    dstr_rope_destroy(rope);
+}
+
+// 反复拼接单块绳索后，树的深度应保持对数级：访问与拼接都不能退化为线性
+static void test_concat_balance(void) {
+    enum { PIECES = 20000, PIECE_LEN = 1000, PROBES = 200000 };
+    DStrRope *rope, *piece;
+    char buf[PIECE_LEN];
+    clock_t start;
+    double seconds;
+    size_t index;
+
+    start = clock();
+    rope = dstr_rope_create();
+    CHECK(rope != NULL);
+    for (size_t i = 0; i < PIECES; ++i) {
+        memset(buf, 'a' + (int) (i % 26), sizeof(buf));
+        piece = dstr_rope_create_from((DStrView){buf, sizeof(buf)});
+        CHECK(piece != NULL);
+        dstr_rope_concat(rope, piece);
+        dstr_rope_destroy(piece);
+    }
+    CHECK(dstr_rope_length(rope) == (size_t) PIECES * PIECE_LEN);
+
+    test_seed(29);
+    for (size_t i = 0; i < PROBES; ++i) {
+        index = test_below(dstr_rope_length(rope));
+        CHECK(dstr_rope_at(rope, index) == 'a' + (int) (index / PIECE_LEN % 26));
+    }
+    seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    dstr_rope_destroy(rope);
+
+    // 平衡时不到 0.1 秒；退化为链表时需要数十秒（且可能因递归过深而崩溃）
+    if (seconds > 5.0) fprintf(stderr, "concat + access took %.2f s\n", seconds);
+    CHECK(seconds <= 5.0);
+}
+
+int main(void) {
+    test_model();
+    test_concat_balance();
+    return 0;
+}
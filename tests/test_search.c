@@ -0,0 +1,299 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <string.h>
+
+#define NPOS SIZE_MAX
+#define HAY_MAX (1 << 20)
+
+// 参照模型：逐个位置比较
+static size_t naive_first(const char *hay, const size_t hay_len, const char *needle, const size_t needle_len) {
+    if (needle_len == 0 || needle_len > hay_len) return NPOS;
+    for (size_t i = 0; i + needle_len <= hay_len; ++i) {
+        if (memcmp(hay + i, needle, needle_len) == 0) return i;
+    }
+    return NPOS;
+}
+
+static size_t naive_last(const char *hay, const size_t hay_len, const char *needle, const size_t needle_len) {
+    if (needle_len == 0 || needle_len > hay_len) return NPOS;
+    for (size_t i = hay_len - needle_len + 1; i > 0; --i) {
+        if (memcmp(hay + i - 1, needle, needle_len) == 0) return i - 1;
+    }
+    return NPOS;
+}
+
+// 第 n 次不重叠出现的位置，逆向时从末尾开始计数；n 为 0 时返回不重叠出现的次数
+static size_t naive_nth(const char *hay, const size_t hay_len, const char *needle, const size_t needle_len,
+                        const size_t n, const bool backward) {
+    size_t count, bound, pos;
+
+    count = 0;
+    if (backward) {
+        for (bound = hay_len; (pos = naive_last(hay, bound, needle, needle_len)) != NPOS; bound = pos) {
+            if (++count == n) return pos;
+        }
+    } else {
+        for (bound = 0; (pos = naive_first(hay + bound, hay_len - bound, needle, needle_len)) != NPOS;) {
+            if (++count == n) return bound + pos;
+            bound += pos + needle_len;
+        }
+    }
+    return n == 0 ? count : NPOS;
+}
+
+// 以 hay 为内容，比较各查找接口与参照模型
+static void check_all(const char *hay, const size_t hay_len, const char *needle, const size_t needle_len) {
+    DStrView view, sub;
+    DString *dstr, *sub_dstr;
+    size_t found, expected, count, n;
+
+    view = (DStrView){hay, hay_len};
+    sub = (DStrView){needle, needle_len};
+
+    expected = naive_first(hay, hay_len, needle, needle_len);
+    CHECK(dstr_view_find(view, sub, &found, false) == (expected != NPOS));
+    if (expected != NPOS) CHECK(found == expected);
+
+    expected = naive_last(hay, hay_len, needle, needle_len);
+    CHECK(dstr_view_find(view, sub, &found, true) == (expected != NPOS));
+    if (expected != NPOS) CHECK(found == expected);
+
+    dstr = dstr_create_n(hay, hay_len);
+    sub_dstr = dstr_create_n(needle, needle_len);
+    CHECK(dstr != NULL && sub_dstr != NULL);
+
+    CHECK(dstr_find_view(dstr, sub, &found, true) == (expected != NPOS));
+    if (expected != NPOS) CHECK(found == expected);
+    CHECK(dstr_contains_view(dstr, sub) == (expected != NPOS));
+
+    count = naive_nth(hay, hay_len, needle, needle_len, 0, false);
+    CHECK(dstr_count_view(dstr, sub) == count && dstr_count(dstr, sub_dstr) == count);
+
+    for (int round = 0; round < 2; ++round) {
+        n = 1 + test_below(count + 2);
+        for (int backward = 0; backward < 2; ++backward) {
+            expected = naive_nth(hay, hay_len, needle, needle_len, n, backward);
+            CHECK(dstr_find_nth(dstr, sub_dstr, &found, n, backward) == (expected != NPOS));
+            if (expected != NPOS) CHECK(found == expected);
+        }
+    }
+
+    dstr_destroy(dstr);
+    dstr_destroy(sub_dstr);
+}
+
+// 随机内容：小字母表（含 '\0'）便于产生匹配，起始地址随机以覆盖各种对齐与块尾
+static void check_random(void) {
+    static const char *const alphabets[] = {"ab", "ab\0", "abcdefghijklmnopqrstuvwxyz"};
+    static const size_t alphabet_lens[] = {2, 3, 26};
+    static char hay[4096 + 64];
+    char needle[300];
+    size_t alphabet, hay_len, needle_len, offset, start;
+
+    test_seed(6);
+    for (int step = 0; step < 20000; ++step) {
+        alphabet = test_below(3);
+        hay_len = test_below(8) == 0 ? test_below(4096) : test_below(200);
+        offset = test_below(64);
+        test_fill(hay + offset, hay_len, alphabets[alphabet], alphabet_lens[alphabet]);
+
+        needle_len = 1 + test_below(test_below(4) == 0 ? sizeof(needle) : 12);
+        if (needle_len <= hay_len && test_below(3) != 0) {
+            // 取自内容本身，保证至少出现一次，偶尔改动一个字节造成近似匹配
+            start = test_below(hay_len - needle_len + 1);
+            memcpy(needle, hay + offset + start, needle_len);
+            if (test_below(4) == 0) needle[test_below(needle_len)] ^= 1;
+        } else {
+            test_fill(needle, needle_len, alphabets[alphabet], alphabet_lens[alphabet]);
+        }
+        check_all(hay + offset, hay_len, needle, needle_len);
+    }
+}
+
+// 由模式的近似副本拼成的内容：首尾字节总是吻合而中间失配，迫使过滤退回到 Two-Way
+static void check_near_misses(void) {
+    static char hay[HAY_MAX];
+    char needle[600];
+    size_t needle_len, hay_len, pos, expected;
+
+    test_seed(66);
+    for (int step = 0; step < 60; ++step) {
+        needle_len = 2 + test_below(step % 2 == 0 ? 64 : sizeof(needle) - 2);
+        test_fill(needle, needle_len, "ab", 2);
+
+        hay_len = 0;
+        while (hay_len + needle_len <= 64 * 1024) {
+            memcpy(hay + hay_len, needle, needle_len);
+            if (needle_len > 2) hay[hay_len + 1 + test_below(needle_len - 2)] ^= 0x40;
+            hay_len += needle_len;
+        }
+        check_all(hay, hay_len, needle, needle_len);
+
+        // 在随机位置放入一份完整副本
+        pos = test_below(hay_len - needle_len + 1);
+        memcpy(hay + pos, needle, needle_len);
+        expected = naive_first(hay, hay_len, needle, needle_len);
+        CHECK(expected != NPOS && expected <= pos);
+        check_all(hay, hay_len, needle, needle_len);
+    }
+}
+
+// 经典的最坏情况：长串 'a' 中查找 "a…ab" 与 "ba…a"，逐位置比较为平方时间
+static void check_worst_case(void) {
+    static char hay[HAY_MAX];
+    char needle[4096];
+    size_t found;
+
+    memset(hay, 'a', HAY_MAX);
+    memset(needle, 'a', sizeof(needle));
+    needle[sizeof(needle) - 1] = 'b';
+
+    CHECK(!dstr_view_find((DStrView){hay, HAY_MAX}, (DStrView){needle, sizeof(needle)}, &found, false));
+    hay[HAY_MAX - 1] = 'b';
+    CHECK(dstr_view_find((DStrView){hay, HAY_MAX}, (DStrView){needle, sizeof(needle)}, &found, false));
+    CHECK(found == HAY_MAX - sizeof(needle));
+    hay[HAY_MAX - 1] = 'a';
+
+    needle[sizeof(needle) - 1] = 'a';
+    needle[0] = 'b';
+    CHECK(!dstr_view_find((DStrView){hay, HAY_MAX}, (DStrView){needle, sizeof(needle)}, &found, true));
+    hay[0] = 'b';
+    CHECK(dstr_view_find((DStrView){hay, HAY_MAX}, (DStrView){needle, sizeof(needle)}, &found, true));
+    CHECK(found == 0);
+}
+
+// 以参照模型替换至多 n 处（0 表示全部）不重叠的匹配，结果写入 out，返回替换的次数
+static size_t naive_replace(const char *hay, const size_t hay_len, const char *needle, const size_t needle_len,
+                            const DStrView new, const size_t n, const bool backward, char *out, size_t *out_len) {
+    static size_t starts[HAY_MAX];
+    size_t count, bound, pos, read, written;
+
+    count = 0;
+    if (backward) {
+        // 从末尾向前收集，再反转为升序
+        for (bound = hay_len; (n == 0 || count < n) && (pos = naive_last(hay, bound, needle, needle_len)) != NPOS;
+             bound = pos) {
+            starts[count++] = pos;
+        }
+        for (size_t i = 0; i < count / 2; ++i) {
+            pos = starts[i];
+            starts[i] = starts[count - 1 - i];
+            starts[count - 1 - i] = pos;
+        }
+    } else {
+        for (bound = 0; (n == 0 || count < n) &&
+                        (pos = naive_first(hay + bound, hay_len - bound, needle, needle_len)) != NPOS;) {
+            starts[count++] = bound + pos;
+            bound += pos + needle_len;
+        }
+    }
+
+    for (read = written = 0, pos = 0; pos < count; ++pos) {
+        memcpy(out + written, hay + read, starts[pos] - read);
+        written += starts[pos] - read;
+        memcpy(out + written, new.data, new.len);
+        written += new.len;
+        read = starts[pos] + needle_len;
+    }
+    memcpy(out + written, hay + read, hay_len - read);
+    *out_len = written + hay_len - read;
+    return count;
+}
+
+// 以 hay 为内容，比较预编译模式的查找、统计与替换和参照模型
+static void check_pattern(const DStrPattern *pattern, const char *hay, const size_t hay_len) {
+    static char expected_text[2 * HAY_MAX];
+    static const char *const news[] = {"", "#", "<=>"};
+    const char *needle;
+    DString *dstr;
+    DStrView new;
+    size_t needle_len, found, expected, expected_len, count, n;
+    bool backward;
+
+    needle = dstr_pattern_needle(pattern);
+    needle_len = dstr_pattern_length(pattern);
+    dstr = dstr_create_n(hay, hay_len);
+    CHECK(dstr != NULL);
+
+    expected = naive_first(hay, hay_len, needle, needle_len);
+    CHECK(dstr_find_pattern(dstr, pattern, &found, false) == (expected != NPOS));
+    if (expected != NPOS) CHECK(found == expected);
+    expected = naive_last(hay, hay_len, needle, needle_len);
+    CHECK(dstr_find_pattern(dstr, pattern, &found, true) == (expected != NPOS));
+    if (expected != NPOS) CHECK(found == expected);
+    CHECK(dstr_count_pattern(dstr, pattern) == naive_nth(hay, hay_len, needle, needle_len, 0, false));
+
+    // 替换内容比匹配或短或长，n 为 0 时替换全部
+    new = dstr_view_cstr(news[test_below(3)]);
+    n = test_below(4);
+    backward = test_below(2) == 0;
+    count = naive_replace(hay, hay_len, needle, needle_len, new, n, backward, expected_text, &expected_len);
+    CHECK(dstr_replace_pattern(dstr, pattern, new.data, n, backward) == count);
+    CHECK(dstr_length(dstr) == expected_len && memcmp(dstr_cstr(dstr), expected_text, expected_len) == 0);
+
+    dstr_destroy(dstr);
+}
+
+// 预编译模式：空模式、单字节、短模式过滤与 Horspool 各条路径，同一模式反复用于多个字符串
+static void check_patterns(void) {
+    static char hay[64 * 1024];
+    char needle[300];
+    DStrPattern *pattern;
+    size_t hay_len, needle_len, start;
+
+    test_seed(7);
+    for (int step = 0; step < 3000; ++step) {
+        needle_len = test_below(8) == 0 ? 1 + test_below(sizeof(needle)) : test_below(8);
+        test_fill(needle, needle_len, "ab\0", 3);
+        pattern = dstr_pattern_create_n(needle, needle_len);
+        CHECK(pattern != NULL && dstr_pattern_length(pattern) == needle_len);
+        CHECK(memcmp(dstr_pattern_needle(pattern), needle, needle_len) == 0);
+        // 模式保存的是副本
+        memset(needle, 'z', needle_len);
+
+        for (int round = 0; round < 4; ++round) {
+            hay_len = test_below(8) == 0 ? test_below(sizeof(hay)) : test_below(300);
+            test_fill(hay, hay_len, "ab\0", 3);
+            if (needle_len != 0 && needle_len <= hay_len && test_below(2) == 0) {
+                start = test_below(hay_len - needle_len + 1);
+                memcpy(hay + start, dstr_pattern_needle(pattern), needle_len);
+            }
+            check_pattern(pattern, hay, hay_len);
+        }
+        dstr_pattern_destroy(pattern);
+    }
+
+    // 近似副本拼成的内容使 Horspool 退回到 Two-Way
+    for (int step = 0; step < 40; ++step) {
+        needle_len = 4 + test_below(step % 2 == 0 ? 32 : sizeof(needle) - 4);
+        test_fill(needle, needle_len, "ab", 2);
+        pattern = dstr_pattern_create_n(needle, needle_len);
+        CHECK(pattern != NULL);
+        for (hay_len = 0; hay_len + needle_len <= sizeof(hay); hay_len += needle_len) {
+            memcpy(hay + hay_len, needle, needle_len);
+            hay[hay_len + test_below(needle_len - 1)] ^= 0x40;
+        }
+        check_pattern(pattern, hay, hay_len);
+        start = test_below(hay_len - needle_len + 1);
+        memcpy(hay + start, needle, needle_len);
+        check_pattern(pattern, hay, hay_len);
+        dstr_pattern_destroy(pattern);
+    }
+
+    pattern = dstr_pattern_create("");
+    CHECK(pattern != NULL && dstr_pattern_length(pattern) == 0);
+    check_pattern(pattern, "anything", 8);
+    dstr_pattern_destroy(pattern);
+}
+
+int main(void) {
+    check_random();
+    check_near_misses();
+    check_worst_case();
+    check_patterns();
+    return 0;
+}
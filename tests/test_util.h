@@ -0,0 +1,173 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#ifndef DSTR_TEST_UTIL_H
+#define DSTR_TEST_UTIL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "dstr_allocator.h"
+
+// 测试用的线程：库以 DSTR_NO_THREADS 编译时不能在多个线程中使用，此时与不支持的平台一样依次运行
+#if defined(DSTR_NO_THREADS)
+#  define TEST_HAS_THREADS 0
+#elif defined(_WIN32)
+#  define TEST_THREADS_WIN32 1
+#  define TEST_HAS_THREADS 1
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#  define TEST_THREADS_POSIX 1
+#  define TEST_HAS_THREADS 1
+#  include <pthread.h>
+#else
+#  define TEST_HAS_THREADS 0
+#endif
+
+// 不受 NDEBUG 影响的断言，失败时打印位置并终止
+#define CHECK(cond)                                                                    \
+    do {                                                                               \
+        if (!(cond)) {                                                                 \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);   \
+            abort();                                                                   \
+        }                                                                              \
+    } while (0)
+
+// 可复现的伪随机数（xorshift64*），各测试以固定种子初始化
+static uint64_t test_rng_state = 0x2545f4914f6cdd1dull;
+
+static inline void test_seed(const uint64_t seed) {
+    test_rng_state = seed != 0 ? seed : 0x2545f4914f6cdd1dull;
+}
+
+static inline uint64_t test_rand(void) {
+    test_rng_state ^= test_rng_state >> 12;
+    test_rng_state ^= test_rng_state << 25;
+    test_rng_state ^= test_rng_state >> 27;
+    return test_rng_state * 0x2545f4914f6cdd1dull;
+}
+
+// [0, bound) 内的随机数，bound 为 0 时返回 0
+static inline size_t test_below(const size_t bound) {
+    return bound != 0 ? (size_t) (test_rand() % bound) : 0;
+}
+
+// 用 alphabet 中的字符填充 out[0, len)，字母表较小时便于产生重复与匹配
+static inline void test_fill(char *out, const size_t len, const char *alphabet, const size_t alphabet_len) {
+    for (size_t i = 0; i < len; ++i) out[i] = alphabet[test_below(alphabet_len)];
+}
+
+// 统计用分配器：转交 malloc 系列，记录调用次数与未归还的字节数，
+// fail_after 为剩余的成功次数，耗尽后一律失败以模拟内存不足，SIZE_MAX 表示从不失败
+typedef struct TestAllocStats {
+    size_t allocs;
+    size_t reallocs;
+    size_t frees;
+    size_t live;
+    size_t fail_after;
+} TestAllocStats;
+
+static inline bool test_stats_take(TestAllocStats *stats) {
+    if (stats->fail_after == 0) return false;
+    if (stats->fail_after != SIZE_MAX) --stats->fail_after;
+    return true;
+}
+
+static inline void *test_stats_allocate(void *ctx, const size_t size) {
+    TestAllocStats *stats = ctx;
+    void *ptr;
+
+    if (!test_stats_take(stats) || (ptr = malloc(size)) == NULL) return NULL;
+    ++stats->allocs;
+    stats->live += size;
+    return ptr;
+}
+
+static inline void *test_stats_reallocate(void *ctx, void *ptr, const size_t old_size, const size_t new_size) {
+    TestAllocStats *stats = ctx;
+    void *new_ptr;
+
+    if (!test_stats_take(stats) || (new_ptr = realloc(ptr, new_size)) == NULL) return NULL;
+    ++stats->reallocs;
+    stats->live += new_size - old_size;
+    return new_ptr;
+}
+
+static inline void test_stats_deallocate(void *ctx, void *ptr, const size_t size) {
+    TestAllocStats *stats = ctx;
+
+    if (ptr == NULL) return;
+    ++stats->frees;
+    stats->live -= size;
+    free(ptr);
+}
+
+static inline DStrAllocator test_stats_allocator(TestAllocStats *stats) {
+    *stats = (TestAllocStats){.fail_after = SIZE_MAX};
+    return (DStrAllocator){test_stats_allocate, test_stats_reallocate, test_stats_deallocate, stats};
+}
+
+// 申请与调整的总次数
+static inline size_t test_stats_calls(const TestAllocStats *stats) {
+    return stats->allocs + stats->reallocs;
+}
+
+// 在 count 个线程中并发运行 fn(args[i]) 并等待全部结束，没有线程支持时在调用线程中依次运行
+#define TEST_MAX_THREADS 16
+
+typedef struct TestThreadCall {
+    void (*fn)(void *arg);
+    void *arg;
+} TestThreadCall;
+
+#if defined(TEST_THREADS_WIN32)
+static DWORD WINAPI test_thread_entry(LPVOID call) {
+    ((TestThreadCall *) call)->fn(((TestThreadCall *) call)->arg);
+    return 0;
+}
+#elif defined(TEST_THREADS_POSIX)
+static inline void *test_thread_entry(void *call) {
+    ((TestThreadCall *) call)->fn(((TestThreadCall *) call)->arg);
+    return NULL;
+}
+#endif
+
+static inline void test_run_threads(void (*fn)(void *arg), void *const *args, const size_t count) {
+#if TEST_HAS_THREADS
+    TestThreadCall calls[TEST_MAX_THREADS];
+#endif
+#if defined(TEST_THREADS_WIN32)
+    HANDLE threads[TEST_MAX_THREADS];
+#elif defined(TEST_THREADS_POSIX)
+    pthread_t threads[TEST_MAX_THREADS];
+#endif
+
+    CHECK(count <= TEST_MAX_THREADS);
+    for (size_t i = 0; i < count; ++i) {
+#if defined(TEST_THREADS_WIN32)
+        calls[i] = (TestThreadCall){fn, args[i]};
+        threads[i] = CreateThread(NULL, 0, test_thread_entry, &calls[i], 0, NULL);
+        CHECK(threads[i] != NULL);
+#elif defined(TEST_THREADS_POSIX)
+        calls[i] = (TestThreadCall){fn, args[i]};
+        CHECK(pthread_create(&threads[i], NULL, test_thread_entry, &calls[i]) == 0);
+#else
+        fn(args[i]);
+#endif
+    }
+#if defined(TEST_THREADS_WIN32)
+    for (size_t i = 0; i < count; ++i) {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+#elif defined(TEST_THREADS_POSIX)
+    for (size_t i = 0; i < count; ++i) CHECK(pthread_join(threads[i], NULL) == 0);
+#endif
+}
+
+#endif // DSTR_TEST_UTIL_H
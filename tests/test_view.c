@@ -0,0 +1,208 @@
+//
+// Created by mtueih on 2026/10/16.
+//
+
+#include "dynamic_string.h"
+#include "test_util.h"
+#include <string.h>
+
+#define STRING_COUNT 4
+#define MODEL_MAX 4096
+
+static char models[STRING_COUNT][MODEL_MAX];
+static size_t model_lens[STRING_COUNT];
+
+// 参照模型：非重叠地统计，向前取第一个、向后取最后一个匹配
+static size_t naive_count(const char *hay, const size_t hay_len, const char *sub, const size_t sub_len) {
+    size_t count = 0;
+
+    if (sub_len == 0) return 0;
+    for (size_t i = 0; i + sub_len <= hay_len;) {
+        if (memcmp(hay + i, sub, sub_len) == 0) {
+            ++count;
+            i += sub_len;
+        } else {
+            ++i;
+        }
+    }
+    return count;
+}
+
+static bool naive_find(const char *hay, const size_t hay_len, const char *sub, const size_t sub_len, const bool backward,
+                       size_t *out_index) {
+    bool found = false;
+
+    if (sub_len == 0) return false;
+    for (size_t i = 0; i + sub_len <= hay_len; ++i) {
+        if (memcmp(hay + i, sub, sub_len) == 0) {
+            *out_index = i;
+            found = true;
+            if (!backward) break;
+        }
+    }
+    return found;
+}
+
+// 取子视图的规则：越界得到 data 为 NULL 的空视图，count 为 0 时取到末尾
+static void check_slices(void) {
+    DString *dstr;
+    DStrView view;
+
+    dstr = dstr_create("0123456789");
+    CHECK(dstr != NULL);
+
+    view = dstr_view(dstr);
+    CHECK(view.data == dstr_cstr(dstr) && view.len == 10);
+    view = dstr_view_sub(dstr, 3, 4);
+    CHECK(view.data == dstr_cstr(dstr) + 3 && view.len == 4);
+    view = dstr_view_sub(dstr, 3, 0);
+    CHECK(view.data == dstr_cstr(dstr) + 3 && view.len == 7);
+    view = dstr_view_sub(dstr, 9, 1);
+    CHECK(view.data == dstr_cstr(dstr) + 9 && view.len == 1);
+    view = dstr_view_sub(dstr, 10, 0);
+    CHECK(view.data == NULL && view.len == 0);
+    view = dstr_view_sub(dstr, 5, 6);
+    CHECK(view.data == NULL && view.len == 0);
+    view = dstr_view_sub(dstr, 1, SIZE_MAX);
+    CHECK(view.data == NULL && view.len == 0);
+
+    view = dstr_view_slice(dstr_view_sub(dstr, 2, 6), 1, 3);
+    CHECK(dstr_view_equals(view, dstr_view_cstr("345")));
+    view = dstr_view_slice(dstr_view_sub(dstr, 2, 6), 4, 0);
+    CHECK(dstr_view_equals(view, dstr_view_cstr("67")));
+    view = dstr_view_slice(dstr_view_cstr(""), 0, 0);
+    CHECK(view.data == NULL && view.len == 0);
+
+    // 空视图作为参数时写入返回 false，内容不变
+    CHECK(!dstr_cat_view(dstr, view) && !dstr_cpy_view(dstr, view) && !dstr_insert_view(dstr, view, 0));
+    CHECK(!dstr_insert_view(dstr, dstr_view_cstr("x"), 11));
+    CHECK(dstr_equals_cstr(dstr, "0123456789"));
+
+    dstr_destroy(dstr);
+}
+
+// 随机取源视图（来自任一字符串，包括目标自身，或外部内容），以视图写入、查找与统计，与参照模型比较
+static void check_random(void) {
+    static char scratch[MODEL_MAX], external[64];
+    DString *dstrs[STRING_COUNT], *copy;
+    DStrView src;
+    size_t slot, from, start, len, index, expected_index, actual_index;
+    bool backward;
+
+    for (slot = 0; slot < STRING_COUNT; ++slot) {
+        dstrs[slot] = dstr_create("");
+        CHECK(dstrs[slot] != NULL);
+        model_lens[slot] = 0;
+    }
+
+    test_seed(12);
+    for (int step = 0; step < 100000; ++step) {
+        slot = test_below(STRING_COUNT);
+        from = test_below(STRING_COUNT + 1);
+
+        // 源：某个字符串的一段，或外部缓冲；先保存其内容作为模型
+        if (from < STRING_COUNT && model_lens[from] != 0) {
+            start = test_below(model_lens[from]);
+            len = test_below(model_lens[from] - start + 1);
+            src = dstr_view_sub(dstrs[from], start, len);
+            len = len == 0 ? model_lens[from] - start : len;
+            CHECK(src.data == dstr_cstr(dstrs[from]) + start && src.len == len);
+            memcpy(scratch, models[from] + start, len);
+        } else {
+            len = test_below(test_below(4) == 0 ? sizeof(external) : 6);
+            test_fill(external, len, "ab\0", 3);
+            src = (DStrView){external, len};
+            memcpy(scratch, external, len);
+        }
+
+        switch (test_below(6)) {
+            case 0:
+                if (model_lens[slot] + len >= MODEL_MAX) break;
+                CHECK(dstr_cat_view(dstrs[slot], src) == (len != 0));
+                memcpy(models[slot] + model_lens[slot], scratch, len);
+                model_lens[slot] += len;
+                break;
+            case 1:
+                if (model_lens[slot] + len >= MODEL_MAX) break;
+                index = test_below(model_lens[slot] + 1);
+                CHECK(dstr_insert_view(dstrs[slot], src, index) == (len != 0));
+                memmove(models[slot] + index + len, models[slot] + index, model_lens[slot] - index);
+                memcpy(models[slot] + index, scratch, len);
+                model_lens[slot] += len;
+                break;
+            case 2:
+                CHECK(dstr_cpy_view(dstrs[slot], src) == (len != 0));
+                if (len == 0) break;
+                memcpy(models[slot], scratch, len);
+                model_lens[slot] = len;
+                break;
+            case 3:
+                // 共享缓冲的克隆（写时复制开启时）之间互为源与目标
+                copy = dstr_clone(dstrs[from < STRING_COUNT ? from : slot]);
+                CHECK(copy != NULL);
+                dstr_destroy(dstrs[slot]);
+                dstrs[slot] = copy;
+                from = from < STRING_COUNT ? from : slot;
+                memmove(models[slot], models[from], model_lens[from]);
+                model_lens[slot] = model_lens[from];
+                break;
+            case 4:
+                if (model_lens[slot] == 0) break;
+                index = test_below(model_lens[slot]);
+                dstr_remove(dstrs[slot], index, 0);
+                model_lens[slot] = index;
+                break;
+            default:
+                backward = test_below(2) == 0;
+                CHECK(dstr_count_view(dstrs[slot], src) == naive_count(models[slot], model_lens[slot], scratch, len));
+                expected_index = actual_index = SIZE_MAX;
+                CHECK(dstr_find_view(dstrs[slot], src, &actual_index, backward) ==
+                      naive_find(models[slot], model_lens[slot], scratch, len, backward, &expected_index));
+                CHECK(actual_index == expected_index);
+                expected_index = actual_index = SIZE_MAX;
+                CHECK(dstr_view_find(dstr_view(dstrs[slot]), src, &actual_index, backward) ==
+                      naive_find(models[slot], model_lens[slot], scratch, len, backward, &expected_index));
+                CHECK(actual_index == expected_index);
+                break;
+        }
+
+        CHECK(dstr_length(dstrs[slot]) == model_lens[slot]);
+        CHECK(memcmp(dstr_cstr(dstrs[slot]), models[slot], model_lens[slot]) == 0);
+        CHECK(dstr_cstr(dstrs[slot])[model_lens[slot]] == '\0');
+    }
+
+    for (slot = 0; slot < STRING_COUNT; ++slot) dstr_destroy(dstrs[slot]);
+}
+
+// 插入自身的一段：源跨越插入点、位于插入点之前或之后，以及扩容后旧缓冲失效的情形
+static void check_insert_aliasing(void) {
+    static char model[2 * 100000];
+    DString *dstr;
+    size_t len, half;
+
+    dstr = dstr_create("abcdef");
+    CHECK(dstr != NULL);
+    CHECK(dstr_insert_view(dstr, dstr_view_sub(dstr, 1, 4), 3) && dstr_equals_cstr(dstr, "abcbcdedef"));
+    CHECK(dstr_insert_view(dstr, dstr_view_sub(dstr, 0, 2), 10) && dstr_equals_cstr(dstr, "abcbcdedefab"));
+    CHECK(dstr_insert_view(dstr, dstr_view_sub(dstr, 8, 0), 0) && dstr_equals_cstr(dstr, "efababcbcdedefab"));
+    memcpy(model, "efababcbcdedefab", len = 16);
+    while (len < 100000) {
+        half = len / 2;
+        CHECK(dstr_insert_view(dstr, dstr_view(dstr), half));
+        memmove(model + half + len, model + half, len - half);
+        memmove(model + half, model, half);
+        memmove(model + 2 * half, model + half + len, len - half);
+        len *= 2;
+        CHECK(dstr_length(dstr) == len && memcmp(dstr_cstr(dstr), model, len) == 0);
+    }
+    CHECK(dstr_cpy_view(dstr, dstr_view_sub(dstr, 2, 3)) && dstr_equals_cstr(dstr, "aba"));
+    CHECK(dstr_cpy_view(dstr, dstr_view(dstr)) && dstr_equals_cstr(dstr, "aba"));
+    dstr_destroy(dstr);
+}
+
+int main(void) {
+    check_slices();
+    check_insert_aliasing();
+    check_random();
+    return 0;
+}